@@ -0,0 +1,321 @@
+/*
+ *  testshim - preload library to count allocations and lock waits of the subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file testshim.cpp
+ ** Preload library interposing the heap allocation and mutex functions of the subject.
+ ** Loaded with `LD_PRELOAD`, the definitions given here take precedence over those from the C
+ ** and C++ runtime libraries. The actual work is delegated to the internal entry points of glibc
+ ** (`__libc_malloc` etc.), which avoids the classical recursion through `dlsym()` allocating memory;
+ ** only the mutex functions are looked up with `dlsym(RTLD_NEXT)`. Each call increments the counters
+ ** of the calling thread within the shared memory segment set up by the testrunner; when no segment
+ ** is configured, all functions just pass through. Locking is measured by first trying to acquire
+ ** the mutex without blocking; only if this fails, the time until acquisition is taken.
+ ** The CPU time of each thread is published through a thread-specific key when the thread ends;
+ ** at regular exit of the subject, the threads still running are read through their CPU clock.
+ ** @note `operator new` allocates directly with `__libc_malloc`, so that each allocation
+ **       is counted once; aligned `new` is left to the C++ runtime, which uses `aligned_alloc`.
+ ** @warning this code runs within the subject, possibly in the audio thread: it must never
+ **       allocate memory, block or throw (except `std::bad_alloc` as mandated for `new`).
+ **
+ ** @see util/shimlayout.hpp
+ ** @see suite::step::PreloadShim
+ **
+ */
+
+
+#include "util/shimlayout.hpp"
+
+#include <pthread.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <new>
+
+extern "C" {
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void  __libc_free(void*);
+}
+
+
+namespace {// Implementation details
+
+    using LockFun = int(*)(pthread_mutex_t*);
+
+    shim::Segment* segment = nullptr;
+    LockFun realLock    = nullptr;
+    LockFun realTryLock = nullptr;
+
+    __thread shim::ThreadSlot* slot __attribute__((tls_model("initial-exec"))) = nullptr;
+    pthread_key_t threadEnd;
+    bool hasThreadEnd = false;
+
+
+    inline void add(uint64_t& counter, uint64_t amount)
+    {
+        __atomic_fetch_add(&counter, amount, __ATOMIC_RELAXED);
+    }
+
+    /** thread names are set after start; thus refresh when a count reaches a power of two */
+    inline void maybeRefreshName(shim::ThreadSlot* s, uint64_t count)
+    {
+        if (0 == (count & (count-1)))
+            prctl(PR_GET_NAME, s->name);
+    }
+
+    uint64_t cpuTime(clockid_t clock)
+    {
+        timespec cpu;
+        if (0 != clock_gettime(clock, &cpu))
+            return 0;
+        return uint64_t(cpu.tv_sec) * 1000000000 + uint64_t(cpu.tv_nsec);
+    }
+
+    /** CPU clock of another thread within this process, as constructed by `pthread_getcpuclockid()` */
+    clockid_t threadCpuClock(int32_t tid)
+    {
+        const clockid_t CPUCLOCK_PERTHREAD_SCHED = 4 | 2;
+        return clockid_t(~uint32_t(tid) << 3) | CPUCLOCK_PERTHREAD_SCHED;
+    }
+
+    void publishCpuTime(void* endingSlot)
+    {
+        auto* s = static_cast<shim::ThreadSlot*>(endingSlot);
+        __atomic_store_n(&s->cpu_ns, cpuTime(CLOCK_THREAD_CPUTIME_ID), __ATOMIC_RELAXED);
+    }
+
+    inline shim::ThreadSlot* currentSlot()
+    {
+        if (slot or not segment)
+            return slot;
+        uint32_t idx = __atomic_fetch_add(&segment->threads, 1, __ATOMIC_RELAXED);
+        slot = &segment->slot[idx < shim::MAX_THREADS? idx : shim::MAX_THREADS-1];
+        slot->tid = int32_t(syscall(SYS_gettid));
+        prctl(PR_GET_NAME, slot->name);
+        if (hasThreadEnd and idx < shim::MAX_THREADS)
+            pthread_setspecific(threadEnd, slot);
+        return slot;
+    }
+
+    inline void countAlloc(size_t size)
+    {
+        if (shim::ThreadSlot* s = currentSlot())
+        {
+            add(s->bytes, size);
+            maybeRefreshName(s, __atomic_add_fetch(&s->allocs, 1, __ATOMIC_RELAXED));
+        }
+    }
+
+    inline void countFree(void* mem)
+    {
+        if (mem)
+            if (shim::ThreadSlot* s = currentSlot())
+                add(s->frees, 1);
+    }
+
+    void resolveLocks()
+    {
+        realLock    = reinterpret_cast<LockFun>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realTryLock = reinterpret_cast<LockFun>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+    }
+
+    /** a forked child must not report into the segment of its parent */
+    void detachChild()
+    {
+        segment = nullptr;
+        slot = nullptr;
+    }
+
+    void* allocateNew(size_t size)
+    {
+        for (;;)
+        {
+            if (void* mem = __libc_malloc(size? size : 1))
+            {
+                countAlloc(size);
+                return mem;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (not handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    bool isValidAlignment(size_t alignment)
+    {
+        return alignment and 0 == (alignment & (alignment-1));
+    }
+
+
+    __attribute__((constructor))
+    void attachSegment()
+    {
+        resolveLocks();
+        pthread_atfork(nullptr, nullptr, detachChild);
+        const char* path = getenv(shim::SHIM_SEGMENT_ENV);
+        if (not path) return;
+        int fd = open(path, O_RDWR | O_CLOEXEC);
+        if (fd < 0) return;
+        void* mem = mmap(nullptr, sizeof(shim::Segment), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED) return;
+
+        auto* seg = static_cast<shim::Segment*>(mem);
+        int32_t unclaimed = 0;
+        if (seg->magic != shim::SHIM_MAGIC or seg->version != shim::SHIM_VERSION
+            or not __atomic_compare_exchange_n(&seg->pid, &unclaimed, int32_t(getpid())
+                                              ,false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {// not a valid segment, or already used by another process
+            munmap(mem, sizeof(shim::Segment));
+            return;
+        }
+        hasThreadEnd = (0 == pthread_key_create(&threadEnd, publishCpuTime));
+        segment = seg;
+    }
+
+    /** threads still running at exit never see their thread-specific destructor */
+    __attribute__((destructor))
+    void publishRunningThreads()
+    {
+        if (not segment) return;
+        uint32_t used = __atomic_load_n(&segment->threads, __ATOMIC_ACQUIRE);
+        for (uint32_t i=0; i < used and i < shim::MAX_THREADS; ++i)
+        {
+            shim::ThreadSlot& s = segment->slot[i];
+            if (0 == __atomic_load_n(&s.cpu_ns, __ATOMIC_RELAXED))
+                __atomic_store_n(&s.cpu_ns, cpuTime(threadCpuClock(s.tid)), __ATOMIC_RELAXED);
+        }
+    }
+}//(End)Implementation details
+
+
+
+/* ===== interposed C functions ===== */
+
+extern "C" {
+
+void* malloc(size_t size)
+{
+    void* mem = __libc_malloc(size);
+    if (mem) countAlloc(size);
+    return mem;
+}
+
+void* calloc(size_t cnt, size_t size)
+{
+    void* mem = __libc_calloc(cnt, size);
+    if (mem) countAlloc(cnt*size);
+    return mem;
+}
+
+void* realloc(void* old, size_t size)
+{
+    void* mem = __libc_realloc(old, size);
+    if (mem) countAlloc(size);
+    if (old and (mem or 0 == size)) countFree(old);
+    return mem;
+}
+
+void free(void* mem)
+{
+    countFree(mem);
+    __libc_free(mem);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    void* mem = __libc_memalign(alignment, size);
+    if (mem) countAlloc(size);
+    return mem;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size)
+{
+    if (not isValidAlignment(alignment) or 0 != alignment % sizeof(void*))
+        return EINVAL;
+    void* mem = memalign(alignment, size);
+    if (not mem)
+        return ENOMEM;
+    *result = mem;
+    return 0;
+}
+
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    if (not realLock)
+        resolveLocks();
+    shim::ThreadSlot* s = currentSlot();
+    if (not s)
+        return realLock(mutex);
+
+    add(s->lockCalls, 1);
+    int res = realTryLock(mutex);
+    if (res != EBUSY)
+        return res;
+
+    timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    res = realLock(mutex);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    add(s->contended, 1);
+    add(s->lockWait_ns, uint64_t(end.tv_sec - start.tv_sec) * 1000000000
+                      + uint64_t(end.tv_nsec) - uint64_t(start.tv_nsec));
+    return res;
+}
+
+}//(End)extern "C"
+
+
+
+/* ===== interposed C++ allocation functions ===== */
+
+void* operator new(size_t size)              { return allocateNew(size); }
+void* operator new[](size_t size)            { return allocateNew(size); }
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept
+try { return allocateNew(size); }
+catch(...) { return nullptr; }
+
+void* operator new[](size_t size, std::nothrow_t const&) noexcept
+try { return allocateNew(size); }
+catch(...) { return nullptr; }
+
+void operator delete(void* mem) noexcept                          { free(mem); }
+void operator delete[](void* mem) noexcept                        { free(mem); }
+void operator delete(void* mem, size_t) noexcept                  { free(mem); }
+void operator delete[](void* mem, size_t) noexcept                { free(mem); }
+void operator delete(void* mem, std::nothrow_t const&) noexcept   { free(mem); }
+void operator delete[](void* mem, std::nothrow_t const&) noexcept { free(mem); }
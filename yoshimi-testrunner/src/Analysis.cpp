@@ -0,0 +1,755 @@
+/*
+ *  Analysis - offline queries over the stored timing histories
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Analysis.cpp
+ ** Implementation of the offline queries over stored timing histories.
+ ** The runtime and expense tables of all test cases are located by scanning the Testsuite
+ ** tree for `*-runtime.csv` and are loaded by a pool of threads. Each query considers only
+ ** the rows within the _analysis window_ which are not contaminated by system disturbance
+ ** and were taken with a build profile comparable to the newest measurement.
+ ** Available queries:
+ ** - `regressions`: test cases sorted by the change of their (platform normalised) expense
+ **   factor between the start and the end of the window; the top-N slowest first.
+ ** - `topics`: per topic subtree, the current relative Δ against the baseline, the change
+ **   over the window, and the number of cases outside the tolerance band.
+ ** - `refit`: fit the platform model anew with the stored data and alternative settings,
+ **   and compare with the platform model in use.
+ ** - `tolerance`: what-if evaluation of the tolerance band: count the measurements within the
+ **   window which would have been judged as warning or failure with a tolerance scaled by `factor`.
+ ** - `redundancy`: cluster test cases with near-identical sound and timing behaviour, based on
+ **   a fingerprint of the baseline sound (spectral envelope and RMS profile), the expense factor
+ **   and the correlation of the run-to-run fluctuations; the cheapest case of each cluster is kept.
+ ** Arguments: `since=<ISO date>|<N>d`, `runs=<N>` (window), `top=<N>`, `avg=<N>` (points to
+ ** average, default `baselineAvg`), `contamination=<limit>` and `factor=<F>`; for `redundancy`
+ ** the similarity thresholds `sound=<dB>`, `expense=<rel>`, `corr=<min>` and `minruns=<N>`.
+ ** @remark the jitter scaling of tolerances is not reconstructed for past measurements.
+ **
+ */
+
+
+#include "Analysis.hpp"
+#include "util/csv.hpp"
+#include "util/error.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/regex.hpp"
+#include "util/sound.hpp"
+#include "util/statistic.hpp"
+#include "suite/BuildInfo.hpp"
+#include "suite/TimingTables.hpp"
+#include "suite/step/TimingJudgement.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <numeric>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+#include <mutex>
+#include <ctime>
+#include <map>
+
+using std::string;
+using std::vector;
+using util::isnil;
+using util::formatVal;
+using util::endsWith;
+using suite::ResCode;
+using suite::BuildInfo;
+using suite::RuntimeData;
+using suite::ExpenseData;
+using suite::PlatformData;
+using suite::step::judgeDelta;
+using suite::step::combinedTolerance;
+
+
+namespace {// Implementation details
+
+    const size_t MILLISEC_per_NANOSEC = 1000*1000;
+    const size_t DEFAULT_TOP = 10;
+
+    using VecD = vector<double>;
+
+
+    /** analysis query `<name>[:<arg>=<val>,...]` */
+    struct Query
+    {
+        string name;
+        std::map<string,string> args;
+
+        Query(string spec)
+        {
+            size_t pos = spec.find(':');
+            name = util::trimmed(spec.substr(0, pos));
+            std::istringstream argList{pos == string::npos? "" : spec.substr(pos+1)};
+            for (string arg; std::getline(argList, arg, ','); )
+            {
+                size_t eq = arg.find('=');
+                if (eq == string::npos)
+                    throw error::Misconfig("Analysis argument "+formatVal(arg)+" not of the form <arg>=<val>");
+                args[util::trimmed(arg.substr(0,eq))] = util::trimmed(arg.substr(eq+1));
+            }
+        }
+
+        template<typename VAL>
+        VAL get(string key, VAL deflt)  const
+        {
+            auto pos = args.find(key);
+            return pos == args.end()? deflt
+                                    : util::parseAs<VAL>(pos->second);
+        }
+    };
+
+
+    /** selection of rows to consider in each time series */
+    struct Window
+    {
+        string since;              ///< earliest timestamp (ISO, compared textually)
+        size_t runs;               ///< maximum number of newest rows
+        double contaminationLimit;
+
+        Window(Query const& query, Config const& config)
+            : since{query.get<string>("since", "")}
+            , runs{query.get<size_t>("runs", std::numeric_limits<size_t>::max())}
+            , contaminationLimit{query.get<double>("contamination", config.contaminationLimit)}
+        {
+            if (endsWith(since, "d"))
+            {// relative: number of days back from today
+                using namespace std::chrono;
+                auto days = util::parseAs<uint>(since.substr(0, since.length()-1));
+                time_t start{system_clock::to_time_t(system_clock::now() - hours(24*days))};
+                std::ostringstream oss;
+                oss << std::put_time(localtime(&start), "%F");
+                since = oss.str();
+            }
+        }
+
+        string describe()  const
+        {
+            string spec = isnil(since)? "all runs" : "since "+since;
+            if (runs < std::numeric_limits<size_t>::max())
+                spec += ", last "+formatVal(runs)+" runs";
+            return spec;
+        }
+    };
+
+
+    /** stored timing data of a single test case */
+    struct History
+        : util::NonCopyable
+    {
+        fs::path topic;            ///< test case path relative to the Testsuite root
+        RuntimeData runtime;
+        ExpenseData expense;
+
+        History(fs::path topicPath, fs::path fileRuntime, fs::path fileExpense)
+            : topic{topicPath}
+            , runtime{fileRuntime}
+            , expense{fileExpense}
+        { }
+
+        /** @return indices of the rows within the window, oldest first */
+        vector<size_t> select(Window const& window)  const
+        {
+            vector<size_t> rows;
+            if (runtime.empty()) return rows;
+            string current = runtime.profile;
+            size_t oldest = runtime.size() - std::min(window.runs, runtime.size());
+            for (size_t i=oldest; i < runtime.size(); ++i)
+                if (window.since <= runtime.timestamp.data[i]
+                    and runtime.contamination.data[i] <= window.contaminationLimit
+                    and BuildInfo::isComparable(current, runtime.profile.data[i]))
+                    rows.push_back(i);
+            return rows;
+        }
+
+        VecD series(vector<double> const& column, vector<size_t> const& rows)  const
+        {
+            VecD values;
+            values.reserve(rows.size());
+            for (size_t i : rows)
+                values.push_back(column[i]);
+            return values;
+        }
+    };
+
+    using Histories = vector<std::unique_ptr<History>>;
+
+
+    /** invoke the function for each index 0..cnt-1, distributed to a pool of threads */
+    template<class FUN>
+    void forEachParallel(size_t cnt, FUN perform)
+    {
+        std::atomic<size_t> next{0};
+        auto work = [&]{
+                         for (size_t i; (i = next++) < cnt; )
+                             perform(i);
+                       };
+        size_t threads = std::min<size_t>(cnt, std::max(1u, std::thread::hardware_concurrency()));
+        vector<std::thread> pool;
+        for (size_t t=0; t < threads; ++t)
+            pool.emplace_back(work);
+        for (auto& thread : pool)
+            thread.join();
+    }
+
+
+    /** locate all timing tables below the root and load them in parallel */
+    Histories loadHistories(fs::path root, util::Matcher const& filter, vector<string>& failures)
+    {
+        const string RUNTIME_SUFFIX = "-"+def::TIMING_RUNTIME_MARK+def::EXT_DATA_CSV;
+        const string EXPENSE_SUFFIX = "-"+def::TIMING_EXPENSE_MARK+def::EXT_DATA_CSV;
+
+        vector<fs::path> files;
+        for (auto& entry : fs::recursive_directory_iterator(root))
+            if (entry.is_regular_file() and endsWith(entry.path().filename().string(), RUNTIME_SUFFIX))
+                files.push_back(entry.path());
+
+        Histories histories(files.size());
+        std::mutex lock;
+        forEachParallel(files.size()
+                       ,[&](size_t i)
+                            {
+                                string name = files[i].filename().string();
+                                string testID = name.substr(0, name.length() - RUNTIME_SUFFIX.length());
+                                fs::path topic = fs::relative(files[i].parent_path(), root) / (testID+def::TESTSPEC_FILE_EXTENSION);
+                                if (not filter.matchesWithin(topic.string()))
+                                    return;
+                                try {
+                                    histories[i].reset(new History{topic, files[i]
+                                                                  ,files[i].parent_path() / (testID+EXPENSE_SUFFIX)});
+                                }
+                                catch(std::exception& ex)
+                                {
+                                    std::lock_guard<std::mutex> guard{lock};
+                                    failures.push_back(topic.string()+": "+ex.what());
+                            }   });
+
+        histories.erase(std::remove(histories.begin(), histories.end(), nullptr), histories.end());
+        std::sort(histories.begin(), histories.end()
+                 ,[](auto const& h1, auto const& h2){ return h1->topic < h2->topic; });
+        return histories;
+    }
+
+
+    /**
+     * Result of a query: the first column is the key (text),
+     * all further columns hold numbers.
+     */
+    struct Table
+    {
+        vector<string> header;
+        vector<vector<string>> rows{};
+
+        void print(std::ostream& out)  const
+        {
+            vector<size_t> width;
+            for (auto& col : header)
+                width.push_back(col.length());
+            for (auto& row : rows)
+                for (size_t c=0; c < row.size(); ++c)
+                    width[c] = std::max(width[c], row[c].length());
+            auto printRow = [&](vector<string> const& row)
+                                {
+                                    for (size_t c=0; c < row.size(); ++c)
+                                        out << (0==c? std::left : std::right)
+                                            << std::setw(int(width[c])) << row[c]
+                                            << (c+1 < row.size()? "  ":"\n");
+                                };
+            printRow(header);
+            for (auto& row : rows)
+                printRow(row);
+        }
+
+        void saveCSV(fs::path target)  const
+        {
+            std::ofstream csvFile{target, std::ios_base::out | std::ios_base::trunc};
+            if (not csvFile.good())
+                throw error::State("Unable to create CSV output file "+formatVal(target));
+            string line;
+            for (auto& col : header)
+                util::appendCsvField(line, col);
+            csvFile << line << "\n";
+            for (auto& row : rows)
+            {
+                line.clear();
+                util::appendCsvField(line, row[0]);
+                for (size_t c=1; c < row.size(); ++c)
+                    line += ","+row[c];
+                csvFile << line << "\n";
+            }
+        }
+    };
+
+    string percent(double relVal)
+    {
+        return formatVal(std::round(relVal * 1000) / 10);
+    }
+
+    double averageOf(VecD::const_iterator begin, VecD::const_iterator end)
+    {
+        return begin == end? 0.0 : std::accumulate(begin, end, 0.0) / (end - begin);
+    }
+
+    /** @return relative change between the average of the first and of the last points */
+    double relativeChange(VecD const& series, size_t avgPoints)
+    {
+        size_t n = std::max<size_t>(1, std::min(avgPoints, series.size()/2));
+        double before = averageOf(series.begin(), series.begin()+n);
+        double after  = averageOf(series.end()-n, series.end());
+        return 0.0 < before? after/before - 1 : 0.0;
+    }
+
+    /** @return model tolerance ~ 3·σ, as used for the timing judgement */
+    double modelTolerance(PlatformData const& platform)
+    {
+        return platform.empty()? 0.0 : 3 * platform.sdevDelta;
+    }
+
+
+
+    /* ===== Queries ===== */
+
+    Table queryRegressions(Histories const& histories, PlatformData const&, Query const& query, Config const& config)
+    {
+        Window window{query, config};
+        size_t top = query.get<size_t>("top", DEFAULT_TOP);
+        uint avg = query.get<uint>("avg", config.baselineAvg);
+
+        struct Finding { History const* test; size_t points; double before, after, change, trend; };
+        vector<Finding> findings;
+        for (auto& test : histories)
+        {
+            VecD series = test->series(test->runtime.expenseCurr.data, test->select(window));
+            if (series.size() < 2) continue;
+            size_t n = std::max<size_t>(1, std::min<size_t>(avg, series.size()/2));
+            double before = averageOf(series.begin(), series.begin()+n);
+            double after  = averageOf(series.end()-n, series.end());
+            if (before <= 0.0) continue;
+            double gradient, correlation;
+            std::tie(std::ignore, gradient, correlation) = util::computeTimeSeriesLinearRegression(series);
+            findings.push_back(Finding{test.get(), series.size()
+                                      ,before, after
+                                      ,after/before - 1
+                                      ,gradient * series.size() * fabs(correlation) / before});
+        }
+        std::sort(findings.begin(), findings.end()
+                 ,[](Finding const& f1, Finding const& f2){ return f1.change > f2.change; });
+        if (top < findings.size())
+            findings.resize(top);
+
+        Table table{{"Topic","Points","Expense(before)","Expense(after)","Change %","Trend %"}};
+        for (auto& f : findings)
+            table.rows.push_back({f.test->topic.string(), formatVal(f.points)
+                                 ,formatVal(f.before), formatVal(f.after)
+                                 ,percent(f.change), percent(f.trend)});
+        return table;
+    }
+
+
+    Table queryTopics(Histories const& histories, PlatformData const& platform, Query const& query, Config const& config)
+    {
+        Window window{query, config};
+        uint avg = query.get<uint>("avg", config.baselineAvg);
+        double modelTol = modelTolerance(platform);
+
+        struct Aggregate { size_t cases{0}; double sumDelta{0}, maxDelta{0}, sumChange{0}; size_t flagged{0}; };
+        std::map<string, Aggregate> groups;
+        for (auto& test : histories)
+        {
+            auto rows = test->select(window);
+            if (rows.empty()) continue;
+            auto& r = test->runtime;
+            size_t last = rows.back();
+            double expected = r.platform.data[last] * r.expense.data[last];
+            if (expected <= 0.0) continue;  // no baseline yet
+            double relDelta = r.delta.data[last] / expected;
+            double tolerance = combinedTolerance(r.tolerance.data[last], modelTol, r.expense.data[last]);
+            bool flagged = ResCode::GREEN != judgeDelta(r.delta.data[last], tolerance);
+            double change = relativeChange(test->series(r.expenseCurr.data, rows), avg);
+            for (fs::path dir = test->topic.parent_path(); not dir.empty(); dir = dir.parent_path())
+            {
+                Aggregate& group = groups[dir.string()+"/"];
+                ++group.cases;
+                group.sumDelta += relDelta;
+                group.maxDelta = std::max(group.maxDelta, fabs(relDelta));
+                group.sumChange += change;
+                group.flagged += flagged;
+            }
+        }
+        Table table{{"Topic","Cases","Avg Δ %","Max Δ %","Change %","Flagged"}};
+        for (auto& [topic, group] : groups)
+            table.rows.push_back({topic, formatVal(group.cases)
+                                 ,percent(group.sumDelta / group.cases)
+                                 ,percent(group.maxDelta)
+                                 ,percent(group.sumChange / group.cases)
+                                 ,formatVal(group.flagged)});
+        return table;
+    }
+
+
+    /** @remark preprocessing as for the calibration: runtime averaged and normalised with the expense factor */
+    Table queryRefit(Histories const& histories, PlatformData const& platform, Query const& query, Config const& config)
+    {
+        Window window{query, config};
+        uint avg = query.get<uint>("avg", config.baselineAvg);
+
+        util::RegressionData points;
+        for (auto& test : histories)
+        {
+            auto rows = test->select(window);
+            if (rows.empty() or test->expense.empty() or test->expense.expense <= 0.0) continue;
+            VecD runtimes = test->series(test->runtime.runtime.data, rows);
+            double expense = test->expense.expense;
+            double runtime = util::averageLastN(runtimes, avg);
+            points.push_back(util::RegressionPoint{double(test->runtime.samples.data[rows.back()])
+                                                  ,runtime / expense
+                                                  ,expense});
+        }
+        if (points.size() < 2)
+            throw error::State("Analysis 'refit': less than two test cases with baseline and data in the window.");
+        auto [socket, speed
+             ,predictedPoints
+             ,predictionDeltas
+             ,correlation
+             ,maxDelta
+             ,sdevDelta]  = util::computeLinearRegression(points);
+        speed *= MILLISEC_per_NANOSEC;  // regression based on timings in ms
+
+        Table table{{"Parameter","Current","Refit","Change %"}};
+        auto addRow = [&](string param, double current, double refit)
+                        {
+                            table.rows.push_back({param
+                                                 ,platform.empty()? "0" : formatVal(current)
+                                                 ,formatVal(refit)
+                                                 ,platform.empty() or current == 0.0? "0"
+                                                                                    : percent(refit/current - 1)});
+                        };
+        addRow("Data points",  platform.empty()? 0.0 : double(platform.points), double(points.size()));
+        addRow("Socket ms",    platform.empty()? 0.0 : double(platform.socket),      socket);
+        addRow("Speed ns/smp", platform.empty()? 0.0 : double(platform.speed),       speed);
+        addRow("Correlation",  platform.empty()? 0.0 : double(platform.correlation), correlation);
+        addRow("Delta (max)",  platform.empty()? 0.0 : double(platform.maxDelta),    maxDelta);
+        addRow("Delta (sdev)", platform.empty()? 0.0 : double(platform.sdevDelta),   sdevDelta);
+        return table;
+    }
+
+
+    Table queryTolerance(Histories const& histories, PlatformData const& platform, Query const& query, Config const& config)
+    {
+        Window window{query, config};
+        size_t top = query.get<size_t>("top", DEFAULT_TOP);
+        double factor = query.get<double>("factor", 1.0);
+        double modelTol = modelTolerance(platform);
+
+        struct Count { string topic; size_t points{0}, warn{0}, fail{0}, warnAlt{0}, failAlt{0}; };
+        vector<Count> counts;
+        Count total{"(total)"};
+        for (auto& test : histories)
+        {
+            auto& r = test->runtime;
+            Count cnt{test->topic.string()};
+            for (size_t i : test->select(window))
+            {
+                if (r.expense.data[i] <= 0.0 or r.tolerance.data[i] <= 0.0) continue;
+                double tolerance = combinedTolerance(r.tolerance.data[i], modelTol, r.expense.data[i]);
+                ResCode current = judgeDelta(r.delta.data[i], tolerance);
+                ResCode whatIf  = judgeDelta(r.delta.data[i], tolerance * factor);
+                ++cnt.points;
+                cnt.warn    += ResCode::WARNING   == current;
+                cnt.fail    += ResCode::VIOLATION == current;
+                cnt.warnAlt += ResCode::WARNING   == whatIf;
+                cnt.failAlt += ResCode::VIOLATION == whatIf;
+            }
+            total.points += cnt.points;
+            total.warn += cnt.warn;       total.fail += cnt.fail;
+            total.warnAlt += cnt.warnAlt; total.failAlt += cnt.failAlt;
+            if (cnt.warn + cnt.fail + cnt.warnAlt + cnt.failAlt)
+                counts.push_back(cnt);
+        }
+        std::sort(counts.begin(), counts.end()
+                 ,[](Count const& c1, Count const& c2){ return std::tie(c1.failAlt, c1.warnAlt)
+                                                             > std::tie(c2.failAlt, c2.warnAlt); });
+        if (top < counts.size())
+            counts.resize(top);
+        counts.push_back(total);
+
+        string alt = "(×"+formatVal(factor)+")";
+        Table table{{"Topic","Points","Warn","Fail","Warn"+alt,"Fail"+alt}};
+        for (auto& c : counts)
+            table.rows.push_back({c.topic, formatVal(c.points)
+                                 ,formatVal(c.warn), formatVal(c.fail)
+                                 ,formatVal(c.warnAlt), formatVal(c.failAlt)});
+        return table;
+    }
+
+
+    /** fingerprint of a test case: sound characteristics and timing behaviour */
+    struct Fingerprint
+    {
+        fs::path topic;
+        std::optional<util::SoundFingerprint> sound;
+        string engine;
+        double expense{0.0};                ///< average platform normalised expense within the window
+        double runtime{0.0};                ///< average runtime (ms) within the window
+        std::map<string,double> residual;   ///< log expense per run, relative to the average of that run
+
+        bool isTimed()  const { return 0.0 < expense; }
+    };
+
+    /** @return correlation over the runs common to both series, and the number of these runs */
+    std::pair<double,size_t> correlate(std::map<string,double> const& s1, std::map<string,double> const& s2)
+    {
+        VecD x, y;
+        for (auto& [run,val] : s1)
+        {
+            auto other = s2.find(run);
+            if (other == s2.end()) continue;
+            x.push_back(val);
+            y.push_back(other->second);
+        }
+        if (x.size() < 2)
+            return {0.0, x.size()};
+        double mx = util::average(x), my = util::average(y);
+        double sxy = 0, sxx = 0, syy = 0;
+        for (size_t i=0; i < x.size(); ++i)
+        {
+            sxy += (x[i]-mx) * (y[i]-my);
+            sxx += (x[i]-mx) * (x[i]-mx);
+            syy += (y[i]-my) * (y[i]-my);
+        }
+        return {0.0 < sxx and 0.0 < syy? sxy / sqrt(sxx*syy) : 0.0, x.size()};
+    }
+
+    /** locate the baseline sounds below the root and compute their fingerprints in parallel */
+    std::map<fs::path, util::SoundFingerprint> fingerprintSounds(fs::path root, util::Matcher const& filter
+                                                                ,vector<string>& failures)
+    {
+        const string BASELINE_MARK = "-"+def::SOUND_BASELINE_MARK;
+        vector<std::pair<fs::path,fs::path>> files;
+        for (auto& entry : fs::recursive_directory_iterator(root))
+        {
+            fs::path file = entry.path();
+            string stem = file.stem().string();
+            if (not entry.is_regular_file() or not util::hasExtSound(file) or not endsWith(stem, BASELINE_MARK))
+                continue;
+            string testID = stem.substr(0, stem.length() - BASELINE_MARK.length());
+            fs::path topic = fs::relative(file.parent_path(), root) / (testID+def::TESTSPEC_FILE_EXTENSION);
+            if (filter.matchesWithin(topic.string()))
+                files.emplace_back(topic, file);
+        }
+        vector<std::optional<util::SoundFingerprint>> fingerprints(files.size());
+        std::mutex lock;
+        forEachParallel(files.size()
+                       ,[&](size_t i)
+                            {
+                                try {
+                                    fingerprints[i] = util::takeFingerprint(files[i].second);
+                                }
+                                catch(std::exception& ex)
+                                {
+                                    std::lock_guard<std::mutex> guard{lock};
+                                    failures.push_back(files[i].first.string()+": "+ex.what());
+                            }   });
+        std::map<fs::path, util::SoundFingerprint> sounds;
+        for (size_t i=0; i < files.size(); ++i)
+            if (fingerprints[i])
+                sounds.emplace(files[i].first, std::move(*fingerprints[i]));
+        return sounds;
+    }
+
+
+    /**
+     * Cluster near-duplicate test cases, based on sound and timing fingerprints.
+     * Cases are considered in order of increasing runtime, and each case joins the cluster of the
+     * first (and thus cheapest) case it resembles; cluster members are compared to this leader
+     * only, to avoid chaining. Cases resemble each other when all fingerprints available on both
+     * sides are similar, and at least the sound or a sufficient timing history could be compared.
+     */
+    Table queryRedundancy(Histories const& histories, PlatformData const&, Query const& query, Config const& config)
+    {
+        Window window{query, config};
+        double soundTol   = query.get<double>("sound", 3.0);       // dB RMS difference of envelope / profile
+        double expenseTol = query.get<double>("expense", 0.1);     // relative difference of expense
+        double minCorr    = query.get<double>("corr", 0.5);        // correlation of run-to-run fluctuations
+        size_t minRuns    = query.get<size_t>("minruns", 10);      // common runs to compare fluctuations
+
+        fs::path root = fs::consolidated(config.suitePath);
+        vector<string> failures;
+        auto sounds = fingerprintSounds(root, util::Matcher{config.filter}, failures);
+        for (auto& failure : failures)
+            config.progress->err("Analysis: unable to fingerprint "+failure);
+
+        std::map<fs::path, Fingerprint> cases;
+        for (auto& [topic, sound] : sounds)
+            cases[topic].sound = sound;
+        std::map<string, VecD> runs;   // log expense of all cases per run
+        for (auto& test : histories)
+        {
+            auto rows = test->select(window);
+            auto& r = test->runtime;
+            Fingerprint& fp = cases[test->topic];
+            fp.engine = r.empty()? "" : string{r.engine};
+            VecD expense, runtime;
+            for (size_t i : rows)
+                if (0.0 < r.expenseCurr.data[i])
+                {
+                    expense.push_back(r.expenseCurr.data[i]);
+                    runtime.push_back(r.runtime.data[i]);
+                    fp.residual[r.timestamp.data[i]] = log(r.expenseCurr.data[i]);
+                    runs[r.timestamp.data[i]].push_back(log(r.expenseCurr.data[i]));
+                }
+            fp.expense = util::average(expense);
+            fp.runtime = util::average(runtime);
+        }
+        for (auto& [topic, fp] : cases)
+        {
+            fp.topic = topic;
+            for (auto& [run, val] : fp.residual)
+                val -= util::average(runs[run]);   // factor out the fluctuation common to the whole run
+        }
+
+        vector<Fingerprint*> order;
+        for (auto& [topic, fp] : cases)
+            if (fp.sound or fp.isTimed())
+                order.push_back(&fp);
+        std::stable_sort(order.begin(), order.end()
+                        ,[](Fingerprint* f1, Fingerprint* f2){ return f1->runtime < f2->runtime; });
+
+        struct Member { Fingerprint const* fp; string sound{}, expense{}, corr{}; };
+        vector<vector<Member>> clusters;
+        for (Fingerprint* fp : order)
+        {
+            bool joined = false;
+            for (auto& cluster : clusters)
+            {
+                Fingerprint const& leader = *cluster.front().fp;
+                if (not isnil(fp->engine) and not isnil(leader.engine) and fp->engine != leader.engine)
+                    continue;
+                bool compared = false;
+                Member member{fp};
+                if (fp->sound and leader.sound)
+                {
+                    double dist = fp->sound->distance(*leader.sound);
+                    if (soundTol < dist) continue;
+                    member.sound = formatVal(std::round(dist*10)/10);
+                    compared = true;
+                }
+                if (fp->isTimed() and leader.isTimed())
+                {
+                    double change = fp->expense / leader.expense - 1;
+                    if (expenseTol < fabs(change)) continue;
+                    member.expense = percent(change);
+                    auto [corr, common] = correlate(fp->residual, leader.residual);
+                    if (minRuns <= common)
+                    {
+                        if (corr < minCorr) continue;
+                        member.corr = formatVal(std::round(corr*100)/100);
+                        compared = true;
+                    }
+                }
+                if (not compared) continue;
+                cluster.push_back(member);
+                joined = true;
+                break;
+            }
+            if (not joined)
+                clusters.push_back({Member{fp}});
+        }
+
+        Table table{{"Topic","Cluster","Redundant","Sound dB","Expense %","Correlation","Runtime ms"}};
+        size_t clusterCnt = 0, redundant = 0;
+        double saved = 0.0;
+        for (auto& cluster : clusters)
+        {
+            if (cluster.size() < 2) continue;
+            ++clusterCnt;
+            for (size_t m=0; m < cluster.size(); ++m)
+            {
+                Member const& member = cluster[m];
+                table.rows.push_back({member.fp->topic.string(), formatVal(clusterCnt), formatVal(0<m? 1:0)
+                                     ,member.sound, member.expense, member.corr
+                                     ,formatVal(std::round(member.fp->runtime*10)/10)});
+                if (0 < m)
+                {
+                    ++redundant;
+                    saved += member.fp->runtime;
+                }
+            }
+        }
+        table.rows.push_back({"(total)", formatVal(clusterCnt), formatVal(redundant), "", "", ""
+                             ,formatVal(std::round(saved*10)/10)});
+        return table;
+    }
+
+
+    using QueryFun = Table(Histories const&, PlatformData const&, Query const&, Config const&);
+
+    const std::map<string, QueryFun*> QUERIES =
+        {{"regressions", &queryRegressions}
+        ,{"topics",      &queryTopics}
+        ,{"refit",       &queryRefit}
+        ,{"tolerance",   &queryTolerance}
+        ,{"redundancy",  &queryRedundancy}
+        };
+
+}//(End)Implementation details
+
+
+
+Analysis::Analysis(Config const& config)
+    : config_{config}
+{ }
+
+
+suite::ResCode Analysis::perform()
+{
+    Query query{config_.analyze};
+    auto queryFun = QUERIES.find(query.name);
+    if (queryFun == QUERIES.end())
+        throw error::Misconfig("Unknown analysis query "+formatVal(query.name)
+                              +"; expecting 'regressions', 'topics', 'refit', 'tolerance' or 'redundancy'.");
+
+    fs::path root = fs::consolidated(config_.suitePath);
+    vector<string> failures;
+    Histories histories = loadHistories(root, util::Matcher{config_.filter}, failures);
+    PlatformData platform{root / (def::TIMING_SUITE_PLATFORM + def::EXT_DATA_CSV)};
+    for (auto& failure : failures)
+        config_.progress->err("Analysis: unable to load "+failure);
+    config_.progress->note("Analysis: "+query.name+" over "+formatVal(histories.size())+" test cases ("
+                          +Window{query, config_}.describe()+")");
+
+    Table result = (*queryFun->second)(histories, platform, query, config_);
+    if (isnil(config_.report))
+        result.print(std::cout);
+    else
+    {
+        result.saveCSV(config_.report);
+        config_.progress->note("Analysis: "+formatVal(result.rows.size())+" rows written to "+config_.report.string());
+    }
+    return isnil(failures)? ResCode::GREEN : ResCode::WARNING;
+}
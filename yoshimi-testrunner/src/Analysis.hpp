@@ -0,0 +1,60 @@
+/*
+ *  Analysis - offline queries over the stored timing histories
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Analysis.hpp
+ ** Analysis mode of the Yoshimi-Testrunner: evaluate stored performance histories.
+ ** When launched with `--analyze=<query>`, the testrunner does not build a Testsuite and
+ ** does not invoke Yoshimi; rather it loads the timing tables of all test cases within
+ ** the Testsuite tree (as selected by the filter arguments) together with the platform
+ ** model, and answers the query by printing a table, or writing it as CSV to the file
+ ** given with `--report`. A query is given as `<name>[:<arg>=<val>,...]`, e.g.
+ ** `--analyze=regressions:since=90d,top=10`; see Analysis.cpp for the queries and arguments.
+ **
+ ** @see TimingTables.hpp
+ ** @see Main.cpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_ANALYSIS_HPP_
+#define TESTRUNNER_ANALYSIS_HPP_
+
+
+#include "Config.hpp"
+#include "util/nocopy.hpp"
+#include "suite/Result.hpp"
+
+
+/**
+ * Perform a query over the stored timing histories of the Testsuite.
+ */
+class Analysis
+    : util::NonCopyable
+{
+    Config const& config_;
+
+public:
+    Analysis(Config const& config);
+
+    /** load the histories, evaluate the query and emit the resulting table */
+    suite::ResCode perform();
+};
+
+#endif /*TESTRUNNER_ANALYSIS_HPP_*/
@@ -102,6 +102,15 @@ const argp_option OPTIONS[] =
     ,{"strict",     13,  nullptr, 0, "strict sound verification with low error tolerance", 2}
     ,{"report",     14,  "<file>",0, "save test report into the given file", 3}
     ,{"arguments",  15,  "<args>",0, "arguments to pass to the subject", 3}
+    ,{"coordinator",16,  "<addr>",0, "distribute test cases to workers connecting at unix:<path> or <host>:<port>", 4}
+    ,{"worker",     17,  "<addr>",0, "act as worker: connect to the coordinator and run the cases handed out", 4}
+    ,{"audit",      19,  nullptr, 0, "audit page faults, context switches and syscalls of the rendering thread in timed tests", 2}
+    ,{"instrument", 23,  nullptr, 0, "count allocations and mutex waits of the subject in timed tests, through a preload library", 2}
+    ,{"sandbox",    24,  nullptr, 0, "launch the subject with a private HOME and XDG directories on tmpfs, reset for each launch", 3}
+    ,{"cache",      21,  "<mode>",0, "page cache for timed tests: plain, warm (discarded warm-up run) or cold (evict subject files)", 2}
+    ,{"profile",    22,  "<exe>", 0, "profile timed tests interleaved with this reference build, and report per-function differences", 2}
+    ,{"analyze",    20,  "<query>",0, "evaluate the stored timing histories instead of running the tests, e.g. regressions:since=90d,top=10", 4}
+    ,{"no-memo",    18,  nullptr, 0, "render all sound verification cases, even when inputs are unchanged since the last green run", 1}
     ,{ nullptr }
     };
 
@@ -128,6 +137,10 @@ error_t handleOption (int key, char *arg, argp_state *state)
             settings[Config::KEY_filter] += "|(?:"+string{arg}+")";
         break;
 
+    case 18:            // negated flag: maps onto the setting "memo"
+        settings.insert({Config::KEY_memo, "false"});
+        break;
+
     case ARGP_KEY_END:
         /* parsing complete; could do consistency checks here */
         break;
@@ -66,7 +66,13 @@ namespace def {
 
     const string TYPE_CLI = "CLI";
     const string TYPE_LV2 = "LV2";
+    const string TYPE_LOAD= "LOAD";
+    const string TYPE_SCENE="SCENE";
+    const string TYPE_BENCH="BENCH";
+    const string TYPE_PARETO="PARETO";
+    const string PRELUDE  = "PRELUDE";
     const string CLOSURE  = "CLOSURE";
+    const string WORKER   = "WORKER";
 
     const string KEY_Test_type    = "Test.type";
     const string KEY_Test_topic   = "Test.topic";
@@ -76,31 +82,68 @@ namespace def {
     const string KEY_Test_addArgs = "Test.addArguments";
     const string KEY_verifySound  = "Test.verifySound";
     const string KEY_verifyTimes  = "Test.verifyTimes";
+    const string KEY_verifyLatency= "Test.verifyLatency";
     const string KEY_cliTimeout   = "Test.cliTimeout";
     const string KEY_warnLevel    = "Test.warnLevel";
+    const string KEY_failPattern  = "Test.failPattern";
+    const string KEY_Load_corpus  = "Test.corpus";
+    const string KEY_Load_repeat  = "Test.loadRepetitions";
+    const string KEY_Load_parts   = "Test.loadParts";
+    const string KEY_Scene_state  = "Test.scene";
+    const string KEY_Scene_variant= "Test.Variants";
+    const string KEY_Bench_command= "Test.command";
+    const string KEY_Bench_metrics= "Test.Metrics";
+    const string KEY_Bench_unit   = "Test.benchUnit";
+    const string KEY_Bench_samples= "Test.benchSamples";
+    const string KEY_Pareto_grid  = "Test.Grid";
 
     const string KEY_workDir      = "workDir";
+    const string KEY_stateFile    = "stateFile";
     const string KEY_fileProbe    = "fileProbe";
     const string KEY_fileBaseline = "fileBaseline";
     const string KEY_fileResidual = "fileResidual";
     const string KEY_fileRuntime  = "fileRuntime";
     const string KEY_fileExpense  = "fileExpense";
+    const string KEY_fileLoadtime = "fileLoadtime";
+    const string KEY_fileSceneCost= "fileSceneCost";
+    const string KEY_fileLatency  = "fileLatency";
+    const string KEY_fileRtAudit  = "fileRtAudit";
+    const string KEY_fileStartup  = "fileStartup";
+    const string KEY_fileProfile  = "fileProfile";
+    const string KEY_fileInstrument = "fileInstrument";
+    const string KEY_filePareto   = "filePareto";
+    const string KEY_fileParetoRef= "fileParetoRef";
 
     /** @note all defaults for test specifications defined here
      *        can be omitted within the actual *.test files. */
     const MapS DEFAULT_TEST_SPEC{{KEY_Test_type,  TYPE_CLI}
                                 ,{KEY_verifySound, "Off"}
                                 ,{KEY_verifyTimes, "Off"}
+                                ,{KEY_verifyLatency,"Off"}
                                 ,{KEY_cliTimeout,  "60" }
+                                ,{KEY_Load_repeat, "1"  }
+                                ,{KEY_Load_parts,  "1"  }
+                                ,{KEY_Bench_unit,  "ms" }
+                                ,{KEY_Bench_samples,"48000"}
                                 };
 
     const string DEFAULT_MINIMAL_TEST_SCRIPT{"set test execute"};
 
+    /** page cache conditions for timed test cases (setting `cache`) */
+    const string CACHE_PLAIN{"plain"};
+    const string CACHE_WARM {"warm"};
+    const string CACHE_COLD {"cold"};
+
+    /** interleaved invocations of reference and candidate for differential profiling (`--profile`) */
+    const uint PROFILE_ROUNDS = 2;
+
 
 
     /* ========= response patterns at the Yoshimi CLI ========= */
     const string YOSHIMI_SUCCESFULL_START_PATTERN{"Yay! We're up and running :\\-\\)"};
     const string YOSHIMI_PROMPT_PATTERN{"yoshimi>.*"};
+    const string YOSHIMI_ECHO_LOAD_PATTERN{".+>\\s*load\\s+.+"};
+    const string YOSHIMI_ECHO_TOPLEVEL_PATTERN{".+>\\s*/\\s*"};
 
     const string NUMBER ="[\\d\\.+\\-e]+";
     const string INTEGER ="[+\\-]?\\d+";
@@ -118,18 +161,44 @@ namespace def {
     const string CLI_DEFINITION{"set"};
     const string CLI_TEST_OUTPUT{"target"};
     const string CLI_ENTER_TEST_CONTEXT{"set test"};
+    const string CLI_SELECT_PART{"set part"};
+    const string CLI_LOAD_INSTRUMENT{"load instrument"};
+    const string CLI_LOAD_PATCHSET{"load patchset"};
+    const string CLI_TOPLEVEL{"/"};
+    const string CLI_LOAD_STATE{"load state"};
+
+    const string EXT_INSTRUMENT{".xiz"};
+    const string EXT_PATCHSET{".xmz"};
 
     const string SOUND_DEFAULT_PROBE{"sound"};
     const string SOUND_BASELINE_MARK{"baseline"};
     const string SOUND_RESIDUAL_MARK{"residual"};
     const string TIMING_RUNTIME_MARK{"runtime"};
     const string TIMING_EXPENSE_MARK{"expense"};
+    const string TIMING_LOADTIME_MARK{"loadtime"};
+    const string TIMING_SCENECOST_MARK{"scenecost"};
+    const string TIMING_LATENCY_MARK{"latency"};
+    const string TIMING_RTAUDIT_MARK{"rtaudit"};
+    const string TIMING_STARTUP_MARK{"startup"};
+    const string TIMING_PROFILE_MARK{"profile"};
+    const string TIMING_INSTRUMENT_MARK{"instrument"};
+    const string TIMING_PARETO_MARK{"pareto"};
+    const string SOUND_PARETO_REF_MARK{"pareto-reference"};
     const string TIMING_SUITE_PLATFORM{"Suite-platform"};
     const string TIMING_SUITE_STATISTIC{"Suite-statistic"};
     const string TIMING_SUITE_REGRESSION{"Suite-regression"};
+    const string TIMING_SUITE_DRIFT{"Suite-drift"};
+    const string TIMING_SUITE_QUARANTINE{"Suite-quarantine"};
+    const string TIMING_SUITE_SUBTREE{"Suite-subtree"};
+    const string SUITE_DURATIONS{"Suite-durations"};
+    const string SUITE_MEMO{"Suite-memo"};
+    const string SANDBOX_SEED{"sandbox-home"};
     const string EXT_SOUND_RAW{".raw"};
     const string EXT_SOUND_WAV{".wav"};
+    const string EXT_SOUND_RF64{".rf64"};
+    const string EXT_SOUND_W64{".w64"};
     const string EXT_DATA_CSV {".csv"};
+    const string EXT_DATA_HTML{".html"};
 
     const double MINUS_INF{-std::numeric_limits<double>::infinity()};
 
@@ -138,6 +207,10 @@ namespace def {
     const double DIFF_WARN_LEVEL  = -120; // dB peakRMS against probe average RMS
     const double DIFF_STRICT      = -300; // lowered trigger level for --strict
 
+    const double QUARANTINE_ENTER   = 0.25; // tolerance band (3·σ) relative to runtime; exclude from suite statistics
+    const double QUARANTINE_RELEASE = 0.10; // ...include again after staying below this level
+    const uint   QUARANTINE_STABLE_RUNS = 5;//    for this number of consecutive runs
+
     const size_t EXPECTED_TEST_CNT = 500; // used to reserve() vector allocations
 }
 
@@ -229,18 +302,30 @@ class Config
 public:
     CFG_PARAM(fs::path, subject);
     CFG_PARAM(string,   arguments);
+    CFG_PARAM(string,   failPattern);
     CFG_PARAM(fs::path, suitePath);
     CFG_PARAM(fs::path, initialState);
     CFG_PARAM(uint,     timingsKeep);
     CFG_PARAM(uint,     baselineKeep);
     CFG_PARAM(uint,     baselineAvg);
     CFG_PARAM(uint,     longtermAvg);
+    CFG_PARAM(double,   contaminationLimit);
     CFG_PARAM(bool,     calibrate);
+    CFG_PARAM(bool,     recalibrate);
     CFG_PARAM(bool,     baseline);
     CFG_PARAM(bool,     verbose);
     CFG_PARAM(bool,     strict);
+    CFG_PARAM(bool,     memo);
+    CFG_PARAM(bool,     audit);
+    CFG_PARAM(bool,     instrument);
+    CFG_PARAM(bool,     sandbox);
+    CFG_PARAM(string,   cache);
+    CFG_PARAM(fs::path, profile);
     CFG_PARAM(string,   filter);
     CFG_PARAM(fs::path, report);
+    CFG_PARAM(string,   coordinator);
+    CFG_PARAM(string,   worker);
+    CFG_PARAM(string,   analyze);
 
     //--global-Facilities----
     suite::PProgress progress;
@@ -256,18 +341,30 @@ private: /* ===== Initialisation from raw settings ===== */
     Config(Settings rawParam)
         : subject     {rawParam[KEY_subject]}
         , arguments   {rawParam[KEY_arguments]}
+        , failPattern {rawParam[KEY_failPattern]}
         , suitePath   {rawParam[KEY_suitePath]}
         , initialState{rawParam[KEY_initialState]}
         , timingsKeep {rawParam[KEY_timingsKeep].as<uint>()}
         , baselineKeep{rawParam[KEY_baselineKeep].as<uint>()}
         , baselineAvg {rawParam[KEY_baselineAvg].as<uint>()}
         , longtermAvg {rawParam[KEY_longtermAvg].as<uint>()}
+        , contaminationLimit{rawParam[KEY_contaminationLimit].as<double>()}
         , calibrate   {rawParam[KEY_calibrate].as<bool>()}
+        , recalibrate {rawParam[KEY_recalibrate].as<bool>()}
         , baseline    {rawParam[KEY_baseline].as<bool>()}
         , verbose     {rawParam[KEY_verbose].as<bool>()}
         , strict      {rawParam[KEY_strict].as<bool>()}
+        , memo        {rawParam[KEY_memo].as<bool>()}
+        , audit       {rawParam[KEY_audit].as<bool>()}
+        , instrument  {rawParam[KEY_instrument].as<bool>()}
+        , sandbox     {rawParam[KEY_sandbox].as<bool>()}
+        , cache       {rawParam[KEY_cache]}
+        , profile     {rawParam[KEY_profile]}
         , filter      {rawParam[KEY_filter]}
         , report      {rawParam[KEY_report]}
+        , coordinator {rawParam[KEY_coordinator]}
+        , worker      {rawParam[KEY_worker]}
+        , analyze     {rawParam[KEY_analyze]}
         , progress    {setupProgressLog(verbose)}
     {
         if (verbose)
@@ -275,18 +372,30 @@ private: /* ===== Initialisation from raw settings ===== */
             dump(rawParam);
             CFG_DUMP(subject);
             CFG_DUMP(arguments);
+            CFG_DUMP(failPattern);
             CFG_DUMP(suitePath);
             CFG_DUMP(initialState);
             CFG_DUMP(timingsKeep);
             CFG_DUMP(baselineKeep);
             CFG_DUMP(baselineAvg);
             CFG_DUMP(longtermAvg);
+            CFG_DUMP(contaminationLimit);
             CFG_DUMP(calibrate);
+            CFG_DUMP(recalibrate);
             CFG_DUMP(baseline);
             CFG_DUMP(verbose);
             CFG_DUMP(strict);
+            CFG_DUMP(memo);
+            CFG_DUMP(audit);
+            CFG_DUMP(instrument);
+            CFG_DUMP(sandbox);
+            CFG_DUMP(cache);
+            CFG_DUMP(profile);
             CFG_DUMP(filter);
             CFG_DUMP(report);
+            CFG_DUMP(coordinator);
+            CFG_DUMP(worker);
+            CFG_DUMP(analyze);
         }
     }
 
@@ -327,6 +436,16 @@ private:
            and settings[KEY_calibrate].as<bool>())
             throw error::Misconfig("unwise to store --baseline and then --calibrate after the suite in one run; "
                                    "better store --baseline in the next run, based on the new calibration.");
+        if (not util::isnil(string{settings[KEY_coordinator]})
+           and not util::isnil(string{settings[KEY_worker]}))
+            throw error::Misconfig("either act as --coordinator or as --worker, not both.");
+        string cache = settings[KEY_cache];
+        if (cache != def::CACHE_PLAIN and cache != def::CACHE_WARM and cache != def::CACHE_COLD)
+            throw error::Misconfig("--cache="+cache+" unknown; use "+def::CACHE_PLAIN+", "
+                                   +def::CACHE_WARM+" or "+def::CACHE_COLD+".");
+        if (not util::isnil(string{settings[KEY_profile]})
+           and not util::isnil(string{settings[KEY_coordinator]}))
+            throw error::Misconfig("--profile attaches to the local subprocess; not possible with --coordinator.");
         fs::path suiteRoot = fs::consolidated(fs::path(settings[KEY_suitePath]));
         if (not fs::is_directory(suiteRoot))
             throw error::Misconfig("Testsuite root directory "+util::formatVal(suiteRoot)+" not found.");
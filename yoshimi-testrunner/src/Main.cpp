@@ -27,6 +27,9 @@
  ** - perform this testsuite, capturing results
  ** - generate a result report
  ** The [exit code](\ref Stage::getReturnCode) indicates success (0) or failure.
+ ** When configured as `--worker`, the testrunner instead serves test cases
+ ** handed out by a remote coordinator (see Worker.hpp), and with `--analyze`, it
+ ** evaluates the stored timing histories without running any test (see Analysis.hpp).
  **
  ** # Guide for Programmers
  ** To understand the basics of the Yoshimi-Testrunner, you might visit the following
@@ -41,6 +44,8 @@
 #include "Config.hpp"
 #include "Suite.hpp"
 #include "Stage.hpp"
+#include "Worker.hpp"
+#include "Analysis.hpp"
 
 #include <iostream>
 
@@ -55,6 +60,11 @@ int main(int argc, char *argv[])
                      ,Config::fromFile(def::SETUP_INI)
                      ,Config::fromDefaultsIni()
                      };
+        if (not util::isnil(config.worker))
+            return int(Worker{config}.serve());
+        if (not util::isnil(config.analyze))
+            return int(Analysis{config}.perform());
+
         Suite suite{config};
         Stage stage{config};
         stage.perform(suite);
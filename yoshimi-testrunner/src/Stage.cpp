@@ -56,17 +56,24 @@ Stage::Stage(Config const& config)
  * as well as any out of order observations during test execution. Progress of the
  * test execution will be marked by output into the progress sink, which was
  * established on initialisation and based on the Config (typically -> STDOUT).
+ * Each result is passed to the report immediately, and then only aggregated.
  */
 void Stage::perform(Suite& suite)
 {
+    report_->beginSuite(suite.topics());
     for (auto& step : suite)
-        results_ << step->perform();
+    {
+        suite::Result res = step->perform();
+        report_->consume(res);
+        results_ << std::move(res);
+    }
 }
 
 
 /**
- * Generate a test report based on the execution information captured within this stage.
- * The report will be sent into the result output sink established on initialisation.
+ * Conclude the test report with a summary of the execution information captured within
+ * this stage. The report is sent into the result output sink established on initialisation;
+ * details for each test case were already rendered while performing the Testsuite.
  */
 void Stage::renderReport()
 {
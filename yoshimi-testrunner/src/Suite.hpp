@@ -85,6 +85,9 @@ public:
 
     iterator begin() { return steps_.begin(); }
     iterator end()   { return steps_.end(); }
+
+    /** @return topic paths of all test cases, in order of execution */
+    std::vector<fs::path> const& topics()  const { return steps_.topics; }
 };
 
 #endif /*TESTRUNNER_SUITE_HPP_*/
@@ -0,0 +1,269 @@
+/*
+ *  Worker - perform test cases on behalf of a remote coordinator
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+/** @file Worker.cpp
+ ** Implementation of the worker side of the distributed test protocol.
+ ** While a test case is running, a heartbeat is sent every few seconds, allowing
+ ** the coordinator to distinguish a lengthy test from a lost worker. The sound probe
+ ** is the file configured by the case's own PathSetup, and is only sent when written
+ ** while performing the case; the coordinator stores it under its own probe filename.
+ **
+ */
+
+
+#include "Worker.hpp"
+#include "util/error.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "setup/Builder.hpp"
+#include "suite/Progress.hpp"
+
+#include <condition_variable>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <unistd.h>
+
+using std::string;
+using util::isnil;
+using util::formatVal;
+using util::startsWith;
+using util::Connection;
+using util::PConnection;
+using suite::Progress;
+using suite::ResCode;
+using suite::Result;
+
+
+namespace {// Implementation details
+
+    const int  CONNECT_ATTEMPTS = 30;
+    const auto CONNECT_RETRY    = std::chrono::seconds(1);
+    const auto HEARTBEAT        = std::chrono::seconds(5);
+    const int  AWAIT_FOREVER    = -1;
+
+    string identifyWorker()
+    {
+        char host[256] = {0};
+        gethostname(host, sizeof(host)-1);
+        return string{host}+":"+formatVal(getpid());
+    }
+
+    /** order result codes by severity; DEBACLE is worst */
+    int severity(ResCode code)
+    {
+        return ResCode::DEBACLE == code? std::numeric_limits<int>::max() : int(code);
+    }
+
+    /** @return summary message without the leading result code marker */
+    string bareMessage(Result const& res)
+    {
+        string msg = res.summary;
+        util::removePrefix(msg, suite::showRes(res.code));
+        util::removePrefix(msg, ":");
+        util::removePrefix(msg, " ");
+        return msg == "."? "" : msg;
+    }
+
+
+    /**
+     * Progress adapter to relay all output to the coordinator,
+     * while also capturing it locally for diagnostics.
+     */
+    class RelayLog
+        : public Progress
+    {
+        Connection& conn_;
+        Progress& local_;
+
+        void indicateTest(fs::path topicPath)  override { local_.indicateTest(topicPath); }
+        void clearLog()                        override { local_.clearLog(); }
+        std::smatch grep(std::regex const& pattern) const override { return local_.grep(pattern); }
+
+        void out(string line)  override
+        {
+            conn_.sendLine("OUT "+line);
+            local_.out(line);
+        }
+        void err(string line)  override
+        {
+            conn_.sendLine("ERR "+line);
+            local_.err(line);
+        }
+        void note(string line)  override
+        {
+            conn_.sendLine("OUT "+line);
+            local_.note(line);
+        }
+
+    public:
+        RelayLog(Connection& conn, Progress& local)
+            : conn_{conn}
+            , local_{local}
+        { }
+    };
+
+
+    /** send `ALIVE` periodically while in scope */
+    class Heartbeat
+        : util::NonCopyable
+    {
+        std::mutex lock_;
+        std::condition_variable stop_;
+        bool active_{true};
+        std::thread beat_;
+
+    public:
+        Heartbeat(Connection& conn)
+            : beat_{[&]{
+                        std::unique_lock<std::mutex> guard{lock_};
+                        while (not stop_.wait_for(guard, HEARTBEAT, [this]{ return not active_; }))
+                            try { conn.sendLine("ALIVE"); }
+                            catch(...) { return; } // connection lost; noticed by main thread
+                    }}
+        { }
+
+       ~Heartbeat()
+        {
+            {
+                std::lock_guard<std::mutex> guard{lock_};
+                active_ = false;
+            }
+            stop_.notify_all();
+            beat_.join();
+        }
+    };
+
+
+    /** @return whether the sound probe was written after `since` */
+    bool isFreshProbe(fs::path probe, fs::file_time_type since)
+    {
+        std::error_code noThrow;
+        return not probe.empty()
+           and fs::is_regular_file(probe, noThrow)
+           and fs::last_write_time(probe, noThrow) >= since;
+    }
+
+    string readFile(fs::path path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    /** strip a protocol keyword and the following space */
+    string payload(string const& line, string const& keyword)
+    {
+        return line.length() > keyword.length()? line.substr(keyword.length()+1) : "";
+    }
+}//(End)Implementation details
+
+
+
+Worker::Worker(Config const& config)
+    : config_{config}
+    , workerID_{identifyWorker()}
+    , sandbox_{suite::Sandbox::setup(config)}
+{ }
+
+
+suite::ResCode Worker::serve()
+{
+    Progress& progressLog = *config_.progress;
+    PConnection conn;
+    for (int attempt=1; not conn; ++attempt)
+        try {
+            conn = Connection::connectTo(config_.worker);
+        }
+        catch(error::State&)
+        {
+            if (attempt >= CONNECT_ATTEMPTS) throw;
+            std::this_thread::sleep_for(CONNECT_RETRY);
+        }
+    progressLog.note("Worker "+workerID_+": connected to coordinator at "+formatVal(config_.worker));
+    conn->sendLine("HELLO "+workerID_);
+
+    uint cnt{0};
+    while (auto command = conn->readLine(AWAIT_FOREVER))
+    {
+        if (startsWith(*command, "QUIT"))
+        {
+            progressLog.note("Worker "+workerID_+": completed "+formatVal(cnt)+" test cases.");
+            return ResCode::GREEN;
+        }
+        if (not startsWith(*command, "RUN"))
+            throw error::State("Protocol violation; unexpected command "+formatVal(*command));
+
+        std::istringstream request{payload(*command, "RUN")};
+        string jobID, topic;
+        request >> jobID >> std::ws;
+        std::getline(request, topic);
+        performCase(*conn, jobID, topic);
+        ++cnt;
+    }
+    throw error::LogicBroken("unlimited wait for coordinator returned.");
+}
+
+
+/**
+ * Perform the wired steps of a single test case and send the response.
+ * @remark failures are reported to the coordinator, not raised locally;
+ *         only a broken connection (on sending) terminates the worker.
+ */
+void Worker::performCase(Connection& conn, string jobID, fs::path topicPath)
+{
+    RelayLog relay{conn, *config_.progress};
+    Heartbeat heartbeat{conn};
+    auto start = fs::file_time_type::clock::now();
+    auto findings = std::make_shared<suite::WorkerFindings>();
+
+    ResCode outcome{ResCode::GREEN};
+    string summary;
+    auto capture = [&](ResCode code, string msg)
+                        {
+                            if (severity(code) <= severity(outcome)) return;
+                            outcome = code;
+                            summary = msg;
+                        };
+    try {
+        setup::StepSeq steps = setup::buildWorkerCase(config_, topicPath, relay, sandbox_, findings);
+        for (auto& step : steps)
+        {
+            Result res = step->perform();
+            capture(res.code, bareMessage(res));
+        }
+    }
+    catch(std::exception& ex)
+    {
+        capture(ResCode::MALFUNCTION, ex.what());
+    }
+
+    if (isFreshProbe(findings->probe, start))
+    {
+        string data = readFile(findings->probe);
+        conn.sendBlock("PROBE "+formatVal(data.size()), data);
+    }
+    conn.sendLine("DONE "+jobID+" "+formatVal(int(outcome))+" "+formatVal(findings->contamination)
+                 +" "+(isnil(summary)? "remote" : summary));
+}
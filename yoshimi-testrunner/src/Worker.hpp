@@ -0,0 +1,70 @@
+/*
+ *  Worker - perform test cases on behalf of a remote coordinator
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+/** @file Worker.hpp
+ ** Worker mode of the Yoshimi-Testrunner for distributed test execution.
+ ** When launched with `--worker=<address>`, the testrunner does not build a Testsuite;
+ ** rather it connects to a coordinator (see suite::Dispatcher) and performs the test
+ ** cases handed out, using the local subject and a local copy of the Testsuite tree
+ ** (given as `suitePath` like for a regular test run). For each case, only the steps
+ ** to launch Yoshimi and run the test script are wired (setup::WorkerMould); output of
+ ** the subject is relayed to the coordinator, followed by the sound probe, if any.
+ ** With `--sandbox`, the worker keeps a private home for the subject (suite::Sandbox),
+ ** so that several workers on the same machine do not share Yoshimi's configuration.
+ **
+ ** @see Dispatcher.hpp for the protocol
+ ** @see Main.cpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_WORKER_HPP_
+#define TESTRUNNER_WORKER_HPP_
+
+
+#include "Config.hpp"
+#include "util/nocopy.hpp"
+#include "util/socket.hpp"
+#include "suite/Result.hpp"
+#include "suite/Sandbox.hpp"
+
+#include <string>
+
+
+/**
+ * Serve a coordinator by performing test cases on demand.
+ */
+class Worker
+    : util::NonCopyable
+{
+    Config const& config_;
+    string workerID_;
+    suite::PSandbox sandbox_;
+
+public:
+    Worker(Config const& config);
+
+    /** connect and perform test cases until the coordinator sends `QUIT` */
+    suite::ResCode serve();
+
+private:
+    void performCase(util::Connection&, string jobID, fs::path topicPath);
+};
+
+#endif /*TESTRUNNER_WORKER_HPP_*/
@@ -38,6 +38,10 @@
 #include "util/utils.hpp"
 #include "util/regex.hpp"
 #include "suite/Timings.hpp"
+#include "suite/Dispatcher.hpp"
+#include "suite/Memo.hpp"
+#include "suite/ProfileDiff.hpp"
+#include "suite/Sandbox.hpp"
 
 #include <iostream>
 #include <cassert>
@@ -52,6 +56,10 @@ using util::isnil;
 using util::contains;
 using util::formatVal;
 using suite::Timings;
+using suite::Dispatcher;
+using suite::Memo;
+using suite::ProfileDiff;
+using suite::Sandbox;
 
 
 namespace setup {
@@ -69,6 +77,12 @@ struct SuiteCtx
     Config const& config;
     util::Matcher filter;
     suite::PTimings timings;
+    suite::PDispatcher dispatcher;
+    suite::PMemo memo;
+    suite::PProfileDiff profileDiff;
+    suite::PSandbox sandbox;
+    suite::PWorkerFindings findings;
+    suite::Progress& progress;
 };
 
 
@@ -105,9 +119,15 @@ public:
     /** setup the test suite definition */
     Builder& buildTree();
 
+    /** setup global preparations prior to all test cases */
+    Builder& buildPrelude();
+
     /** setup global statistics and evaluation */
     Builder& buildClosure();
 
+    /** setup a single test case to perform within a worker process */
+    Builder& buildWorkerCase(fs::path topicPath);
+
     /** retrieve the built TestStep sequence */
     StepSeq getStepSeq()
     {   return move(wiredSteps); }
@@ -116,6 +136,7 @@ private:
     string selectSubject(string testTypeID);
     StepSeq maybeBuildTest(fs::path);
     StepSeq buildTestcase(fs::path);
+    MapS prepareSpec(fs::path);
     StepSeq applyMould(MapS spec);
 };
 
@@ -182,6 +203,14 @@ StepSeq Builder::maybeBuildTest(fs::path topicPath)
  * @return complete internally wired sequence of test steps for this case, ready for execution
  */
 StepSeq Builder::buildTestcase(fs::path topicPath)
+{
+    StepSeq steps = applyMould(prepareSpec(topicPath));
+    steps.topics.push_back(topicPath);
+    return steps;
+}
+
+/** @internal evaluate the test spec and supply defaults and global settings */
+MapS Builder::prepareSpec(fs::path topicPath)
 {
     fs::path testWorkDir = (ctx_.root / topicPath).parent_path();
 
@@ -189,6 +218,7 @@ StepSeq Builder::buildTestcase(fs::path topicPath)
     Config::supplySettings(spec, def::DEFAULT_TEST_SPEC);
     spec.insert({KEY_Test_subj,  selectSubject(spec[KEY_Test_type])});
     spec.insert({KEY_Test_args,  ctx_.config.arguments});
+    spec.insert({KEY_failPattern,ctx_.config.failPattern});
     spec.insert({KEY_Test_topic, topicPath});
 
     // trigger level for sound differences, usually the global default
@@ -197,7 +227,8 @@ StepSeq Builder::buildTestcase(fs::path topicPath)
         spec[KEY_warnLevel] = formatVal(def::DIFF_STRICT); // force any difference to trigger a warning
 
     spec[KEY_workDir] = testWorkDir;
-    spec[KEY_Test_args] += " --state="+string(ctx_.config.locateInitialState(testWorkDir));
+    spec[KEY_stateFile] = ctx_.config.locateInitialState(testWorkDir);
+    spec[KEY_Test_args] += " --state="+spec[KEY_stateFile];
     if (contains(spec, KEY_Test_addArgs))
         spec[KEY_Test_args] += " "+spec[KEY_Test_addArgs];
 
@@ -208,17 +239,24 @@ StepSeq Builder::buildTestcase(fs::path topicPath)
             cout << entry.first<<"="<<entry.second<<"\n";
         cout << "." << endl;
     }
-
-    return applyMould(spec);
+    return spec;
 }
 
 StepSeq Builder::applyMould(MapS spec)
 {
     return useMould_for(spec[KEY_Test_type])
                     .withTimings(ctx_.timings)
-                    .withProgress(*ctx_.config.progress)
+                    .withDispatcher(ctx_.dispatcher)
+                    .withMemo(ctx_.memo)
+                    .withProfileDiff(ctx_.profileDiff)
+                    .withSandbox(ctx_.sandbox)
+                    .withFindings(ctx_.findings)
+                    .withProgress(ctx_.progress)
                     .recordBaseline(ctx_.config.baseline)
                     .calibrateTiming(ctx_.config.calibrate)
+                    .auditRealtime(ctx_.config.audit)
+                    .instrument(ctx_.config.instrument)
+                    .cacheMode(ctx_.config.cache)
                     .generateStps(spec);
 }
 
@@ -235,6 +273,15 @@ string Builder::selectSubject(string testTypeID)
 }
 
 
+Builder& Builder::buildPrelude()
+{
+    MapS spec;
+    spec[KEY_Test_type] = PRELUDE;
+    wiredSteps.moveAppendAll(applyMould(spec));
+    return *this;
+}
+
+
 Builder& Builder::buildClosure()
 {
     MapS spec;
@@ -243,6 +290,25 @@ Builder& Builder::buildClosure()
     return *this;
 }
 
+
+/**
+ * @remark the worker performs a test case defined in its local copy of the suite,
+ *         with the topic path given by the coordinator; the test type is switched
+ *         to def::WORKER, which only wires the steps for invocation.
+ */
+Builder& Builder::buildWorkerCase(fs::path topicPath)
+{
+    if (not SubTraversal::isTestDefinition(ctx_.root / topicPath))
+        throw error::Misconfig("Test case "+formatVal(topicPath)+" requested by coordinator "
+                               "not found within the local testsuite "+formatVal(ctx_.root));
+    MapS spec = prepareSpec(topicPath);
+    if (spec[KEY_Test_type] != TYPE_CLI)
+        throw error::ToDo("Remote execution of Test.type="+spec[KEY_Test_type]);
+    spec[KEY_Test_type] = WORKER;
+    wiredSteps.moveAppendAll(applyMould(spec));
+    return *this;
+}
+
 }//(End)Implementation details
 
 
@@ -261,12 +327,38 @@ StepSeq build(Config const& config)
 
     SuiteCtx anchor{suiteRoot,config
                    ,util::Matcher{config.filter}
-                   ,Timings::setup(config)};
+                   ,Timings::setup(config)
+                   ,Dispatcher::setup(config)
+                   ,Memo::setup(config)
+                   ,ProfileDiff::setup(config)
+                   ,Sandbox::setup(config)
+                   ,suite::PWorkerFindings{}
+                   ,*config.progress};
 
     return Builder(anchor)
+                  .buildPrelude()
                   .buildTree()
                   .buildClosure()
                   .getStepSeq();
 }
 
+
+StepSeq buildWorkerCase(Config const& config, fs::path topicPath, suite::Progress& relay
+                       ,suite::PSandbox sandbox, suite::PWorkerFindings findings)
+{
+    SuiteCtx anchor{fs::consolidated(config.suitePath), config
+                   ,util::Matcher{}
+                   ,suite::PTimings{}
+                   ,suite::PDispatcher{}
+                   ,suite::PMemo{}
+                   ,suite::PProfileDiff{}
+                   ,sandbox
+                   ,findings
+                   ,relay};
+
+    return Builder(anchor, topicPath.parent_path())
+                  .buildWorkerCase(topicPath)
+                  .getStepSeq();
+}
+
 }//(End)namespace setup
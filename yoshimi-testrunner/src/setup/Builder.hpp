@@ -41,27 +41,42 @@
 #include "Config.hpp"
 #include "util/nocopy.hpp"
 #include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Sandbox.hpp"
+#include "suite/Dispatcher.hpp"
 
 #include <filesystem>
 #include <algorithm>
+#include <vector>
 #include <deque>
 
 namespace setup {
 
 /**
  * A thin wrapper around the STL sequence container,
- * with the ability to move-append a sequence of items
+ * with the ability to move-append a sequence of items.
+ * In addition, the topics of all test cases covered
+ * are recorded, in the order of execution.
  */
 class StepSeq
     : public std::deque<std::unique_ptr<suite::TestStep>>
 {
 public:
+    std::vector<fs::path> topics;
+
     template<class CON>
     StepSeq& moveAppendAll(CON&& sequence)
     {
         std::move(std::begin(sequence), std::end(sequence), std::back_inserter(*this));
         return *this;
     }
+
+    StepSeq& moveAppendAll(StepSeq&& sequence)
+    {
+        std::move(sequence.topics.begin(), sequence.topics.end(), std::back_inserter(topics));
+        std::move(std::begin(sequence), std::end(sequence), std::back_inserter(*this));
+        return *this;
+    }
 };
 
 
@@ -71,6 +86,16 @@ public:
  */
 StepSeq build(Config const&);
 
+/**
+ * Entry Point for a worker process: build the steps to perform a single test case,
+ * as requested by the coordinator, reporting output to the given relay Progress.
+ * @param topicPath test case relative to the root of the local Testsuite.
+ * @param sandbox (optional) private home of the worker, retained over all cases.
+ * @param findings receives the results to send back to the coordinator.
+ */
+StepSeq buildWorkerCase(Config const&, fs::path topicPath, suite::Progress& relay
+                       ,suite::PSandbox sandbox, suite::PWorkerFindings findings);
+
 
 
 }//(End)namespace setup
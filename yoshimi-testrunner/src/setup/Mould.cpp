@@ -23,9 +23,22 @@
  ** and setup for generic test cases of various types.
  ** - def::TYPE_CLI is the default: launch a Yoshimi executable,
  **   then configure various details via CLI and launch the test.
+ **   Cases verifying only the sound may be replaced by a memoised verdict.
+ **   With `--profile`, timed cases are repeated for differential profiling.
  ** - def::TYPE_LV2 (*Planned as of 7/2021*): load Yoshimi as LV2 plugin;
  **   this allows to feed simulated MIDI events and thus perform an
  **   integration test, which also covers event processing.
+ ** - def::TYPE_LOAD launches a Yoshimi executable and loads a corpus
+ **   of instrument files through the CLI, to measure load times.
+ ** - def::TYPE_SCENE loads a complete Yoshimi state and runs the test script,
+ **   then repeats the test for each variant with one component disabled.
+ ** - def::TYPE_BENCH runs an arbitrary command and observes each metric
+ **   extracted from its output as a timing measurement of its own.
+ ** - def::TYPE_PARETO renders the test script for each point of a grid of
+ **   quality settings, to determine the frontier of cost versus difference.
+ ** - def::WORKER is used within a worker process to perform a CLI test case
+ **   handed out by the coordinator; only the invocation steps are wired,
+ **   since observation and judgement happen at the coordinator.
  **
  ** @see TestStep.hpp
  ** @see WiringMould.hpp
@@ -46,6 +59,7 @@
 #include "suite/step/PrepareScript.hpp"
 #include "suite/step/Invocation.hpp"
 #include "suite/step/OutputObservation.hpp"
+#include "suite/step/BenchObservation.hpp"
 #include "suite/step/PlatformCalibration.hpp"
 #include "suite/step/PersistModelTrend.hpp"
 #include "suite/step/TimingObservation.hpp"
@@ -53,11 +67,35 @@
 #include "suite/step/PersistTimings.hpp"
 #include "suite/step/TrendObservation.hpp"
 #include "suite/step/TrendJudgement.hpp"
+#include "suite/step/ClusterJudgement.hpp"
+#include "suite/step/TimingQuarantine.hpp"
+#include "suite/step/OnlineCalibration.hpp"
+#include "suite/step/JitterProbe.hpp"
 #include "suite/step/SoundObservation.hpp"
 #include "suite/step/SoundJudgement.hpp"
 #include "suite/step/SoundRecord.hpp"
+#include "suite/step/SystemWatch.hpp"
+#include "suite/step/LoadSequence.hpp"
+#include "suite/step/LoadJudgement.hpp"
+#include "suite/step/SceneCost.hpp"
+#include "suite/step/OnsetLatency.hpp"
+#include "suite/step/Memoisation.hpp"
+#include "suite/step/RealtimeAudit.hpp"
+#include "suite/step/StartupCost.hpp"
+#include "suite/step/DiffProfile.hpp"
+#include "suite/step/PreloadShim.hpp"
+#include "suite/step/SandboxReset.hpp"
+#include "suite/step/ParetoBenchmark.hpp"
 #include "suite/step/Summary.hpp"
 #include "suite/step/CleanUp.hpp"
+#include "suite/step/WorkerReport.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <cctype>
+#include <regex>
+#include <map>
 
 
 
@@ -94,6 +132,195 @@ inline bool shallVerifyTimes(MapS const& spec)
     return util::boolVal(spec.at(KEY_verifyTimes));
 }
 
+/** @remark onset latency is detected in the sound probe, which is only loaded for sound verification */
+inline bool shallVerifyLatency(MapS const& spec)
+{
+    bool verifyLatency = util::boolVal(spec.at(KEY_verifyLatency));
+    if (verifyLatency and not shallVerifySound(spec))
+        throw error::Misconfig(KEY_verifyLatency+" requires "+KEY_verifySound+" = On");
+    return verifyLatency;
+}
+
+/** @remark cases with any kind of timing measurement are always performed,
+ *          since each run contributes a new data point to the time series */
+inline bool isMemoCandidate(MapS const& spec)
+{
+    return shallVerifySound(spec)
+       and not shallVerifyTimes(spec)
+       and not shallVerifyLatency(spec);
+}
+
+/**
+ * Retrieve the note duration configured for the TestInvoker.
+ * @return duration in seconds, or 0.0 if not set by the test script
+ */
+inline double noteDuration(MapS const& spec)
+{
+    double duration = 0.0;
+    if (definesTestScript(spec))
+    {
+        static const std::regex SET_DURATION{"\\bduration\\s+("+NUMBER+")"
+                                            ,std::regex::icase | std::regex::optimize};
+        string const& script = spec.at(KEY_Test_script);
+        for (std::sregex_iterator mat{script.begin(), script.end(), SET_DURATION}, end; mat != end; ++mat)
+            duration = util::parseAs<double>((*mat)[1]);
+    }
+    return duration;
+}
+
+/**
+ * Parse the variants of a scene test: each line in the `Variants` block
+ * reads `<label> : <CLI command>`; several lines with the same label
+ * are combined into a sequence of commands.
+ * @return pairs `(label, commands)` in order of first appearance
+ */
+inline std::vector<std::pair<string,string>> sceneVariants(MapS const& spec)
+{
+    std::vector<std::pair<string,string>> variants;
+    if (not util::contains(spec, KEY_Scene_variant))
+        return variants;
+    static const std::regex PARSE_VARIANT{"\\s*([\\w\\-\\.]+)\\s*:\\s*(.+)", std::regex::optimize};
+    std::istringstream block{spec.at(KEY_Scene_variant)};
+    std::smatch mat;
+    for (string line; std::getline(block, line); )
+    {
+        if (util::isnil(line)) continue;
+        if (not std::regex_match(line, mat, PARSE_VARIANT))
+            throw error::Misconfig("Scene variant "+util::formatVal(line)+" not in the form '<label> : <CLI command>'");
+        auto pos = std::find_if(variants.begin(), variants.end()
+                               ,[&](auto& variant){ return variant.first == mat[1]; });
+        if (pos == variants.end())
+            variants.emplace_back(mat[1], string{mat[2]});
+        else
+            pos->second += "\n"+string{mat[2]};
+    }
+    return variants;
+}
+
+/** CLI script to load the scene, possibly modify it, and then launch the test */
+inline string sceneScript(MapS const& spec, string modification ="")
+{
+    fs::path state = fs::path(spec.at(KEY_workDir)) / spec.at(KEY_Scene_state);
+    return CLI_LOAD_STATE+" "+state.string()+"\n"
+         + (util::isnil(modification)? "" : modification+"\n")
+         + spec.at(KEY_Test_script);
+}
+
+
+/**
+ * Parse the metrics of a benchmark: each line in the `Metrics` block reads
+ * `<name> : <regular expression>`, where the first capture group yields the value,
+ * or `<name> : json <field>` to pick the numeric value of a JSON field.
+ * @return pairs `(name, regExp)` in order of definition
+ */
+inline MetricDefs benchMetrics(MapS const& spec)
+{
+    MetricDefs metrics;
+    if (util::contains(spec, KEY_Bench_metrics))
+    {
+        static const std::regex PARSE_METRIC{"\\s*([\\w\\-\\.]+)\\s*:\\s*(.+)", std::regex::optimize};
+        static const std::regex PARSE_JSON_FIELD{"json\\s+([\\w\\-\\.]+)\\s*", std::regex::optimize};
+        std::istringstream block{spec.at(KEY_Bench_metrics)};
+        std::smatch mat, field;
+        for (string line; std::getline(block, line); )
+        {
+            if (util::isnil(line)) continue;
+            if (not std::regex_match(line, mat, PARSE_METRIC))
+                throw error::Misconfig("Metric "+util::formatVal(line)+" not in the form '<name> : <regExp>'");
+            string pattern = mat[2];
+            if (std::regex_match(pattern, field, PARSE_JSON_FIELD))
+                pattern = "\"" + string{field[1]} + "\"\\s*:\\s*("+NUMBER+")";
+            else
+            if (0 == std::regex{pattern}.mark_count())
+                throw error::Misconfig("Metric "+util::formatVal(string{mat[1]})+": pattern requires a capture group for the value");
+            metrics.emplace_back(mat[1], pattern);
+        }
+    }
+    if (metrics.empty())
+        throw error::Misconfig("Test.type="+TYPE_BENCH+" requires a "+KEY_Bench_metrics+" block.");
+    return metrics;
+}
+
+
+/**
+ * Parse the grid of a Pareto benchmark: each line in the `Grid` block
+ * reads `<axis> : <value> = <CLI command>`; the first value on each axis
+ * denotes the highest quality. Points are the cartesian product of all axes.
+ * @return pairs `(label, commands)`, with the reference point first
+ */
+inline std::vector<std::pair<string,string>> paretoGrid(MapS const& spec)
+{
+    using Axis = std::vector<std::pair<string,string>>;
+    std::vector<std::pair<string,Axis>> axes;
+    if (util::contains(spec, KEY_Pareto_grid))
+    {
+        static const std::regex PARSE_SETTING{"\\s*([\\w\\-\\.]+)\\s*:\\s*([\\w\\-\\.]+)\\s*=\\s*(.+)", std::regex::optimize};
+        std::istringstream block{spec.at(KEY_Pareto_grid)};
+        std::smatch mat;
+        for (string line; std::getline(block, line); )
+        {
+            if (util::isnil(line)) continue;
+            if (not std::regex_match(line, mat, PARSE_SETTING))
+                throw error::Misconfig("Grid setting "+util::formatVal(line)+" not in the form '<axis> : <value> = <CLI command>'");
+            auto axis = std::find_if(axes.begin(), axes.end()
+                                    ,[&](auto& entry){ return entry.first == mat[1]; });
+            if (axis == axes.end())
+                axis = axes.emplace(axes.end(), mat[1], Axis{});
+            auto value = std::find_if(axis->second.begin(), axis->second.end()
+                                     ,[&](auto& entry){ return entry.first == mat[2]; });
+            if (value == axis->second.end())
+                axis->second.emplace_back(mat[2], string{mat[3]});
+            else
+                value->second += "\n"+string{mat[3]};
+        }
+    }
+    if (axes.empty())
+        throw error::Misconfig("Test.type="+TYPE_PARETO+" requires a "+KEY_Pareto_grid+" block.");
+
+    std::vector<std::pair<string,string>> points{{"",""}};
+    for (auto& [axis, values] : axes)
+    {
+        std::vector<std::pair<string,string>> combined;
+        for (auto& [label, settings] : points)
+            for (auto& [value, commands] : values)
+                combined.emplace_back((util::isnil(label)? "" : label+",") + axis+"="+value
+                                     ,(util::isnil(settings)? "" : settings+"\n") + commands);
+        points = move(combined);
+    }
+    return points;
+}
+
+
+/**
+ * Classify the synth engines activated by the test script.
+ * Yoshimi enables ADDsynth for a new part; any other engine
+ * must be switched on explicitly with `set PAD on` / `set SUB on`.
+ * @return engine names joined with '+', e.g. "ADD+SUB"
+ */
+inline string synthEngines(MapS const& spec)
+{
+    std::map<string,bool> engines{{"ADD",true},{"PAD",false},{"SUB",false}};
+    if (definesTestScript(spec))
+    {
+        static const std::regex SWITCH_ENGINE{"^\\s*set\\s+(?:part\\s+\\d+\\s+)?(ADD|PAD|SUB)\\w*\\s+(on|off)\\b"
+                                             ,std::regex::icase | std::regex::optimize};
+        std::istringstream script{spec.at(KEY_Test_script)};
+        std::smatch mat;
+        for (string line; std::getline(script, line); )
+            if (std::regex_search(line, mat, SWITCH_ENGINE))
+            {
+                string engine = mat[1];
+                for (char& c : engine) c = std::toupper(c);
+                engines[engine] = util::boolVal(mat[2]);
+            }
+    }
+    string label;
+    for (auto& [engine,active] : engines)
+        if (active)
+            label += (util::isnil(label)? "":"+") + engine;
+    return util::isnil(label)? "none" : label;
+}
+
 
 
 /**
@@ -104,8 +331,87 @@ inline bool shallVerifyTimes(MapS const& spec)
 class ExeCliMould
     : public WiringMould
 {
+    /** @remark the audit attaches to the local subprocess, thus not for remote execution */
+    bool shallAuditRealtime(MapS const& spec)
+    {
+        return shallAuditRealtime_
+           and shallVerifyTimes(spec)
+           and not dispatcher_;
+    }
+
+    /** @remark the preload library reports through shared memory, thus only locally */
+    bool shallInstrument(MapS const& spec)
+    {
+        return shallInstrument_
+           and shallVerifyTimes(spec)
+           and not dispatcher_;
+    }
+
+    /** @remark page cache conditions can only be established for a local subprocess */
+    bool shallControlCache(MapS const& spec)
+    {
+        return cacheMode_ != CACHE_PLAIN
+           and shallVerifyTimes(spec)
+           and not dispatcher_;
+    }
+
+    /** @remark profiling attaches to the local subprocess */
+    bool shallProfile(MapS const& spec)
+    {
+        return profileDiff_
+           and shallVerifyTimes(spec)
+           and not dispatcher_;
+    }
+
+    /** rounds of reference and candidate invocations, interleaved to see the same platform conditions */
+    void wireProfileRounds(MapS const& spec, PathSetup& pathSetup)
+    {
+        auto profileScript = optionally(definesTestScript(spec))
+                                .addStep<PrepareTestScript>(spec.at(KEY_Test_script)
+                                                           ,false
+                                                           ,pathSetup);
+        ProfileRuns reference, candidate;
+        for (uint round=1; round <= PROFILE_ROUNDS; ++round)
+            for (bool isRef : {true,false})
+            {
+                auto sandbox     = optionally(bool(sandbox_))
+                                      .addStep<SandboxReset>(sandbox_);
+                auto& launcher   = addStep<ExeLauncher>(isRef? profileDiff_->reference()
+                                                             : fs::path{spec.at(KEY_Test_subj)}
+                                                       ,spec.at(KEY_Test_topic)+" ~ profile "
+                                                             +(isRef? "reference":"candidate")+" #"+util::formatVal(round)
+                                                       ,spec.at(KEY_cliTimeout)
+                                                       ,spec.at(KEY_failPattern)
+                                                       ,spec.at(KEY_Test_args)
+                                                       ,progressLog_
+                                                       ,profileScript
+                                                       ,Environments{sandbox});
+                auto& sampling   = addStep<ProfileSampling>(launcher);
+                auto& invocation = addStep<Invocation>(launcher,progressLog_);
+                auto& output     = addStep<OutputObservation>(invocation);
+                auto& capture    = addStep<ProfileCapture>(sampling, output);
+                                   addStep<CleanUp>(launcher
+                                                   ,std::nullopt
+                                                   ,std::nullopt
+                                                   ,progressLog_);
+                (isRef? reference : candidate).push_back(capture);
+            }
+        addStep<DiffProfile>(reference, candidate, pathSetup, profileDiff_, progressLog_);
+    }
+
     void materialise(MapS const& spec)  override
     {
+        string memoKey;
+        if (memo_ and isMemoCandidate(spec))
+        {
+            memoKey = memo_->keyFor(spec);
+            if (auto verdict = memo_->lookup(spec.at(KEY_Test_topic), memoKey))
+            {// inputs unchanged since last green run: skip the whole test case
+                addStep<MemoVerdict>(spec.at(KEY_Test_topic), *verdict, progressLog_);
+                return;
+            }
+        }
+
         auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
                                              ,spec.at(KEY_Test_topic));
 
@@ -114,12 +420,206 @@ class ExeCliMould
                                                          ,shallVerifySound(spec)
                                                          ,pathSetup);
 
+        if (shallControlCache(spec) and cacheMode_ == CACHE_WARM)
+        {// discarded warm-up invocation brings subject, libraries and state into the page cache
+            auto warmupScript   = optionally(definesTestScript(spec))
+                                     .addStep<PrepareTestScript>(spec.at(KEY_Test_script)
+                                                                ,false
+                                                                ,pathSetup);
+            auto warmupSandbox  = optionally(bool(sandbox_))
+                                     .addStep<SandboxReset>(sandbox_);
+            auto& warmupLauncher = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                                       ,spec.at(KEY_Test_topic)+" ~ warm-up"
+                                                       ,spec.at(KEY_cliTimeout)
+                                                       ,spec.at(KEY_failPattern)
+                                                       ,spec.at(KEY_Test_args)
+                                                       ,progressLog_
+                                                       ,warmupScript
+                                                       ,Environments{warmupSandbox});
+                                   addStep<Invocation>(warmupLauncher,progressLog_);
+                                   addStep<CleanUp>(warmupLauncher
+                                                   ,std::nullopt
+                                                   ,std::nullopt
+                                                   ,progressLog_);
+        }
+        auto eviction    = optionally(shallControlCache(spec) and cacheMode_ == CACHE_COLD)
+                              .addStep<EvictPageCache>(spec.at(KEY_Test_subj)
+                                                      ,spec.at(KEY_stateFile)
+                                                      ,progressLog_);
+        auto shim        = optionally(shallInstrument(spec))
+                              .addStep<PreloadShim>();
+        auto sandbox     = optionally(sandbox_ and not dispatcher_)
+                              .addStep<SandboxReset>(sandbox_);
+
+        auto remote      = optionally(bool(dispatcher_))
+                              .addStep<RemoteLauncher>(dispatcher_
+                                                      ,spec.at(KEY_Test_topic)
+                                                      ,spec.at(KEY_cliTimeout)
+                                                      ,progressLog_
+                                                      ,pathSetup);
+        Scaffolding& launcher = remote? static_cast<Scaffolding&>(*remote)
+                              : addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                                    ,spec.at(KEY_Test_topic)
+                                                    ,spec.at(KEY_cliTimeout)
+                                                    ,spec.at(KEY_failPattern)
+                                                    ,spec.at(KEY_Test_args)
+                                                    ,progressLog_
+                                                    ,testScript
+                                                    ,Environments{sandbox, shim});
+        auto sysWatch    = optionally(shallVerifyTimes(spec))
+                              .addStep<SystemWatch>(progressLog_, remote);
+        auto rtAudit     = optionally(shallAuditRealtime(spec))
+                              .addStep<RealtimeAudit>(launcher);
+                           optionally(shallInstrument(spec))
+                              .addStep<PreloadMark>(*shim);
+        auto& invocation = addStep<Invocation>(launcher,progressLog_);
+
+        auto& output     = addStep<OutputObservation>(invocation);
+
+                           optionally(shallControlCache(spec))
+                              .addStep<StartupJudgement>(static_cast<ExeLauncher&>(launcher), pathSetup
+                                                        ,suiteTimings_, spec.at(KEY_Test_subj)
+                                                        ,cacheMode_, eviction);
+
+                           optionally(shallAuditRealtime(spec))
+                              .addStep<RealtimeJudgement>(*rtAudit, pathSetup, suiteTimings_, progressLog_);
+
+                           optionally(shallInstrument(spec))
+                              .addStep<PreloadJudgement>(*shim, output, pathSetup, suiteTimings_, progressLog_);
+
+        auto soundProbe  = optionally(shallVerifySound(spec))
+                              .addStep<SoundObservation>(output, pathSetup);
+
+        auto baseline    = optionally(shallVerifySound(spec))
+                              .addStep<SoundJudgement>(*soundProbe, pathSetup, progressLog_
+                                                      ,util::parseAs<double>(spec.at(KEY_warnLevel)));
+
+                           optionally(shallVerifySound(spec))
+                              .addStep<SoundRecord>(shallRecordBaseline_
+                                                  ,*soundProbe, *baseline, pathSetup);
+
+                           optionally(shallVerifyLatency(spec))
+                              .addStep<OnsetLatency>(*soundProbe, output, pathSetup, progressLog_
+                                                    ,suiteTimings_, noteDuration(spec));
+
+        auto timings     = optionally(shallVerifyTimes(spec))
+                              .addStep<TimingObservation>(output, *sysWatch, suiteTimings_, pathSetup
+                                                         ,spec.at(KEY_Test_subj), synthEngines(spec));
+
+        auto timeTrend   = optionally(shallVerifyTimes(spec))
+                              .addStep<TimingJudgement>(*timings,suiteTimings_, shallCalibrateTiming_);
+
+                           optionally(shallVerifyTimes(spec))
+                              .addStep<PersistTimings>(shallRecordBaseline_, *timings, *timeTrend);
+
+        if (shallProfile(spec))
+            wireProfileRounds(spec, pathSetup);
+
+                           optionally(not util::isnil(memoKey))
+                              .addStep<MemoRecord>(memo_, spec.at(KEY_Test_topic), memoKey
+                                                  ,invocation, *baseline);
+
+        /*mark result*/    addStep<Summary>(spec.at(KEY_Test_topic)
+                                           ,invocation
+                                           ,baseline
+                                           ,timeTrend);
+                           addStep<CleanUp>(launcher
+                                           ,soundProbe
+                                           ,sysWatch
+                                           ,progressLog_);
+    }
+};
+
+
+
+/**
+ * Specialised concrete Mould to build a test case which loads
+ * a corpus of instrument files into a running Yoshimi instance
+ * and measures the time spent for each load.
+ * @remark always performed locally, since the corpus and the
+ *         load times are bound to the local file system.
+ */
+class LoadTimeMould
+    : public WiringMould
+{
+    void materialise(MapS const& spec)  override
+    {
+        if (not util::contains(spec, KEY_Load_corpus))
+            throw error::Misconfig("Test.type="+TYPE_LOAD+" requires a "+KEY_Load_corpus+" directory.");
+
+        auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
+                                             ,spec.at(KEY_Test_topic));
+
+        auto sandbox     = optionally(bool(sandbox_))
+                              .addStep<SandboxReset>(sandbox_);
         auto& launcher   = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
                                                ,spec.at(KEY_Test_topic)
                                                ,spec.at(KEY_cliTimeout)
+                                               ,spec.at(KEY_failPattern)
                                                ,spec.at(KEY_Test_args)
                                                ,progressLog_
-                                               ,testScript);
+                                               ,MaybeScript{}
+                                               ,Environments{sandbox});
+        auto sysWatch    = optionally(shallVerifyTimes(spec))
+                              .addStep<SystemWatch>(progressLog_);
+        auto& loads      = addStep<LoadSequence>(launcher
+                                                ,spec.at(KEY_Load_corpus)
+                                                ,spec.at(KEY_Load_repeat)
+                                                ,spec.at(KEY_Load_parts)
+                                                ,progressLog_);
+        auto loadTime    = optionally(shallVerifyTimes(spec))
+                              .addStep<LoadJudgement>(pathSetup, loads, sysWatch, suiteTimings_
+                                                     ,spec.at(KEY_Test_subj));
+
+        /*mark result*/    addStep<LoadSummary>(spec.at(KEY_Test_topic)
+                                               ,loads
+                                               ,loadTime);
+                           addStep<CleanUp>(launcher
+                                           ,std::nullopt
+                                           ,sysWatch
+                                           ,progressLog_);
+    }
+};
+
+
+
+/**
+ * Specialised concrete Mould to build a test case which loads a complete
+ * scene (Yoshimi state) with several parts and effects, and plays the test
+ * script on this scene. The full scene is verified for sound and runtime;
+ * then the test is repeated for each variant, to attribute the cost.
+ * @remark always performed locally, since the differential runs
+ *         are only meaningful on the same machine.
+ */
+class SceneMould
+    : public WiringMould
+{
+    void materialise(MapS const& spec)  override
+    {
+        if (not util::contains(spec, KEY_Scene_state) or not definesTestScript(spec))
+            throw error::Misconfig("Test.type="+TYPE_SCENE+" requires a "+KEY_Scene_state
+                                  +" and a test Script.");
+
+        auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
+                                             ,spec.at(KEY_Test_topic));
+
+        auto& testScript = addStep<PrepareTestScript>(sceneScript(spec)
+                                                     ,shallVerifySound(spec)
+                                                     ,pathSetup);
+
+        auto sandbox     = optionally(bool(sandbox_))
+                              .addStep<SandboxReset>(sandbox_);
+        auto& launcher   = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                               ,spec.at(KEY_Test_topic)
+                                               ,spec.at(KEY_cliTimeout)
+                                               ,spec.at(KEY_failPattern)
+                                               ,spec.at(KEY_Test_args)
+                                               ,progressLog_
+                                               ,testScript
+                                               ,Environments{sandbox});
+        auto variantSpecs= sceneVariants(spec);
+        auto sysWatch    = optionally(shallVerifyTimes(spec) or not variantSpecs.empty())
+                              .addStep<SystemWatch>(progressLog_);
         auto& invocation = addStep<Invocation>(launcher,progressLog_);
 
         auto& output     = addStep<OutputObservation>(invocation);
@@ -135,8 +635,13 @@ class ExeCliMould
                               .addStep<SoundRecord>(shallRecordBaseline_
                                                   ,*soundProbe, *baseline, pathSetup);
 
+                           optionally(shallVerifyLatency(spec))
+                              .addStep<OnsetLatency>(*soundProbe, output, pathSetup, progressLog_
+                                                    ,suiteTimings_, noteDuration(spec));
+
         auto timings     = optionally(shallVerifyTimes(spec))
-                              .addStep<TimingObservation>(output,suiteTimings_, pathSetup);
+                              .addStep<TimingObservation>(output, *sysWatch, suiteTimings_, pathSetup
+                                                         ,spec.at(KEY_Test_subj), "scene");
 
         auto timeTrend   = optionally(shallVerifyTimes(spec))
                               .addStep<TimingJudgement>(*timings,suiteTimings_, shallCalibrateTiming_);
@@ -144,18 +649,162 @@ class ExeCliMould
                            optionally(shallVerifyTimes(spec))
                               .addStep<PersistTimings>(shallRecordBaseline_, *timings, *timeTrend);
 
+        // differential runs: repeat the test with one component disabled
+        std::vector<SceneCost::Variant> variants;
+        for (auto& [label, modification] : variantSpecs)
+        {
+            auto& variantScript   = addStep<PrepareTestScript>(sceneScript(spec, modification)
+                                                              ,false
+                                                              ,pathSetup);
+            auto variantSandbox   = optionally(bool(sandbox_))
+                                       .addStep<SandboxReset>(sandbox_);
+            auto& variantLauncher = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                                        ,spec.at(KEY_Test_topic)+" ~ "+label
+                                                        ,spec.at(KEY_cliTimeout)
+                                                        ,spec.at(KEY_failPattern)
+                                                        ,spec.at(KEY_Test_args)
+                                                        ,progressLog_
+                                                        ,variantScript
+                                                        ,Environments{variantSandbox});
+            auto& variantWatch    = addStep<SystemWatch>(progressLog_);
+            auto& variantRun      = addStep<Invocation>(variantLauncher,progressLog_);
+            auto& variantOutput   = addStep<OutputObservation>(variantRun);
+                                    addStep<CleanUp>(variantLauncher
+                                                    ,std::nullopt
+                                                    ,variantWatch
+                                                    ,progressLog_);
+            variants.push_back({label, &variantOutput, &variantWatch});
+        }
+                           optionally(not variants.empty())
+                              .addStep<SceneCost>(pathSetup, output, sysWatch, move(variants)
+                                                 ,progressLog_, suiteTimings_, spec.at(KEY_Test_subj));
+
         /*mark result*/    addStep<Summary>(spec.at(KEY_Test_topic)
                                            ,invocation
                                            ,baseline
                                            ,timeTrend);
                            addStep<CleanUp>(launcher
                                            ,soundProbe
+                                           ,sysWatch
                                            ,progressLog_);
     }
 };
 
 
 
+/**
+ * Specialised concrete Mould to build a test case which runs an arbitrary
+ * command as benchmark and extracts one or several metrics from its output.
+ * Each metric is observed, judged and persisted as a separate time series.
+ * @remark always performed locally, since the command is not Yoshimi.
+ */
+class BenchMould
+    : public WiringMould
+{
+    void materialise(MapS const& spec)  override
+    {
+        if (not util::contains(spec, KEY_Bench_command))
+            throw error::Misconfig("Test.type="+TYPE_BENCH+" requires a "+KEY_Bench_command+" to run.");
+        MetricDefs metricDefs = benchMetrics(spec);
+
+        auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
+                                             ,spec.at(KEY_Test_topic));
+
+        auto& launcher   = addStep<CommandLauncher>(spec.at(KEY_Test_topic)
+                                                   ,spec.at(KEY_cliTimeout)
+                                                   ,spec.at(KEY_Bench_command)
+                                                   ,progressLog_);
+        auto sysWatch    = optionally(shallVerifyTimes(spec))
+                              .addStep<SystemWatch>(progressLog_);
+        auto& invocation = addStep<Invocation>(launcher,progressLog_);
+
+        auto& bench      = addStep<BenchObservation>(invocation
+                                                    ,metricDefs
+                                                    ,spec.at(KEY_Bench_unit)
+                                                    ,util::parseAs<size_t>(spec.at(KEY_Bench_samples)));
+        BenchSummary::MetricJudgements judgements;
+        for (auto& metric : bench.metrics())
+        {
+            auto timings     = optionally(shallVerifyTimes(spec))
+                                  .addStep<TimingObservation>(metric, *sysWatch, suiteTimings_, pathSetup
+                                                             ,spec.at(KEY_Test_subj), TYPE_BENCH, metric.name);
+            auto timeTrend   = optionally(shallVerifyTimes(spec))
+                                  .addStep<TimingJudgement>(*timings,suiteTimings_, shallCalibrateTiming_);
+                               optionally(shallVerifyTimes(spec))
+                                  .addStep<PersistTimings>(shallRecordBaseline_, *timings, *timeTrend);
+            judgements.emplace_back(metric.name, timeTrend);
+        }
+
+        /*mark result*/    addStep<BenchSummary>(spec.at(KEY_Test_topic)
+                                                ,invocation
+                                                ,move(judgements));
+                           addStep<CleanUp>(launcher
+                                           ,std::nullopt
+                                           ,sysWatch
+                                           ,progressLog_);
+    }
+};
+
+
+/**
+ * Specialised concrete Mould to build a quality-versus-cost benchmark:
+ * the test script is rendered for each point of the declared grid of settings,
+ * and runtime and difference against the highest quality render are recorded.
+ * @remark always performed locally, since runtimes are compared with each other.
+ */
+class ParetoMould
+    : public WiringMould
+{
+    void materialise(MapS const& spec)  override
+    {
+        if (not definesTestScript(spec))
+            throw error::Misconfig("Test.type="+TYPE_PARETO+" requires a test Script.");
+        auto grid = paretoGrid(spec);
+
+        auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
+                                             ,spec.at(KEY_Test_topic));
+        ParetoPoints points;
+        Invocation* reference{nullptr};
+        for (auto& [label, settings] : grid)
+        {
+            bool isReference = points.empty();
+            auto& testScript = addStep<PrepareTestScript>(settings+"\n"+spec.at(KEY_Test_script)
+                                                         ,true
+                                                         ,pathSetup);
+            auto sandbox     = optionally(bool(sandbox_))
+                                  .addStep<SandboxReset>(sandbox_);
+            auto& launcher   = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                                   ,spec.at(KEY_Test_topic)+" ~ "+label
+                                                   ,spec.at(KEY_cliTimeout)
+                                                   ,spec.at(KEY_failPattern)
+                                                   ,spec.at(KEY_Test_args)
+                                                   ,progressLog_
+                                                   ,testScript
+                                                   ,Environments{sandbox});
+            auto& invocation = addStep<Invocation>(launcher,progressLog_);
+            auto& output     = addStep<OutputObservation>(invocation);
+            auto& soundProbe = addStep<SoundObservation>(output, pathSetup);
+            auto& point      = addStep<ParetoPoint>(label, isReference, output, soundProbe, pathSetup);
+                               addStep<CleanUp>(launcher
+                                               ,soundProbe
+                                               ,std::nullopt
+                                               ,progressLog_);
+            points.emplace_back(point);
+            if (isReference)
+                reference = &invocation;
+        }
+        auto& frontier   = addStep<ParetoFrontier>(points, pathSetup, progressLog_, suiteTimings_
+                                                    ,spec.at(KEY_Test_subj));
+
+        /*mark result*/    addStep<ParetoSummary>(spec.at(KEY_Test_topic)
+                                                 ,*reference
+                                                 ,points.front()
+                                                 ,frontier);
+    }
+};
+
+
+
 /**
  * Specialised concrete Mould to build a test case
  * by loading Yoshimi as a LV2 plugin and then feeding
@@ -174,6 +823,62 @@ class LV2PluginMould
 
 
 
+/**
+ * Specialised concrete Mould to perform a CLI test case within a worker process,
+ * on behalf of the coordinator. The worker relays the output and sound probe,
+ * while all further evaluation is wired at the coordinator (ExeCliMould).
+ */
+class WorkerMould
+    : public WiringMould
+{
+    void materialise(MapS const& spec)  override
+    {
+        auto& pathSetup  = addStep<PathSetup>(spec.at(KEY_workDir)
+                                             ,spec.at(KEY_Test_topic));
+
+        auto testScript  = optionally(definesTestScript(spec))
+                              .addStep<PrepareTestScript>(spec.at(KEY_Test_script)
+                                                         ,shallVerifySound(spec)
+                                                         ,pathSetup);
+
+        auto sandbox     = optionally(bool(sandbox_))
+                              .addStep<SandboxReset>(sandbox_);
+        auto& launcher   = addStep<ExeLauncher>(spec.at(KEY_Test_subj)
+                                               ,spec.at(KEY_Test_topic)
+                                               ,spec.at(KEY_cliTimeout)
+                                               ,spec.at(KEY_failPattern)
+                                               ,spec.at(KEY_Test_args)
+                                               ,progressLog_
+                                               ,testScript
+                                               ,Environments{sandbox});
+        auto sysWatch    = optionally(shallVerifyTimes(spec))
+                              .addStep<SystemWatch>(progressLog_);
+                           addStep<Invocation>(launcher,progressLog_);
+                           addStep<CleanUp>(launcher
+                                           ,std::nullopt
+                                           ,sysWatch
+                                           ,progressLog_);
+                           addStep<WorkerReport>(pathSetup, sysWatch, findings_);
+    }
+};
+
+
+
+/**
+ * Specialised concrete Mould to build the steps
+ * performed once at start, prior to all test cases.
+ */
+class PreludeMould
+    : public WiringMould
+{
+    void materialise(MapS const&)  override
+    {
+        addStep<JitterProbe>(progressLog_, suiteTimings_);
+    }
+};
+
+
+
 /**
  * Specialised concrete Mould to build the final steps
  * necessary to complete statistics and decide upon global
@@ -184,11 +889,19 @@ class ClosureMould
 {
     void materialise(MapS const& spec)  override
     {
+        addStep<TimingQuarantine>(progressLog_, suiteTimings_);
         optionally(shallCalibrateTiming_)
            .addStep<PlatformCalibration>(progressLog_, suiteTimings_);
         addStep<TrendObservation>(progressLog_, suiteTimings_);
         addStep<TrendJudgement>(suiteTimings_);
+        addStep<ClusterJudgement>(progressLog_, suiteTimings_);
+        optionally(not shallCalibrateTiming_)
+           .addStep<OnlineCalibration>(progressLog_, suiteTimings_);
         addStep<PersistModelTrend>(suiteTimings_, shallCalibrateTiming_);
+        optionally(bool(memo_))
+           .addStep<PersistMemo>(memo_, progressLog_);
+        optionally(bool(profileDiff_))
+           .addStep<PersistProfileDiff>(profileDiff_, progressLog_);
     }
 };
 
@@ -204,7 +917,13 @@ Mould& useMould_for(string testTypeID)
 {
     static ExeCliMould    testViaCli;
     static LV2PluginMould testViaLV2;
+    static PreludeMould   globalPrelude;
     static ClosureMould   globalClosure;
+    static WorkerMould    workerCase;
+    static LoadTimeMould  loadCorpus;
+    static SceneMould     testScene;
+    static BenchMould     benchmark;
+    static ParetoMould    paretoBench;
 
     if (def::TYPE_CLI == testTypeID)
         return testViaCli.startCycle();
@@ -212,8 +931,26 @@ Mould& useMould_for(string testTypeID)
     if (def::TYPE_LV2 == testTypeID)
         return testViaLV2.startCycle();
     else
+    if (def::TYPE_LOAD == testTypeID)
+        return loadCorpus.startCycle();
+    else
+    if (def::TYPE_SCENE == testTypeID)
+        return testScene.startCycle();
+    else
+    if (def::TYPE_BENCH == testTypeID)
+        return benchmark.startCycle();
+    else
+    if (def::TYPE_PARETO == testTypeID)
+        return paretoBench.startCycle();
+    else
+    if (def::PRELUDE  == testTypeID)
+        return globalPrelude.startCycle();
+    else
     if (def::CLOSURE  == testTypeID)
         return globalClosure.startCycle();
+    else
+    if (def::WORKER   == testTypeID)
+        return workerCase.startCycle();
     else
         throw error::Misconfig("Unknown Test.type='"+testTypeID+"' requested");
 }
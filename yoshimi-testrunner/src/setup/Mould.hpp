@@ -40,6 +40,10 @@
 #include "setup/Builder.hpp"
 #include "suite/Progress.hpp"
 #include "suite/Timings.hpp"
+#include "suite/Dispatcher.hpp"
+#include "suite/Memo.hpp"
+#include "suite/ProfileDiff.hpp"
+#include "suite/Sandbox.hpp"
 
 #include <functional>
 #include <memory>
@@ -53,6 +57,11 @@ using std::shared_ptr;
 using std::reference_wrapper;
 
 using suite::PTimings;
+using suite::PDispatcher;
+using suite::PMemo;
+using suite::PProfileDiff;
+using suite::PSandbox;
+using suite::PWorkerFindings;
 using suite::Progress;
 using RProgress = std::reference_wrapper<Progress>;
 
@@ -68,8 +77,16 @@ protected:
     StepSeq   steps_;
     RProgress progressLog_{Progress::null()};
     PTimings  suiteTimings_;
+    PDispatcher dispatcher_;
+    PMemo     memo_;
+    PProfileDiff profileDiff_;
+    PSandbox  sandbox_;
+    PWorkerFindings findings_;
     bool shallRecordBaseline_{false};
     bool shallCalibrateTiming_{false};
+    bool shallAuditRealtime_{false};
+    bool shallInstrument_{false};
+    string cacheMode_{def::CACHE_PLAIN};
 
 public:
     virtual ~Mould();  ///< this is an interface
@@ -85,6 +102,31 @@ public:
         suiteTimings_ = timingDataHolder;
         return *this;
     }
+    Mould& withDispatcher(PDispatcher remoteExecution)
+    {
+        dispatcher_ = remoteExecution;
+        return *this;
+    }
+    Mould& withMemo(PMemo verdictCache)
+    {
+        memo_ = verdictCache;
+        return *this;
+    }
+    Mould& withProfileDiff(PProfileDiff differentialProfile)
+    {
+        profileDiff_ = differentialProfile;
+        return *this;
+    }
+    Mould& withSandbox(PSandbox privateHome)
+    {
+        sandbox_ = privateHome;
+        return *this;
+    }
+    Mould& withFindings(PWorkerFindings workerReport)
+    {
+        findings_ = workerReport;
+        return *this;
+    }
     Mould& recordBaseline(bool indeed)
     {
         shallRecordBaseline_ = indeed;
@@ -95,6 +137,21 @@ public:
         shallCalibrateTiming_ = indeed;
         return *this;
     }
+    Mould& auditRealtime(bool indeed)
+    {
+        shallAuditRealtime_ = indeed;
+        return *this;
+    }
+    Mould& instrument(bool indeed)
+    {
+        shallInstrument_ = indeed;
+        return *this;
+    }
+    Mould& cacheMode(string mode)
+    {
+        cacheMode_ = mode;
+        return *this;
+    }
 
     /** prepare this Mould for the next generation cycle */
     virtual Mould& startCycle();
@@ -0,0 +1,109 @@
+/*
+ *  BuildInfo - identity and build profile of the test subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file BuildInfo.cpp
+ ** Implementation of subject build identification.
+ ** The version is retrieved by launching the subject with `--version` through the
+ ** shell, guarded by a timeout; since the result is stored into CSV files, any double
+ ** quotes are replaced. A subject which is not an ELF executable (e.g. a wrapper script)
+ ** yields only the version, with unknown profile.
+ **
+ */
+
+
+#include "util/error.hpp"
+#include "util/elf.hpp"
+#include "util/format.hpp"
+#include "suite/BuildInfo.hpp"
+
+#include <cstdio>
+#include <algorithm>
+
+using util::isnil;
+using util::readElfInfo;
+
+
+namespace suite {
+
+namespace {
+    const size_t BUILD_ID_LEN = 16;  // abbreviated hex digits
+    const string VERSION_QUERY_TIMEOUT{"10"};
+
+    /** make the value safe for storage into a CSV field */
+    string sanitise(string val)
+    {
+        std::replace(val.begin(), val.end(), '"', '\'');
+        while (not isnil(val) and isspace(val.back()))
+            val.pop_back();
+        return val;
+    }
+
+    string shellQuote(string const& arg)
+    {
+        return "'"+util::replace(arg, "'", "'\\''")+"'";
+    }
+
+    string queryVersion(fs::path subject)
+    {
+        string cmd = "timeout "+VERSION_QUERY_TIMEOUT+" "+shellQuote(subject.string())+" --version </dev/null 2>&1";
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (not pipe) return "";
+        char buffer[256];
+        string version;
+        while (isnil(version) and fgets(buffer, sizeof(buffer), pipe))
+            version = sanitise(buffer);
+        while (fgets(buffer, sizeof(buffer), pipe))
+            {/* drain remaining output */}
+        pclose(pipe);
+        return version;
+    }
+}
+
+
+const string BuildInfo::UNKNOWN{"?"};
+
+
+BuildInfo BuildInfo::inspect(fs::path subject)
+{
+    BuildInfo build;
+    if (not fs::exists(subject))
+        return build;
+    auto elf = readElfInfo(fs::consolidated(subject));
+    build.version   = queryVersion(subject);
+    build.buildID   = elf.buildID.substr(0, BUILD_ID_LEN);
+    build.compiler  = sanitise(elf.compiler);
+    build.debugInfo = elf.debugInfo;
+    if (not isnil(elf.optLevel))
+        build.profile = elf.optLevel;
+    return build;
+}
+
+
+string BuildInfo::describe()  const
+{
+    return (isnil(version)? string{"(version unknown)"} : version)
+         + " build-id:" + (isnil(buildID)? UNKNOWN : buildID)
+         + " profile:"  + profile
+         + (debugInfo? " +debug-info" : "")
+         + (isnil(compiler)? "" : " ("+compiler+")");
+}
+
+
+}//(End)namespace suite
@@ -0,0 +1,80 @@
+/*
+ *  BuildInfo - identity and build profile of the test subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file BuildInfo.hpp
+ ** Identify the build of the subject, to attribute timing measurements.
+ ** When run times shift, the first question is which build of Yoshimi produced them;
+ ** moreover, an accidental debug build runs several times slower and would silently
+ ** spoil the platform model and all trends. Thus every timing measurement records
+ ** the GNU build-id and a _build profile,_ which is the optimisation level as far as
+ ** it can be determined from the executable. The `--version` output of the subject
+ ** and the compiler are recorded alongside in the global statistics.
+ ** \par Comparable measurements
+ ** Only measurements taken with the same build profile are combined into averages,
+ ** tolerance bands and trends, while successive builds with the same profile are
+ ** deliberately compared, since detecting changes between builds is the very purpose.
+ ** An unknown profile (empty or "?") is considered comparable to any other.
+ **
+ ** @see util::readElfInfo()
+ ** @see Timings.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_BUILD_INFO_HPP_
+#define TESTRUNNER_SUITE_BUILD_INFO_HPP_
+
+
+#include "util/file.hpp"
+#include "util/utils.hpp"
+
+#include <string>
+
+namespace suite {
+
+using std::string;
+
+
+struct BuildInfo
+{
+    string version;     ///< first line of `subject --version`
+    string buildID;     ///< GNU build-id (hex), abbreviated
+    string compiler;    ///< compiler as recorded in the executable
+    string profile{UNKNOWN};
+    bool debugInfo{false};
+
+    static const string UNKNOWN;
+
+    /** retrieve build identity from the given executable */
+    static BuildInfo inspect(fs::path subject);
+
+    string describe()  const;
+
+    static bool isComparable(string const& profile1, string const& profile2)
+    {
+        return util::isnil(profile1) or profile1 == UNKNOWN
+            or util::isnil(profile2) or profile2 == UNKNOWN
+            or profile1 == profile2;
+    }
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_BUILD_INFO_HPP_*/
@@ -0,0 +1,238 @@
+/*
+ *  Dispatcher - hand out test cases to remote worker processes
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Dispatcher.cpp
+ ** Implementation of the coordinator side of the worker protocol.
+ ** Test cases are enqueued in suite order while building the Testsuite; dispatching
+ ** starts as soon as the first worker connects. Since the Stage performs the test
+ ** steps strictly in sequence, results are consumed in suite order, while the
+ ** workers run ahead and compute further cases in parallel.
+ **
+ */
+
+
+#include "suite/Dispatcher.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+
+#include <sstream>
+#include <chrono>
+
+using util::isnil;
+using util::formatVal;
+using util::startsWith;
+using util::Connection;
+using util::PConnection;
+
+
+namespace suite {
+
+namespace {
+    const int ACCEPT_POLL_ms   = 500;
+    const int HELLO_TIMEOUT_ms = 5000;
+    const int SILENCE_LIMIT_ms = 30000;  // worker sends heartbeat every 5s
+    const uint MAX_ATTEMPTS    = 3;
+
+    /** strip a protocol keyword and the following space */
+    string payload(string const& line, string const& keyword)
+    {
+        return line.length() > keyword.length()? line.substr(keyword.length()+1) : "";
+    }
+}
+
+
+
+PDispatcher Dispatcher::setup(Config const& config)
+{
+    if (isnil(config.coordinator))
+        return nullptr;
+    config.progress->note("Coordinator: awaiting workers at "+formatVal(config.coordinator));
+    return PDispatcher{new Dispatcher{config.coordinator}};
+}
+
+
+Dispatcher::Dispatcher(string address)
+    : listener_{address}
+{
+    acceptor_ = std::thread([this]{ acceptWorkers(); });
+}
+
+
+/** @remark idle workers receive `QUIT` when the queue is closed */
+Dispatcher::~Dispatcher()
+{
+    {   // set under the lock, so a worker can not miss the wakeup between predicate check and wait
+        std::lock_guard<std::mutex> guard{lock_};
+        closing_ = true;
+    }
+    change_.notify_all();
+    if (acceptor_.joinable())
+        acceptor_.join();
+    for (auto& handler : handlers_)
+        if (handler.joinable())
+            handler.join();
+}
+
+
+std::future<RemoteOutcome> Dispatcher::enqueue(string topic)
+{
+    std::lock_guard<std::mutex> guard{lock_};
+    PJob job{new Job{++jobCnt_, topic}};
+    auto future = job->outcome.get_future();
+    queue_.push_back(job);
+    change_.notify_one();
+    return future;
+}
+
+
+void Dispatcher::acceptWorkers()
+{
+    while (not closing_)
+    try {
+        PConnection conn = listener_.accept(ACCEPT_POLL_ms);
+        if (not conn) continue;
+        auto hello = conn->readLine(HELLO_TIMEOUT_ms);
+        if (not hello or not startsWith(*hello, "HELLO"))
+            continue; // not a worker; discard connection
+        handlers_.emplace_back(&Dispatcher::serveWorker, this
+                              ,move(conn), payload(*hello, "HELLO"));
+    }
+    catch(std::exception& ex)
+    {
+        notice("failure accepting worker: "+string{ex.what()});
+    }
+}
+
+
+/** @remark runs in a dedicated thread for each connected worker */
+void Dispatcher::serveWorker(PConnection conn, string workerID)
+{
+    ++connected_;
+    notice("worker "+workerID+" connected.");
+    while (PJob job = nextJob())
+        try {
+            job->outcome.set_value(runJob(*conn, *job, workerID));
+        }
+        catch(std::exception& ex)
+        {
+            --connected_;
+            requeue(job, "worker "+workerID+" lost: "+ex.what());
+            return;
+        }
+    try {
+        conn->sendLine("QUIT");
+    }
+    catch(...) { /* worker gone already */ }
+    --connected_;
+}
+
+
+/** @return next job to dispatch, or `nullptr` when closing down */
+Dispatcher::PJob Dispatcher::nextJob()
+{
+    std::unique_lock<std::mutex> guard{lock_};
+    change_.wait(guard, [this]{ return closing_ or not queue_.empty(); });
+    if (closing_ or queue_.empty())
+        return nullptr;
+    PJob job = queue_.front();
+    queue_.pop_front();
+    return job;
+}
+
+
+/** put a job back at the front, unless it failed repeatedly */
+void Dispatcher::requeue(PJob job, string reason)
+{
+    notice(reason);
+    if (MAX_ATTEMPTS <= ++job->attempts)
+    {
+        RemoteOutcome failure;
+        failure.summary = "Test case "+formatVal(job->topic)+" failed on "
+                        + formatVal(job->attempts)+" workers. Last: "+reason;
+        job->outcome.set_value(move(failure));
+        return;
+    }
+    std::lock_guard<std::mutex> guard{lock_};
+    notices_.emplace_back("re-dispatch "+formatVal(job->topic));
+    queue_.push_front(job);
+    change_.notify_one();
+}
+
+
+void Dispatcher::notice(string msg)
+{
+    std::lock_guard<std::mutex> guard{lock_};
+    notices_.emplace_back(move(msg));
+}
+
+
+void Dispatcher::relayNotices(Progress& progressLog)
+{
+    std::vector<string> pending;
+    {
+        std::lock_guard<std::mutex> guard{lock_};
+        swap(pending, notices_);
+    }
+    for (string const& msg : pending)
+        progressLog.note("Coordinator: "+msg);
+}
+
+
+/**
+ * Send a single test case to a worker and collect the response.
+ * @throw error::State when the worker vanished or fell silent
+ */
+RemoteOutcome Dispatcher::runJob(Connection& conn, Job const& job, string workerID)
+{
+    RemoteOutcome outcome;
+    outcome.worker = workerID;
+    conn.sendLine("RUN "+formatVal(job.id)+" "+job.topic);
+    while (true)
+    {
+        auto line = conn.readLine(SILENCE_LIMIT_ms);
+        if (not line)
+            throw error::State("no sign of life for "+formatVal(SILENCE_LIMIT_ms/1000)+"s");
+        if (startsWith(*line, "OUT"))
+            outcome.output.emplace_back(false, payload(*line, "OUT"));
+        else
+        if (startsWith(*line, "ERR"))
+            outcome.output.emplace_back(true, payload(*line, "ERR"));
+        else
+        if (startsWith(*line, "PROBE"))
+            outcome.probe = conn.readBytes(util::parseAs<size_t>(payload(*line, "PROBE")), SILENCE_LIMIT_ms);
+        else
+        if (startsWith(*line, "DONE"))
+        {
+            std::istringstream response{payload(*line, "DONE")};
+            uint jobID; int code; double contamination;
+            response >> jobID >> code >> contamination >> std::ws;
+            if (not response or jobID != job.id)
+                throw error::State("protocol mismatch; expected job "+formatVal(job.id));
+            outcome.code = ResCode(code);
+            outcome.contamination = contamination;
+            std::getline(response, outcome.summary);
+            return outcome;
+        }
+        // ignore ALIVE and unknown lines
+    }
+}
+
+
+}//(End)namespace suite
@@ -0,0 +1,152 @@
+/*
+ *  Dispatcher - hand out test cases to remote worker processes
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Dispatcher.hpp
+ ** Coordinator side of distributed test execution.
+ ** When launched with `--coordinator=<address>`, the testrunner still builds and owns
+ ** the complete Testsuite, yet the actual invocation of Yoshimi is delegated to worker
+ ** processes (`testrunner --worker=<address>`), which connect to the coordinator socket
+ ** and run the test against their local subject. Workers pull the next test case on
+ ** demand, so that no worker sits idle while cases remain; the captured output and
+ ** the raw sound probe are sent back, and all observation, judgement, statistics and
+ ** reporting happens centrally, as if the test had been invoked locally.
+ **
+ ** # Protocol
+ ** Line based plain text over a stream socket (Unix domain or TCP)
+ ** - worker → `HELLO <id>` on connect
+ ** - coordinator → `RUN <job> <topic>` ; `QUIT` when the suite is complete
+ ** - worker → `OUT <line>` / `ERR <line>` relaying the subject's output
+ ** - worker → `ALIVE` heartbeat while the test is running
+ ** - worker → `PROBE <bytes>` followed by the raw sound probe data
+ ** - worker → `DONE <job> <code> <contamination> <summary>` to conclude the test case;
+ **   the contamination score is sampled on the worker while the subject is running
+ ** A worker falling silent or dropping the connection is considered lost;
+ ** its current case is then re-dispatched to another worker.
+ **
+ ** @see suite::step::RemoteLauncher
+ ** @see Worker.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_DISPATCHER_HPP_
+#define TESTRUNNER_SUITE_DISPATCHER_HPP_
+
+
+#include "Config.hpp"
+#include "util/nocopy.hpp"
+#include "util/socket.hpp"
+#include "suite/Result.hpp"
+#include "suite/Progress.hpp"
+
+#include <condition_variable>
+#include <utility>
+#include <future>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+
+namespace suite {
+
+class Dispatcher;
+using PDispatcher = std::shared_ptr<Dispatcher>;
+
+
+/** Outcome of a test case performed by a remote worker */
+struct RemoteOutcome
+{
+    ResCode code{ResCode::MALFUNCTION};
+    string summary;
+    string worker;
+    std::vector<std::pair<bool,string>> output; ///< (isError,line)
+    string probe;                               ///< raw sound probe data
+    double contamination{0.0};                  ///< system load score sampled by the worker
+};
+
+
+/** Findings of a worker while performing a test case, to be sent to the coordinator */
+struct WorkerFindings
+{
+    fs::path probe;                             ///< sound probe file configured for this case
+    double contamination{0.0};                  ///< worst system load score while the subject was running
+};
+using PWorkerFindings = std::shared_ptr<WorkerFindings>;
+
+
+/**
+ * Queue of test cases to perform, served to workers on demand.
+ * Each connected worker is handled by a dedicated thread.
+ */
+class Dispatcher
+    : util::NonCopyable
+{
+    struct Job
+    {
+        uint id;
+        string topic;
+        uint attempts{0};
+        std::promise<RemoteOutcome> outcome{};
+    };
+    using PJob = std::shared_ptr<Job>;
+
+    util::Listener listener_;
+
+    std::mutex lock_;
+    std::condition_variable change_;
+    std::deque<PJob> queue_;
+    std::vector<string> notices_;
+    uint jobCnt_{0};
+    std::atomic<uint> connected_{0};
+    std::atomic<bool> closing_{false};
+
+    std::vector<std::thread> handlers_;
+    std::thread acceptor_;
+
+public:
+    Dispatcher(string address);
+   ~Dispatcher();
+
+    /** @return a Dispatcher when configured as coordinator, else `nullptr` */
+    static PDispatcher setup(Config const&);
+
+    std::future<RemoteOutcome> enqueue(string topic);
+    uint workerCnt()  const { return connected_; }
+
+    /** pass on messages from the worker handler threads
+     * @remark must be called from the thread performing the Testsuite,
+     *         since Progress implementations are not threadsafe */
+    void relayNotices(Progress&);
+
+private:
+    void acceptWorkers();
+    void serveWorker(util::PConnection, string workerID);
+    PJob nextJob();
+    void requeue(PJob, string reason);
+    void notice(string msg);
+    RemoteOutcome runJob(util::Connection&, Job const&, string workerID);
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_DISPATCHER_HPP_*/
@@ -0,0 +1,146 @@
+/*
+ *  ExpensePredictor - provisional baseline for new timing tests from similar cases
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ExpensePredictor.cpp
+ ** Implementation of the expense prediction for new test cases.
+ ** Peers are selected in stages of decreasing similarity: same directory and engine,
+ ** same directory, same engine, and finally the whole Testsuite; the first stage with
+ ** enough cases is used. The predicted expense factor is the geometric mean of the peers,
+ ** and the standard deviation of their logarithms gives the relative uncertainty of this
+ ** guess. The tolerance expected for the predicted runtime is taken from a power law fitted
+ ** over all cases (linear regression in log-log scale), since the fluctuations typically
+ ** grow less than proportional with the runtime.
+ **
+ */
+
+
+#include "Config.hpp"
+#include "suite/ExpensePredictor.hpp"
+#include "suite/TimingTables.hpp"
+#include "util/statistic.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+
+#include <functional>
+#include <cmath>
+
+using util::isnil;
+using util::contains;
+using util::endsWith;
+using util::formatVal;
+
+
+namespace suite {
+
+namespace {
+    const size_t MIN_PEERS = 2;        // for a peer group restricted by directory or engine
+    const size_t MIN_FIT_POINTS = 5;   // to fit the fluctuation model
+}
+
+
+ExpensePredictor::ExpensePredictor(fs::path suiteRoot, std::set<string> const& excludedCases)
+{
+    const string RUNTIME_SUFFIX = "-"+def::TIMING_RUNTIME_MARK+def::EXT_DATA_CSV;
+
+    std::error_code noThrow;
+    for (auto& entry : fs::recursive_directory_iterator(suiteRoot, noThrow))
+    {
+        string name = entry.path().filename().string();
+        if (not entry.is_regular_file() or not endsWith(name, RUNTIME_SUFFIX))
+            continue;
+        fs::path dir = fs::relative(entry.path().parent_path(), suiteRoot);
+        string testID = name.substr(0, name.length() - RUNTIME_SUFFIX.length());
+        if (contains(excludedCases, (dir / testID).string()))
+            continue;
+        if (not fs::exists(entry.path().parent_path() / (testID+def::TESTSPEC_FILE_EXTENSION)))
+            continue;   // runtime table of a benchmark metric, not of a platform reference test case
+        try {
+            RuntimeData runtime{entry.path()};
+            if (isnil(runtime)) continue;
+            Peer peer{dir, runtime.engine, runtime.expense, runtime.runtime, runtime.tolerance};
+            if (0.0 < peer.expense and 0.0 < peer.runtime and 0.0 < peer.tolerance)
+                peers_.push_back(peer);
+        }
+        catch(error::Invalid&)
+        {/* ignore unreadable tables; they will be reported by their own test case */}
+    }
+
+    if (peers_.size() < MIN_FIT_POINTS)
+        return;
+    util::RegressionData points;
+    points.reserve(peers_.size());
+    for (Peer const& peer : peers_)
+        points.emplace_back(util::RegressionPoint{log(peer.runtime), log(peer.tolerance), 1.0});
+    auto [socket,gradient, _p_,_d_,_c_,_m_,_s_] = util::computeLinearRegression(points);
+    if (std::isfinite(socket) and std::isfinite(gradient))
+    {
+        tolSocket_ = socket;
+        tolGradient_ = gradient;
+        tolFitted_ = true;
+    }
+}
+
+
+std::optional<ExpensePredictor::Prediction> ExpensePredictor::predict(fs::path topic, string engine, double platform)  const
+{
+    if (isnil(peers_) or platform <= 0.0)
+        return std::nullopt;
+
+    fs::path dir = topic.parent_path();
+    using Filter = std::function<bool(Peer const&)>;
+    struct Stage { Filter accept; string basis; size_t minPeers; };
+    Stage stages[] = {{[&](Peer const& p){ return p.dir == dir and p.engine == engine; }
+                      ,dir.string()+"/ ("+engine+")", MIN_PEERS}
+                     ,{[&](Peer const& p){ return p.dir == dir; }
+                      ,dir.string()+"/", MIN_PEERS}
+                     ,{[&](Peer const& p){ return not isnil(engine) and p.engine == engine; }
+                      ,"engine "+engine, MIN_PEERS}
+                     ,{[&](Peer const&)  { return true; }
+                      ,"whole Testsuite", 1}
+                     };
+    for (Stage const& stage : stages)
+    {
+        std::vector<double> logExpense;
+        std::vector<double> relTolerance;
+        for (Peer const& peer : peers_)
+            if (stage.accept(peer))
+            {
+                logExpense.push_back(log(peer.expense));
+                relTolerance.push_back(peer.tolerance / peer.runtime);
+            }
+        if (logExpense.size() < stage.minPeers)
+            continue;
+
+        double meanLog = util::average(logExpense);
+        double spread  = logExpense.size() < 2? 0.0 : util::sdev(logExpense, meanLog);
+        double expense = exp(meanLog);
+        double runtime = platform * expense;
+        double fluctuation = tolFitted_? exp(tolSocket_ + tolGradient_ * log(runtime))
+                                       : util::average(relTolerance) * runtime;
+        // the uncertainty of the guessed expense widens the band: ±3σ of the peers
+        double tolerance = util::errorSum(fluctuation, 3 * spread * runtime);
+        return Prediction{expense, tolerance, logExpense.size(), stage.basis};
+    }
+    return std::nullopt;
+}
+
+
+}//(End)namespace suite
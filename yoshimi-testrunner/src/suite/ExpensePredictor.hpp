@@ -0,0 +1,99 @@
+/*
+ *  ExpensePredictor - provisional baseline for new timing tests from similar cases
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ExpensePredictor.hpp
+ ** Estimate expense factor and tolerance band for a timing test without baseline.
+ ** A newly added test case has no expense factor and no history of fluctuations, and thus
+ ** could not be judged until a baseline is captured. However, similar test cases tend to
+ ** have similar expense: the peers within the same topic directory, preferably using the
+ ** same synth engine(s), are used to predict an initial expense factor. The tolerance is
+ ** predicted from a model of fluctuations versus runtime, fitted over the whole Testsuite,
+ ** combined with the spread of the expense factors among the peers.
+ ** 
+ ** The current state of the peers is taken from their stored runtime tables, which are
+ ** loaded once, on first demand. Quarantined cases are not used, since their fluctuations
+ ** are not representative.
+ **
+ ** @see TimingObservation.cpp usage
+ ** @see Timings::predictExpense()
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_EXPENSE_PREDICTOR_HPP_
+#define TESTRUNNER_SUITE_EXPENSE_PREDICTOR_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+#include <set>
+
+
+namespace suite {
+
+using std::string;
+
+
+/**
+ * Prediction of the expected expense for a timing test case from similar cases.
+ * @remark expense factors are compared in logarithmic scale, since these are ratios
+ */
+class ExpensePredictor
+    : util::NonCopyable
+{
+    struct Peer
+    {
+        fs::path dir;       ///< topic directory, relative to the Testsuite root
+        string engine;
+        double expense;     ///< baseline expense factor
+        double runtime;     ///< latest runtime in ms
+        double tolerance;   ///< latest tolerance band (3·σ) in ms
+    };
+    std::vector<Peer> peers_;
+
+    double tolSocket_{0.0};   ///< fluctuation model: ln(tolerance) = socket + gradient · ln(runtime)
+    double tolGradient_{1.0};
+    bool   tolFitted_{false};
+
+public:
+    ExpensePredictor(fs::path suiteRoot, std::set<string> const& excludedCases);
+
+    struct Prediction
+    {
+        double expense;     ///< expense factor estimated from the peers
+        double tolerance;   ///< tolerance band (~3·σ) in ms at the predicted runtime
+        size_t peers;       ///< number of similar cases used
+        string basis;       ///< description of the peer group
+    };
+
+    /** @param platform runtime predicted by the platform model (in ms) */
+    std::optional<Prediction> predict(fs::path topic, string engine, double platform)  const;
+
+    size_t cntPeers()  const { return peers_.size(); }
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_EXPENSE_PREDICTOR_HPP_*/
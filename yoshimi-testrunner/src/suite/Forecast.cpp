@@ -0,0 +1,160 @@
+/*
+ *  Forecast - estimate remaining Testsuite runtime from historical durations
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Forecast.cpp
+ ** Implementation of the runtime forecast.
+ ** Durations are smoothed as exponential moving average, to level out the
+ ** fluctuations of individual runs, while still adapting to a changed platform.
+ ** The table is rewritten completely at the end of each Testsuite run; entries for
+ ** test cases not performed in this run (e.g. due to a filter) are carried over.
+ **
+ */
+
+
+#include "Config.hpp"
+#include "suite/Forecast.hpp"
+#include "util/format.hpp"
+#include "util/data.hpp"
+
+#include <cmath>
+
+using util::Column;
+using util::DataFile;
+using util::formatVal;
+
+
+namespace suite {
+
+namespace {
+    const double SMOOTHING = 0.3;  // weight of the newest observation
+
+    struct TableDurations
+    {
+        Column<string>      topic{"Topic"};                ///< test case, relative to the Testsuite root
+        Column<double>   duration{"Duration s"};           ///< wall clock time spent for this test case (smoothed)
+
+        auto allColumns()
+        {   return std::tie(topic
+                           ,duration
+                           );
+        }
+    };
+
+    /** render seconds as `1h02m03s` */
+    string formatSpan(double secs)
+    {
+        long total = std::lround(secs);
+        long h = total / 3600;
+        long m = total / 60 % 60;
+        long s = total % 60;
+        auto twoDigits = [](long n){ return (n<10? "0":"")+util::str(n); };
+        return (0<h? formatVal(h)+"h"+twoDigits(m)+"m"
+                   : formatVal(m)+"m")
+             + twoDigits(s)+"s";
+    }
+}
+
+class DurationData
+    : public DataFile<TableDurations>
+{
+public:
+    using DataFile::DataFile;
+};
+
+
+
+Forecast::~Forecast() { }
+
+Forecast::Forecast(fs::path suiteRoot, std::vector<fs::path> plannedTopics)
+    : data_{new DurationData{suiteRoot / (def::SUITE_DURATIONS + def::EXT_DATA_CSV)}}
+    , known_{}
+    , planned_{move(plannedTopics)}
+    , suiteStart_{Clock::now()}
+    , caseStart_{suiteStart_}
+{
+    for (size_t row=0; row < data_->size(); ++row)
+        known_[data_->topic.data[row]] = data_->duration.data[row];
+}
+
+
+void Forecast::caseDone(fs::path topic, bool skipped)
+{
+    auto now = Clock::now();
+    double secs = std::chrono::duration<double>(now - caseStart_).count();
+    caseStart_ = now;
+    ++done_;
+    if (skipped)
+        return;
+    ++measured_;
+    spent_ += secs;
+
+    auto entry = known_.find(topic.string());
+    if (entry == known_.end())
+        known_[topic.string()] = secs;
+    else
+        entry->second = SMOOTHING * secs + (1-SMOOTHING) * entry->second;
+}
+
+
+/** @remark cases without history are assumed to take the average time of this run */
+std::optional<double> Forecast::remaining()  const
+{
+    double avg = 0 < measured_? spent_ / measured_ : 0.0;
+    double eta = 0.0;
+    for (size_t i=done_; i < planned_.size(); ++i)
+    {
+        auto entry = known_.find(planned_[i].string());
+        if (entry != known_.end())
+            eta += entry->second;
+        else
+        if (0 < measured_)
+            eta += avg;
+        else
+            return std::nullopt;
+    }
+    return eta;
+}
+
+
+string Forecast::describe()  const
+{
+    auto eta = remaining();
+    double elapsed = std::chrono::duration<double>(Clock::now() - suiteStart_).count();
+    return "["+formatVal(done_)+"/"+formatVal(planned_.size())+"] "
+         + "elapsed "+formatSpan(elapsed)
+         + ", ETA "+(eta? formatSpan(*eta) : string{"?"});
+}
+
+
+void Forecast::save()
+{
+    data_->topic.data.clear();
+    data_->duration.data.clear();
+    for (auto& [topic,secs] : known_)
+    {
+        data_->newRow();
+        data_->topic = topic;
+        data_->duration = secs;
+    }
+    data_->save();
+}
+
+
+}//(End)namespace suite
@@ -0,0 +1,99 @@
+/*
+ *  Forecast - estimate remaining Testsuite runtime from historical durations
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Forecast.hpp
+ ** Anticipate the remaining time for a running Testsuite.
+ ** Running the complete Testsuite can take hours, and thus it is helpful to indicate
+ ** an _estimated time of arrival_ while the tests are underway. The wall clock time
+ ** spent for each test case is retained persistently in `Suite-durations.csv` within
+ ** the Testsuite root; the ETA is then the sum of the known durations for all cases
+ ** still pending. Test cases not yet recorded are assumed to take the average time
+ ** of the cases performed thus far.
+ **
+ ** @see Report.hpp usage
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_FORECAST_HPP_
+#define TESTRUNNER_SUITE_FORECAST_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+
+#include <optional>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+
+
+namespace suite {
+
+using std::string;
+
+class DurationData;
+
+
+/**
+ * Progress tracker to estimate the remaining runtime of the Testsuite,
+ * based on the wall clock time observed for each test case in past runs.
+ */
+class Forecast
+    : util::NonCopyable
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<DurationData> data_;
+    std::map<string, double> known_;   ///< topic → duration in seconds (smoothed)
+    std::vector<fs::path> planned_;
+    size_t done_{0};
+    size_t measured_{0};
+    double spent_{0.0};                ///< time spent in measured cases (basis of the average)
+    Clock::time_point suiteStart_;
+    Clock::time_point caseStart_;
+
+public:
+    Forecast(fs::path suiteRoot, std::vector<fs::path> plannedTopics);
+   ~Forecast();
+
+    /** mark completion of the current test case, and start timing the next one
+     * @param skipped the case was not actually performed (e.g. memoised verdict);
+     *        its duration is then not representative and must not enter the estimates */
+    void caseDone(fs::path topic, bool skipped =false);
+
+    size_t cntDone()    const { return done_; }
+    size_t cntPlanned() const { return planned_.size(); }
+
+    /** @return estimated time in seconds still required for the pending cases */
+    std::optional<double> remaining()  const;
+
+    /** @return indicator line with count of cases, wall clock time since start and ETA */
+    string describe()  const;
+
+    /** persist the observed durations for the next run */
+    void save();
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_FORECAST_HPP_*/
@@ -0,0 +1,219 @@
+/*
+ *  Memo - reuse verdicts of sound verification when no input has changed
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Memo.cpp
+ ** Implementation of the verdict cache.
+ ** Keys are built with the 64bit FNV-1a hash; this is no cryptographic hash, but entirely
+ ** sufficient to detect changes of the inputs. The subject is the executable given in the
+ ** spec of each test case; when it carries no GNU build-id, the content of the executable
+ ** is hashed instead, once per run. Like the Forecast, the table is
+ ** rewritten at the end of each run, carrying over the entries of cases not performed.
+ **
+ */
+
+
+#include "suite/Memo.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+#include "util/data.hpp"
+#include "util/elf.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using util::Column;
+using util::DataFile;
+using util::formatVal;
+using util::isnil;
+
+
+namespace suite {
+
+namespace {
+    const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    const uint64_t FNV_PRIME  = 0x100000001b3ULL;
+    const size_t   READ_CHUNK = 64*1024;
+
+    struct TableMemo
+    {
+        Column<string>      topic{"Topic"};                ///< test case, relative to the Testsuite root
+        Column<string>        key{"Key"};                  ///< hash of subject build, spec, initial state and baseline
+        Column<string>    verdict{"Verdict"};              ///< summary of the green run
+        Column<string>  timestamp{"Timestamp"};            ///< the Testsuite run which established this verdict
+
+        auto allColumns()
+        {   return std::tie(topic
+                           ,key
+                           ,verdict
+                           ,timestamp
+                           );
+        }
+    };
+
+    uint64_t fnvHash(string const& text, uint64_t hash =FNV_OFFSET)
+    {
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /** @return hash of the file contents, or a marker if the file does not exist */
+    string hashFile(fs::path file)
+    {
+        std::ifstream in{file, std::ios::binary};
+        if (not in.good())
+            return "none";
+        uint64_t hash = FNV_OFFSET;
+        string chunk(READ_CHUNK, '\0');
+        while (in.read(&chunk[0], READ_CHUNK) or in.gcount())
+            hash = fnvHash(chunk.substr(0, size_t(in.gcount())), hash);
+        std::ostringstream hex;
+        hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return hex.str();
+    }
+
+    /** locate the baseline WAV like PathSetup does, but relative to the test directory */
+    fs::path baselineFile(MapS const& spec)
+    {
+        fs::path workDir = spec.at(def::KEY_workDir);
+        fs::path file = workDir / (def::SOUND_BASELINE_MARK + def::EXT_SOUND_WAV);
+        if (not fs::exists(file))
+        {
+            string testcaseID = fs::path(spec.at(def::KEY_Test_topic)).stem();
+            file = workDir / (testcaseID+"-"+def::SOUND_BASELINE_MARK + def::EXT_SOUND_WAV);
+        }
+        if (not fs::exists(file))
+            for (string const& alternative : {def::EXT_SOUND_RF64, def::EXT_SOUND_W64})
+                if (fs::exists(fs::path{file}.replace_extension(alternative)))
+                    return file.replace_extension(alternative);
+        return file;
+    }
+}
+
+class MemoData
+    : public DataFile<TableMemo>
+{
+public:
+    using DataFile::DataFile;
+};
+
+
+
+Memo::~Memo() { }
+
+Memo::Memo(fs::path suiteRoot)
+    : data_{new MemoData{suiteRoot / (def::SUITE_MEMO + def::EXT_DATA_CSV)}}
+    , known_{}
+{
+    for (size_t row=0; row < data_->size(); ++row)
+        known_[data_->topic.data[row]] = Entry{data_->key.data[row]
+                                              ,data_->verdict.data[row]
+                                              ,data_->timestamp.data[row]};
+}
+
+
+/** @remark in baseline capturing mode every case must be rendered, to possibly capture a new baseline */
+PMemo Memo::setup(Config const& config)
+{
+    if (not config.memo or config.baseline)
+        return nullptr;
+    return PMemo{new Memo{fs::consolidated(config.suitePath)}};
+}
+
+
+string Memo::keyFor(MapS const& spec)
+{
+    fs::path executable = fs::consolidated(spec.at(def::KEY_Test_subj));
+    auto pos = subjects_.find(executable);
+    if (pos == subjects_.end())
+    {
+        string buildID = util::readElfInfo(executable).buildID;
+        pos = subjects_.emplace(executable, isnil(buildID)? hashFile(executable) : buildID).first;
+    }
+    string const& subject = pos->second;
+    uint64_t specHash = FNV_OFFSET;
+    for (auto& [key,val] : spec)
+        specHash = fnvHash(key+"="+val+"\n", specHash);
+
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << specHash;
+    return subject
+         +"-"+hex.str()
+         +"-"+hashFile(spec.at(def::KEY_stateFile))
+         +"-"+hashFile(baselineFile(spec));
+}
+
+
+std::optional<string> Memo::lookup(string const& topic, string const& key)
+{
+    auto entry = known_.find(topic);
+    if (entry == known_.end() or entry->second.key != key)
+    {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    return entry->second.verdict;
+}
+
+
+void Memo::store(string const& topic, string const& key, string const& verdict)
+{
+    known_[topic] = Entry{key, verdict, Config::timestamp};
+    ++stored_;
+}
+
+void Memo::drop(string const& topic)
+{
+    known_.erase(topic);
+}
+
+
+string Memo::describe()  const
+{
+    return formatVal(hits_)+" verdicts reused, "
+         + formatVal(misses_)+" cases rendered, "
+         + formatVal(stored_)+" stored";
+}
+
+
+void Memo::save()
+{
+    data_->topic.data.clear();
+    data_->key.data.clear();
+    data_->verdict.data.clear();
+    data_->timestamp.data.clear();
+    for (auto& [topic,entry] : known_)
+    {
+        data_->newRow();
+        data_->topic = topic;
+        data_->key = entry.key;
+        data_->verdict = entry.verdict;
+        data_->timestamp = entry.timestamp;
+    }
+    data_->save();
+}
+
+
+}//(End)namespace suite
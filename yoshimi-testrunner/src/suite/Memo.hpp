@@ -0,0 +1,107 @@
+/*
+ *  Memo - reuse verdicts of sound verification when no input has changed
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Memo.hpp
+ ** Memoisation of verdicts for test cases verifying only the generated sound.
+ ** Sound computations in Yoshimi are deterministic; thus rendering the same test again
+ ** with the same build of the subject, the same test specification, the same initial
+ ** state and the same baseline can only lead to the same verdict. The key for each case
+ ** combines hashes of these inputs; when a case concluded green and its key is unchanged
+ ** in the next run, the case is not launched again, and the cached verdict is reported.
+ ** Test cases measuring timings are always performed, since each run adds a data point.
+ ** The cache is retained locally in `Suite-memo.csv` within the Testsuite root;
+ ** memoisation is disabled with `--no-memo` and in baseline capturing mode.
+ **
+ ** @see ExeCliMould::materialise()
+ ** @see suite::step::MemoVerdict
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_MEMO_HPP_
+#define TESTRUNNER_SUITE_MEMO_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+#include "Config.hpp"
+
+#include <optional>
+#include <memory>
+#include <string>
+#include <map>
+
+
+namespace suite {
+
+using std::string;
+
+class Memo;
+class MemoData;
+using PMemo = std::shared_ptr<Memo>;
+
+
+/**
+ * Persistent cache of green verdicts, keyed by a hash of all test inputs.
+ */
+class Memo
+    : util::NonCopyable
+{
+    struct Entry
+    {
+        string key;
+        string verdict;
+        string timestamp;
+    };
+
+    std::unique_ptr<MemoData> data_;
+    std::map<string, Entry> known_;   ///< topic → memoised verdict
+    std::map<fs::path, string> subjects_; ///< executable → build-id or content hash
+    uint hits_{0};
+    uint misses_{0};
+    uint stored_{0};
+
+    Memo(fs::path suiteRoot);
+public:
+   ~Memo();
+
+    /** @return a Memo unless disabled by configuration, else `nullptr` */
+    static PMemo setup(Config const&);
+
+    /** compute the key from subject build, test spec, initial state and baseline */
+    string keyFor(MapS const& spec);
+
+    /** @return the memoised verdict, if the key is unchanged since the last green run */
+    std::optional<string> lookup(string const& topic, string const& key);
+
+    void store(string const& topic, string const& key, string const& verdict);
+    void drop(string const& topic);
+
+    uint cntHits()   const { return hits_; }
+    uint cntMisses() const { return misses_; }
+    string describe()  const;
+
+    /** persist the memoised verdicts for the next run */
+    void save();
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_MEMO_HPP_*/
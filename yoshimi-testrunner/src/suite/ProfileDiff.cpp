@@ -0,0 +1,140 @@
+/*
+ *  ProfileDiff - per-function differences between reference and candidate subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ProfileDiff.cpp
+ ** Implementation of the differential profile summary.
+ ** For each case, only the functions with the largest differences are listed in the summary;
+ ** since sampling has a statistical error, differences below one sampling period per round
+ ** are meaningless anyway. The complete tables remain in the `<TestID>-profile.csv` files.
+ **
+ */
+
+
+#include "suite/ProfileDiff.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+
+#include <fstream>
+#include <cmath>
+
+using util::formatVal;
+using util::isnil;
+
+
+namespace suite {
+
+namespace {
+    const size_t SUMMARY_FUNCTIONS = 12;
+    const string SUITE_PROFILE{"Suite-profile.md"};
+
+    string percentage(double delta, double base)
+    {
+        return base > 0? util::formatPercent(delta / base) : "--";
+    }
+
+    string millis(double val)
+    {
+        return formatVal(std::round(val * 100) / 100);
+    }
+
+    /** function names can be lengthy C++ signatures; keep the tables readable */
+    string abbreviated(string name)
+    {
+        const size_t MAX_NAME = 100;
+        if (name.size() > MAX_NAME)
+            name = name.substr(0, MAX_NAME-1) + "…";
+        for (size_t pos=0; string::npos != (pos = name.find('|', pos)); pos += 2)
+            name.replace(pos, 1, "\\|");
+        return name;
+    }
+}
+
+
+
+ProfileDiff::ProfileDiff(Config const& config)
+    : reference_{fs::consolidated(config.profile)}
+    , candidate_{config.subject}
+    , summaryFile_{isnil(config.report)? fs::consolidated(config.suitePath) / SUITE_PROFILE
+                                       : config.report.parent_path() / (config.report.stem().string()+"-profile.md")}
+    , cases_{}
+{
+    if (not fs::is_regular_file(reference_))
+        throw error::Misconfig("Reference build for --profile "+formatVal(reference_)+" not found.");
+}
+
+
+PProfileDiff ProfileDiff::setup(Config const& config)
+{
+    if (isnil(config.profile))
+        return nullptr;
+    return PProfileDiff{new ProfileDiff{config}};
+}
+
+
+void ProfileDiff::record(string topic, double refRuntime_ms, double candRuntime_ms
+                        ,std::vector<FunctionDelta> functions)
+{
+    cases_.push_back(Case{topic, refRuntime_ms, candRuntime_ms, move(functions)});
+}
+
+
+string ProfileDiff::describe()  const
+{
+    return formatVal(cases_.size())+" cases profiled against "+formatVal(reference_)
+         + " → "+formatVal(summaryFile_);
+}
+
+
+void ProfileDiff::save()
+{
+    std::ofstream out{summaryFile_};
+    if (not out.good())
+        throw error::State("Unable to write "+formatVal(summaryFile_));
+
+    out << "# Differential Profile\n\n"
+        << "- Reference: `"+reference_.string()+"`\n"
+        << "- Candidate: `"+candidate_.string()+"`\n"
+        << "- `"+Config::timestamp+"`\n";
+    for (Case const& c : cases_)
+    {
+        out << "\n## "+c.topic+"\n\n"
+            << "Runtime "+millis(c.refRuntime_ms)+"ms → "+millis(c.candRuntime_ms)+"ms"
+            << " ("+percentage(c.candRuntime_ms - c.refRuntime_ms, c.refRuntime_ms)+")\n\n"
+            << "| Function | Reference ms | Candidate ms | Δ ms | Δ | Total ref ms | Total cand ms |\n"
+            << "|---|---:|---:|---:|---:|---:|---:|\n";
+        for (size_t i=0; i < c.functions.size() and i < SUMMARY_FUNCTIONS; ++i)
+        {
+            FunctionDelta const& fun = c.functions[i];
+            out << "| "+abbreviated(fun.function)
+                 + " | "+millis(fun.refSelf_ms)
+                 + " | "+millis(fun.candSelf_ms)
+                 + " | "+(fun.delta() > 0? "+":"")+millis(fun.delta())
+                 + " | "+percentage(fun.delta(), fun.refSelf_ms)
+                 + " | "+millis(fun.refTotal_ms)
+                 + " | "+millis(fun.candTotal_ms)
+                 + " |\n";
+        }
+    }
+}
+
+
+}//(End)namespace suite
@@ -0,0 +1,115 @@
+/*
+ *  ProfileDiff - per-function differences between reference and candidate subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ProfileDiff.hpp
+ ** Differential profiling of the subject against a reference build.
+ ** When launched with `--profile=<reference-exe>`, each timed CLI test case is performed
+ ** additionally in several rounds, alternating between the reference and the subject as
+ ** candidate, so that both see the same platform conditions. Each of these invocations
+ ** is sampled with the util::SamplingProfiler; the sample counts are normalised by the
+ ** runtime reported for this invocation, and averaged over the rounds. Per function,
+ ** the difference in time spent shows where the candidate gained or lost time.
+ ** The full table for each case is stored in `<TestID>-profile.csv`; the ProfileDiff
+ ** collects the main differences of all cases and writes them as Markdown next to the
+ ** `--report` file (`<report>-profile.md`), or into `Suite-profile.md` otherwise.
+ ** @remark select the cases to profile with a filter, since each case is run
+ **         `2·`def::PROFILE_ROUNDS additional times.
+ **
+ ** @see suite::step::DiffProfile
+ ** @see util::SamplingProfiler
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_PROFILE_DIFF_HPP_
+#define TESTRUNNER_SUITE_PROFILE_DIFF_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+#include "Config.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace suite {
+
+using std::string;
+
+class ProfileDiff;
+using PProfileDiff = std::shared_ptr<ProfileDiff>;
+
+
+/** time spent in a function, averaged over the rounds of reference and candidate */
+struct FunctionDelta
+{
+    string function;
+    double refSelf_ms{0};
+    double candSelf_ms{0};
+    double refTotal_ms{0};
+    double candTotal_ms{0};
+
+    double delta()  const { return candSelf_ms - refSelf_ms; }
+};
+
+
+/**
+ * Collector for the differential profiles of all test cases profiled in this run.
+ */
+class ProfileDiff
+    : util::NonCopyable
+{
+    struct Case
+    {
+        string topic;
+        double refRuntime_ms;
+        double candRuntime_ms;
+        std::vector<FunctionDelta> functions;
+    };
+
+    fs::path reference_;
+    fs::path candidate_;
+    fs::path summaryFile_;
+    std::vector<Case> cases_;
+
+    ProfileDiff(Config const&);
+public:
+    /** @return a ProfileDiff if a reference build is configured, else `nullptr` */
+    static PProfileDiff setup(Config const&);
+
+    /** the executable of the reference build */
+    fs::path const& reference()  const { return reference_; }
+
+    /** @param functions ordered by descending absolute difference */
+    void record(string topic, double refRuntime_ms, double candRuntime_ms
+               ,std::vector<FunctionDelta> functions);
+
+    string describe()  const;
+
+    /** write the summary of all cases as Markdown */
+    void save();
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_PROFILE_DIFF_HPP_*/
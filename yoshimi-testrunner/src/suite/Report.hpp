@@ -21,10 +21,14 @@
 /** @file Report.hpp
  ** A formatted Report summarising the results of running the Testsuite.
  ** During execution, observations and results from all suite::TestStep components
- ** are collected and aggregated within the suite::TestLog. Based on this data,
- ** the report generates a human readable summary.
+ ** are collected and aggregated within the suite::TestLog. The report consumes these
+ ** results while streaming in, and writes a line for each test case as soon as it
+ ** is concluded; thus a long running Testsuite shows its findings incrementally, both
+ ** on STDOUT and in the `--report` file. In addition, a progress line with an ETA,
+ ** based on the durations observed in past runs, is shown on STDOUT after each case.
+ ** Based on the aggregated data, the report finally generates a human readable summary.
  ** 
- ** @todo WIP as of 7/21
+ ** @see Forecast.hpp
  ** @todo It is conceivable to generate output in JSON format eventually
  ** @see Stage.cpp usage
  ** @see TestLog.hpp
@@ -42,11 +46,13 @@
 #include "util/tee.hpp"
 #include "Config.hpp"
 #include "suite/TestLog.hpp"
+#include "suite/Forecast.hpp"
 
 #include <string>
 //#include <utility>
 //#include <deque>
 #include <vector>
+#include <memory>
 #include <iostream>
 #include <fstream>
 
@@ -87,9 +93,15 @@ class Report
     util::TeeStream out_;
     std::ofstream file_;
     bool reportTimes_{false};
+    bool resultsStarted_{false};
+
+    fs::path suiteRoot_;
+    std::unique_ptr<Forecast> forecast_;
+    vector<string> incidents_;
 
 public:
     Report(Config const& config)
+        : suiteRoot_{fs::consolidated(config.suitePath)}
     {
         if (not isnil(config.report))
         { // send report to file
@@ -106,10 +118,34 @@ public:
     }
 
 
+    /** prepare to track progress of the given test cases */
+    void beginSuite(vector<fs::path> plannedTopics)
+    {
+        forecast_.reset(new Forecast{suiteRoot_, move(plannedTopics)});
+    }
+
+    /** render the result of a single TestStep, as soon as it is available */
+    void consume(Result const& res)
+    {
+        if (res.code != ResCode::GREEN)
+            incidents_.push_back(res.summary);
+        if (res.isCaseSummary())
+        {
+            renderCase(res);
+            if (forecast_)
+            {
+                forecast_->caseDone(res.stats->topic, res.stats->memoised);
+                cout << "~~~ " << forecast_->describe() << endl;
+            }
+        }
+    }
+
     void generate(TestLog const& results)
     {
-        renderResults(results);
+        renderTrailingIncidents();
         renderSummary(results);
+        if (forecast_)
+            forecast_->save();
     }
 
 private:
@@ -131,45 +167,52 @@ private:
     }
 
 
-    void renderResults(TestLog const& results)
+    /** the "Results" section is opened lazily with the first line to show */
+    void startResults()
+    {
+        if (resultsStarted_) return;
+        out_ <<endl
+             << hr()
+             << h2("Results")
+             <<endl;
+        resultsStarted_ = true;
+    }
+
+    void renderCase(Result const& res)
     {
-        if (reportTimes_ or results.hasIncidents())
+        if (reportTimes_ and res.hasTimingSummary())
         {
-            out_ <<endl
-                 << hr()
-                 << h2("Results")
-                 <<endl;
+            startResults();
+            out_ << bullet(res.stats->topic.stem().string() +": \t"
+                          +formatVal(res.stats->runtime_ms) + "ms");
         }
-        vector<string> incidents;
-        for (auto& res : results)
+        else
+        if (not isnil(incidents_))
         {
-            if (res.code != ResCode::GREEN)
-                incidents.push_back(res.summary);
-            if (res.isCaseSummary())
-            {
-                if (reportTimes_ and res.hasTimingSummary())
-                    out_ << bullet(res.stats->topic.stem().string() +": \t"
-                                  +formatVal(res.stats->runtime_ms) + "ms");
-                else
-                if (not isnil(incidents))
-                {
-                    if (1 == incidents.size())
-                    {// print incident in the same line
-                        out_ << bullet(res.stats->topic.stem().string() +" ↯\t"+ incidents[0]);
-                        incidents.clear();
-                    }
-                    else
-                    {   // several incidents reported during this test case....
-                        out_ << bullet(res.stats->topic.stem().string() +" ↯↯");
-                }   }
-                for (auto& msg : incidents)
-                    out_ << bullet2(msg);
-                incidents.clear();
+            startResults();
+            if (1 == incidents_.size())
+            {// print incident in the same line
+                out_ << bullet(res.stats->topic.stem().string() +" ↯\t"+ incidents_[0]);
+                incidents_.clear();
             }
-        }
-        // further trailing warnings or errors
-        for (auto& msg : incidents)
+            else
+            {   // several incidents reported during this test case....
+                out_ << bullet(res.stats->topic.stem().string() +" ↯↯");
+        }   }
+        for (auto& msg : incidents_)
+            out_ << bullet2(msg);
+        incidents_.clear();
+        out_.flush();
+    }
+
+    /** further warnings or errors after the last test case */
+    void renderTrailingIncidents()
+    {
+        if (not isnil(incidents_))
+            startResults();
+        for (auto& msg : incidents_)
             out_ << bullet("↯↯ "+msg);
+        incidents_.clear();
 
         out_ << endl;
     }
@@ -177,8 +220,17 @@ private:
 
     void renderSummary(TestLog const& results)
     {
-        out_ << hr() << "Performed "+emph(str(results.cntTests()))+" test cases.\n";
+        out_ << hr() << "Performed "+emph(str(results.cntTests()))+" test cases"
+                     << (results.cntMemoised()? " ("+str(results.cntMemoised())+" verdicts reused from memo)" : "")
+                     << ".\n";
 
+        if (results.hasNotices())
+        {
+            out_ << hr();
+            results.forEachNotice([&](Result const& res){
+                out_ << bullet(res.summary);
+            });
+        }
         if (results.hasMalfunction())
         {
             out_ << hr();
@@ -100,6 +100,7 @@ struct Statistics
     const fs::path topic;
     const ResCode outcome;
     const double runtime_ms;
+    const bool memoised{false};   ///< verdict reused from a previous run (Memo.hpp)
 };
 
 
@@ -112,11 +113,13 @@ struct Result
     const ResCode code;
     const string summary;
     const optional<Statistics> stats;
+    const bool notice{false};   ///< information to show in the final summary, without being an incident
 
 
-    Result(ResCode c, string msg="")
+    Result(ResCode c, string msg="", bool isNotice =false)
         : code{c}
-        , summary{showRes(c) +  (isnil(msg)? "." : ": "+msg)}
+        , summary{isNotice? msg : showRes(c) +  (isnil(msg)? "." : ": "+msg)}
+        , notice{isNotice}
     { }
 
     Result(Statistics data, string msg="")
@@ -128,6 +131,7 @@ struct Result
     static Result OK()             { return Result{ResCode::GREEN}; }
     static Result Warn(string msg) { return Result{ResCode::WARNING, msg}; }
     static Result Fail(string msg) { return Result{ResCode::VIOLATION, msg}; }
+    static Result Note(string msg) { return Result{ResCode::GREEN, msg, true}; }
 
     bool is(ResCode severity) const { return code == severity; }
     bool isCaseSummary()      const { return stats.has_value(); }
@@ -0,0 +1,119 @@
+/*
+ *  Sandbox - private HOME and XDG directories for the subject on tmpfs
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file Sandbox.cpp
+ ** Implementation of the sandbox directories.
+ ** The seed holds the skeleton of the XDG base directories, populated from the Testsuite;
+ ** resetting removes the home tree and copies the seed again, which is cheap on tmpfs,
+ ** since the files involved are small. If `/dev/shm` is not available, the temporary
+ ** directory is used instead, still providing isolation, but not avoiding disk I/O.
+ **
+ */
+
+
+#include "suite/Sandbox.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+
+#include <unistd.h>
+#include <atomic>
+
+using util::formatVal;
+
+
+namespace suite {
+
+namespace {
+    const fs::path SHM_DIR{"/dev/shm"};
+
+    /** XDG base directories, relative to the home directory */
+    const std::vector<std::pair<string,fs::path>> XDG_DIRS{{"XDG_CONFIG_HOME", ".config"}
+                                                          ,{"XDG_DATA_HOME",   ".local/share"}
+                                                          ,{"XDG_STATE_HOME",  ".local/state"}
+                                                          ,{"XDG_CACHE_HOME",  ".cache"}
+                                                          };
+
+    /** @remark several sandboxes might exist within a process (e.g. worker and local cases) */
+    fs::path uniqueSandboxDir()
+    {
+        static std::atomic<uint> cnt{0};
+        std::error_code noThrow;
+        fs::path dir = fs::is_directory(SHM_DIR, noThrow)? SHM_DIR : fs::temp_directory_path();
+        return dir / ("yoshimi-sandbox-"+util::str(getpid())+"-"+util::str(++cnt));
+    }
+}
+
+
+
+Sandbox::Sandbox(Config const& config)
+    : root_{uniqueSandboxDir()}
+    , seed_{root_ / "seed"}
+    , home_{root_ / "home"}
+{
+    try {
+        fs::create_directories(seed_);
+        fs::path seedDir = fs::consolidated(config.suitePath) / def::SANDBOX_SEED;
+        if (fs::is_directory(seedDir))
+            fs::copy(seedDir, seed_, fs::copy_options::recursive | fs::copy_options::copy_symlinks);
+        for (auto& [_,dir] : XDG_DIRS)
+            fs::create_directories(seed_ / dir);
+    }
+    catch(fs::filesystem_error& fsErr)
+    {
+        std::error_code noThrow;
+        fs::remove_all(root_, noThrow);
+        throw error::State("Unable to create the sandbox in "+formatVal(root_)+": "+fsErr.what());
+    }
+}
+
+
+Sandbox::~Sandbox()
+{
+    std::error_code noThrow;
+    fs::remove_all(root_, noThrow);
+}
+
+
+PSandbox Sandbox::setup(Config const& config)
+{
+    if (not config.sandbox)
+        return nullptr;
+    return PSandbox{new Sandbox{config}};
+}
+
+
+void Sandbox::reset()
+{
+    fs::remove_all(home_);
+    fs::copy(seed_, home_, fs::copy_options::recursive | fs::copy_options::copy_symlinks);
+}
+
+
+std::vector<string> Sandbox::environment()  const
+{
+    std::vector<string> settings{"HOME="+home_.string()};
+    for (auto& [key,dir] : XDG_DIRS)
+        settings.push_back(key+"="+(home_ / dir).string());
+    return settings;
+}
+
+
+}//(End)namespace suite
@@ -0,0 +1,90 @@
+/*
+ *  Sandbox - private HOME and XDG directories for the subject on tmpfs
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file Sandbox.hpp
+ ** Isolate the persistent configuration of the subject for each launch.
+ ** Yoshimi reads and writes its configuration under `$HOME/.config/yoshimi`; several instances
+ ** launched concurrently (e.g. by workers on the same machine) would thus race on the same files,
+ ** and every start-up causes disk writes. When the testrunner is started with `--sandbox`, a private
+ ** directory tree is created once on tmpfs (`/dev/shm`), holding a pristine _seed_ copy and the
+ ** actual home directory. Before each launch, this home is reset from the seed, and the subject
+ ** is launched with `HOME` and the `XDG_*` base directories pointing into it. The seed is taken
+ ** from the directory def::SANDBOX_SEED in the Testsuite root, if present, so a known configuration
+ ** can be checked into Git; otherwise the subject starts with an empty home directory.
+ ** @remark each testrunner (and each worker) process uses its own sandbox,
+ **         which is removed when the process terminates.
+ **
+ ** @see suite::step::SandboxReset
+ ** @see suite::step::ExeLauncher
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_SANDBOX_HPP_
+#define TESTRUNNER_SUITE_SANDBOX_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+#include "Config.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace suite {
+
+using std::string;
+
+class Sandbox;
+using PSandbox = std::shared_ptr<Sandbox>;
+
+
+/**
+ * Private home directory on tmpfs, reset to a pristine seed before each launch.
+ */
+class Sandbox
+    : util::NonCopyable
+{
+    fs::path root_;
+    fs::path seed_;
+    fs::path home_;
+
+    Sandbox(Config const&);
+public:
+   ~Sandbox();
+
+    /** @return a Sandbox if configured with `--sandbox`, else `nullptr` */
+    static PSandbox setup(Config const&);
+
+    /** discard all changes made by the previous launch */
+    void reset();
+
+    /** @return settings `KEY=value` to launch the subject within the sandbox */
+    std::vector<string> environment()  const;
+
+    fs::path const& home()  const { return home_; }
+};
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_SANDBOX_HPP_*/
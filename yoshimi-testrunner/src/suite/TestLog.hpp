@@ -19,11 +19,14 @@
 
 
 /** @file TestLog.hpp
- ** Collection of suite::Result records captured during Testsuite execution.
+ ** Aggregation of suite::Result records captured during Testsuite execution.
  ** The Testsuite is a collection of suite::TestStep components, which are triggered
  ** in sequence. The result data of each step is integrated into the TestLog.
+ ** Since a complete Testsuite run can comprise thousands of steps, the individual
+ ** results are not retained; rather the TestLog maintains counters and remembers
+ ** only the incidents relevant for the final summary. Details of each test case
+ ** are rendered immediately by the suite::Report, while results are streaming in.
  ** 
- ** @todo WIP as of 7/21
  ** @see Main.cpp usage
  ** @see Suite
  ** 
@@ -53,27 +56,36 @@ using ResultHandler = std::function<void(Result const&)>;
 class TestLog
     : util::NonCopyable
 {
-    std::deque<Result> results_;
+    uint cntTests_{0};
+    uint cntFailures_{0};
+    uint cntWarnings_{0};
+    uint cntMemoised_{0};
+    bool malfunction_{false};
+    bool incidents_{false};
+
+    std::deque<Result> malfunctions_;
+    std::deque<Result> failedCases_;
+    std::deque<Result> notices_;
 
 public:
     TestLog() { };
 
-    bool hasMalfunction() const;
-    bool hasFailedCases() const;
-    bool hasViolations()  const;
-    bool hasWarnings()    const;
-    bool hasIncidents()   const;
+    bool hasMalfunction() const { return malfunction_; }
+    bool hasFailedCases() const { return not failedCases_.empty(); }
+    bool hasViolations()  const { return 0 < cntFailures_; }
+    bool hasWarnings()    const { return 0 < cntWarnings_; }
+    bool hasIncidents()   const { return incidents_; }
+    bool hasNotices()     const { return not notices_.empty(); }
 
-    uint cntTests()       const;
-    uint cntFailures()    const;
-    uint cntWarnings()    const;
+    /** @remark by convention one suite::Statistics entry is emitted for each test case */
+    uint cntTests()       const { return cntTests_; }
+    uint cntFailures()    const { return cntFailures_; }
+    uint cntWarnings()    const { return cntWarnings_; }
+    uint cntMemoised()    const { return cntMemoised_; }
 
     void forEachMalfunction(ResultHandler) const;
     void forEachFailedCase(ResultHandler)  const;
-
-    using iterator = std::deque<Result>::const_iterator;
-    iterator begin() const { return results_.begin(); }
-    iterator end()   const { return results_.end();   }
+    void forEachNotice(ResultHandler)      const;
 
     friend TestLog& operator<<(TestLog&, Result);
 };
@@ -81,75 +93,44 @@ public:
 
 inline TestLog& operator<<(TestLog& log, Result res)
 {
-    log.results_.emplace_back(std::move(res));
+    if (res.isCaseSummary())          ++log.cntTests_;
+    if (res.isCaseSummary()
+        and res.stats->memoised)      ++log.cntMemoised_;
+    if (res.is(ResCode::VIOLATION))   ++log.cntFailures_;
+    if (res.is(ResCode::WARNING))     ++log.cntWarnings_;
+    if (res.is(ResCode::MALFUNCTION)) log.malfunction_ = true;
+    if (res.isIncident())             log.incidents_ = true;
+
+    if (res.is(ResCode::MALFUNCTION) or res.is(ResCode::DEBACLE))
+        log.malfunctions_.emplace_back(std::move(res));
+    else
+    if (res.isFailedCase())
+        log.failedCases_.emplace_back(std::move(res));
+    else
+    if (res.notice)
+        log.notices_.emplace_back(std::move(res));
     return log;
 }
 
-// shorthand for invoking a predicate on the result record....
-#define CHECK_RESULT(_PREDICATE_) \
-                       [](Result const& _res_){ return _res_._PREDICATE_; }
-
-inline bool TestLog::hasMalfunction()  const
-{
-    return std::any_of(results_.begin(), results_.end(), CHECK_RESULT(is(ResCode::MALFUNCTION)) );
-}
-
-inline bool TestLog::hasViolations()  const
-{
-    return std::any_of(results_.begin(), results_.end(), CHECK_RESULT(is(ResCode::VIOLATION)) );
-}
-
-inline bool TestLog::hasWarnings()  const
-{
-    return std::any_of(results_.begin(), results_.end(), CHECK_RESULT(is(ResCode::WARNING)) );
-}
-
-inline bool TestLog::hasIncidents()  const
-{
-    return std::any_of(results_.begin(), results_.end(), CHECK_RESULT(isIncident()) );
-}
-
-
-/** @remark by convention one suite::Statistics entry is emitted for each test case */
-inline uint TestLog::cntTests()  const
-{
-    return std::count_if(results_.begin(), results_.end(), CHECK_RESULT(isCaseSummary()) );
-}
-
-
-inline uint TestLog::cntFailures()  const
-{
-    return std::count_if(results_.begin(), results_.end(), CHECK_RESULT(is(ResCode::VIOLATION)) );
-}
-
-
-inline uint TestLog::cntWarnings()  const
-{
-    return std::count_if(results_.begin(), results_.end(), CHECK_RESULT(is(ResCode::WARNING)) );
-}
-
 
-inline bool TestLog::hasFailedCases()  const
+inline void TestLog::forEachMalfunction(ResultHandler handleIt)  const
 {
-    return std::any_of(results_.begin(), results_.end(), CHECK_RESULT(isFailedCase()) );
+    for (Result const& res : malfunctions_)
+        handleIt(res);
 }
 
-#undef CHECK_RESULT
 
-
-inline void TestLog::forEachMalfunction(ResultHandler handleIt)  const
+inline void TestLog::forEachFailedCase(ResultHandler handleIt)  const
 {
-    for (Result const& res : results_)
-        if (res.is(ResCode::MALFUNCTION) or res.is(ResCode::DEBACLE))
-            handleIt(res);
+    for (Result const& res : failedCases_)
+        handleIt(res);
 }
 
 
-inline void TestLog::forEachFailedCase(ResultHandler handleIt)  const
+inline void TestLog::forEachNotice(ResultHandler handleIt)  const
 {
-    for (Result const& res : results_)
-        if (res.isFailedCase())
-            handleIt(res);
+    for (Result const& res : notices_)
+        handleIt(res);
 }
 
 
@@ -0,0 +1,163 @@
+/*
+ *  TimingTables - persistent data tables of timing measurements
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file TimingTables.hpp
+ ** Layout of the CSV tables holding the time series of timing measurements.
+ ** These tables are written while performing the Testsuite: one pair of runtime and
+ ** expense tables for each timing test case, and the global platform model at the
+ ** Testsuite root. The definitions are shared with the offline Analysis, which
+ ** loads the stored histories without invoking Yoshimi.
+ **
+ ** @see TimingObservation.cpp
+ ** @see Timings.cpp
+ ** @see Analysis.cpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_TIMING_TABLES_HPP_
+#define TESTRUNNER_SUITE_TIMING_TABLES_HPP_
+
+
+#include "util/data.hpp"
+
+#include <string>
+
+namespace suite {
+
+using std::string;
+using util::Column;
+
+
+/**
+ * Data storage for runtime measurement time series.
+ * @remark for sake of readability and to support external evaluations,
+ *         we deliberately capture several contextual parameters alongside.
+ */
+struct TableRuntime
+{
+    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the Testsuite run
+    Column<double>     runtime{"Runtime ms"};              ///< the actual timing measurement in milliseconds
+    Column<size_t>     samples{"Samples count"};
+    Column<uint>         notes{"Notes count"};
+    Column<double>    platform{"Platform ms"};             ///< runtime predicted by platform model (in ms)
+    Column<double>     expense{"Expense Factor"};          ///< baseline(expected value) for the expense
+    Column<double> expenseCurr{"Expense Factor(current)"}; ///< `runtime == platform·expenseCurr`
+    Column<double>       delta{"Delta ms"};                ///< Δ of measured runtime against `platform·expense`
+    Column<double>      maTime{"MA Time short"};           ///< moving average of runtime (baselineAvg/2 points)
+    Column<double>   tolerance{"Tolerance"};               ///< tolerance band based on 3·σ observed (over baselineAvg points)
+    Column<double>   contamination{"Contamination"};       ///< system disturbance observed during measurement (0 = quiet)
+    Column<string>     buildID{"Build-ID"};                ///< GNU build-id of the subject (abbreviated)
+    Column<string>     profile{"Profile"};                 ///< build profile (optimisation level) of the subject
+    Column<string>      engine{"Engine"};                  ///< synth engine(s) used by the test script, e.g. "ADD+PAD"
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,runtime
+                       ,samples
+                       ,notes
+                       ,platform
+                       ,expense
+                       ,expenseCurr
+                       ,delta
+                       ,maTime
+                       ,tolerance
+                       ,contamination
+                       ,buildID
+                       ,profile
+                       ,engine
+                       );
+    }
+};
+
+
+/**
+ * Data storage for the expected expense factor ("Baseline").
+ * @remark Beyond the actual expense factor, a history of past settings
+ *         is maintained, together with contextual information.
+ */
+struct TableExpense
+{
+    Column<string>   timestamp{"Timestamp"};               ///< Timestamp when setting this baseline
+    Column<uint>        points{"Averaged points"};         ///> Number of past data points averaged into this baseline
+    Column<double>     runtime{"Runtime(avg) ms"};         ///< averaged runtime used to define this baseline
+    Column<size_t>     samples{"Samples count"};           ///< samples count of the underlying test
+    Column<uint>         notes{"Notes count"};             ///< notes count of the underlying test
+    Column<double>    platform{"Platform ms"};             ///< runtime predicted by platform model for this baseline
+    Column<double>     expense{"Expense Factor"};          ///< expected value for the expense. This is the *actual baseline*.
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,points
+                       ,runtime
+                       ,samples
+                       ,notes
+                       ,platform
+                       ,expense
+                       );
+    }
+};
+
+
+/**
+ * Data storage for the local platform model (with history).
+ * @remarks
+ *  - the *platform model* is fitted by linear regression with all timing measurements within the Testsuite
+ *    and thus yields a simplified (linear) prediction of the runtime of a test based on the number of samples.
+ *  - when invoking the testsuite with argument `--calibrate`, a new fit is computed. A history of preview
+ *    platform model fits is retained in the file `Suite-plattform.csv` within the testsuite root; this file
+ *    is only valid for a given installation (machine, OS) and should not be checked into Git.
+ *  - to support external evaluations, we deliberately capture several contextual parameters alongside.
+ */
+struct TablePlatform
+{
+    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the `--calibrate` Testsuite run
+    Column<size_t>      points{"Data points"};             ///< number of fitted data points (=test cases)
+    Column<double>      socket{"Socket ms"};               ///< constant base costs per testcase
+    Column<double>       speed{"Speed ns/smp"};            ///< crunch speed (time per computed sample)
+    Column<double> correlation{"Correlation"};             ///< observed correlation coefficient between (x,y)
+    Column<double>    maxDelta{"Delta (max)"};             ///< maximum (absolute) Δ for this platform fit
+    Column<double>   sdevDelta{"Delta (sdev)"};            ///< standard deviation √Σσ² for this platform fit
+    Column<string>     profile{"Profile"};                 ///< build profile of the subject used for calibration
+    Column<double>      jitter{"Jitter"};                  ///< platform jitter score observed during calibration (0 = unknown)
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,points
+                       ,socket
+                       ,speed
+                       ,correlation
+                       ,maxDelta
+                       ,sdevDelta
+                       ,profile
+                       ,jitter
+                       );
+    }
+};
+
+
+using RuntimeData  = util::DataFile<TableRuntime>;
+using ExpenseData  = util::DataFile<TableExpense>;
+using PlatformData = util::DataFile<TablePlatform>;
+
+
+}//(End)namespace suite
+#endif /*TESTRUNNER_SUITE_TIMING_TABLES_HPP_*/
@@ -20,6 +20,17 @@
 
 /** @file Timings.cpp
  ** Implementation details of global statistics calculation.
+ ** The _stability score_ of a test case is its tolerance band (3·σ of the local fluctuations)
+ ** relative to its averaged runtime. Quarantine uses a hysteresis: a case is excluded when the
+ ** score exceeds def::QUARANTINE_ENTER, and included again only after staying below the much
+ ** lower def::QUARANTINE_RELEASE for several consecutive runs. The quarantined cases are kept
+ ** in `Suite-quarantine.csv`; like the Memo, this table carries over cases not performed.
+ ** 
+ ** Suite statistics are _composable:_ each run records the aggregates (count, sums of Δ and Δ²,
+ ** sum of squared tolerances) per topic directory in `Suite-subtree.csv`. The suite level is then
+ ** combined from the directories performed in this run and the latest comparable aggregates of all
+ ** other directories recorded since the current platform calibration. Thus a filtered run still
+ ** yields a suite level data point, without distorting the trend by treating a part as the whole.
  ** 
  ** @todo WIP as of 9/21
  **
@@ -34,17 +45,29 @@
 #include "util/statistic.hpp"
 #include "util/utils.hpp"
 #include "Timings.hpp"
+#include "suite/TimingTables.hpp"
 #include "suite/step/PathSetup.hpp"
 
 #include <functional>
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <tuple>
+#include <map>
+#include <set>
 
 namespace suite {
 
 namespace {
     const size_t MILLISEC_per_NANOSEC = 1000*1000;
+    const size_t MIN_CLUSTER_SIZE = 3;
+    const double CLUSTER_SIGMA = 3.0;      // for a single group; widened for multiple comparisons
+    const size_t MIN_SUITE_POINTS = 5;
+    const double JITTER_FACTOR_MIN = 0.7;
+    const double JITTER_FACTOR_MAX = 3.0;
+    const double DRIFT_FORGETTING = 0.9;   // per Testsuite run: memory of ≈10 runs
+    const size_t MIN_DRIFT_POINTS = 5;
+    const uint   MIN_DRIFT_RUNS = 5;
 }
 
 using std::tie;
@@ -54,44 +77,13 @@ using step::FileNameSpec;
 
 using util::isnil;
 using util::Column;
+using util::contains;
 using util::formatVal;
+using util::formatPercent;
 using util::backwards;
 
 
 
-/**
- * Data storage for the local platform model (with history).
- * @remarks
- *  - the *platform model* is fitted by linear regression with all timing measurements within the Testsuite
- *    and thus yields a simplified (linear) prediction of the runtime of a test based on the number of samples.
- *  - when invoking the testsuite with argument `--calibrate`, a new fit is computed. A history of preview
- *    platform model fits is retained in the file `Suite-plattform.csv` within the testsuite root; this file
- *    is only valid for a given installation (machine, OS) and should not be checked into Git.
- *  - to support external evaluations, we deliberately capture several contextual parameters alongside.
- */
-struct TablePlatform
-{
-    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the `--calibrate` Testsuite run
-    Column<size_t>      points{"Data points"};             ///< number of fitted data points (=test cases)
-    Column<double>      socket{"Socket ms"};               ///< constant base costs per testcase
-    Column<double>       speed{"Speed ns/smp"};            ///< crunch speed (time per computed sample)
-    Column<double> correlation{"Correlation"};             ///< observed correlation coefficient between (x,y)
-    Column<double>    maxDelta{"Delta (max)"};             ///< maximum (absolute) Δ for this platform fit
-    Column<double>   sdevDelta{"Delta (sdev)"};            ///< standard deviation √Σσ² for this platform fit
-
-    auto allColumns()
-    {   return std::tie(timestamp
-                       ,points
-                       ,socket
-                       ,speed
-                       ,correlation
-                       ,maxDelta
-                       ,sdevDelta
-                       );
-    }
-};
-
-
 /**
  * Data storage to capture global statistics for each run.
  * @remarks
@@ -111,6 +103,12 @@ struct TableStatistic
     Column<double>    maxDelta{"Delta (max)"};             ///< maximum (absolute) Δ against expected measurements
     Column<double>   sdevDelta{"Delta (sdev)"};            ///< standard deviation √Σσ² against expected measurements
     Column<double>   tolerance{"Tolerance"};               ///< tolerance band (3·σ) by error propagation from measurements
+    Column<string>     version{"Version"};                 ///< `--version` of the subject
+    Column<string>     buildID{"Build-ID"};                ///< GNU build-id of the subject (abbreviated)
+    Column<string>     profile{"Profile"};                 ///< build profile (optimisation level) of the subject
+    Column<double>      jitter{"Jitter"};                  ///< platform jitter score probed at start of this run
+    Column<size_t> quarantined{"Quarantined"};             ///< test cases excluded due to unstable runtime
+    Column<size_t>    composed{"Composed"};                ///< topic directories taken over from earlier runs
 
     auto allColumns()
     {   return std::tie(timestamp
@@ -121,6 +119,12 @@ struct TableStatistic
                        ,maxDelta
                        ,sdevDelta
                        ,tolerance
+                       ,version
+                       ,buildID
+                       ,profile
+                       ,jitter
+                       ,quarantined
+                       ,composed
                        );
     }
 };
@@ -157,11 +161,118 @@ struct TableModelFit
 };
 
 
+/**
+ * Data storage for the online estimate of platform drift.
+ * @remarks
+ *  - after each regular Testsuite run, the current data points are fed into a recursive least squares
+ *    estimator with exponential forgetting, which tracks socket and speed of the platform model.
+ *  - the model is parametrised as `Level + Speed·(x - Ref)`, with the reference sample count fixed when
+ *    tracking starts; level and speed are then almost uncorrelated, and the level directly compares
+ *    to the prediction of the calibrated platform model for a typical test case.
+ *  - the newest row holds the complete estimator state; the parameter covariance is stored as
+ *    standard deviation and correlation, while older rows document the drift as a time series.
+ */
+struct TableDrift
+{
+    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the Testsuite run
+    Column<string> calibration{"Calibration"};             ///< Timestamp of the platform model tracked against
+    Column<uint>          runs{"Runs"};                    ///< Testsuite runs tracked since this calibration
+    Column<double>      refSmp{"Ref samples"};             ///< reference sample count, weighted mean of the suite
+    Column<double>       level{"Level ms"};                ///< estimated normalised runtime at the reference sample count
+    Column<double>       speed{"Speed ns/smp"};            ///< estimated crunch speed
+    Column<double>   levelSDev{"Level σ"};                 ///< standard deviation of the level estimate
+    Column<double>   speedSDev{"Speed σ"};                 ///< standard deviation of the speed estimate
+    Column<double>   paramCorr{"Correlation"};             ///< correlation between the level and speed estimates
+    Column<double>   residSDev{"Residual σ"};              ///< residual σ of individual (normalised) test cases
+    Column<double>     runSDev{"Run σ"};                   ///< σ of the collective offset of a whole run
+    Column<double>       drift{"Drift"};                   ///< relative drift of the level against the platform model
+    Column<double>   tolerance{"Tolerance"};               ///< tolerance band (3·σ) of the drift
+    Column<string>     buildID{"Build-ID"};                ///< GNU build-id of the subject (abbreviated)
+    Column<string>       event{"Event"};                   ///< `init`, `drift` (significant) or `recalibrate`
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,calibration
+                       ,runs
+                       ,refSmp
+                       ,level
+                       ,speed
+                       ,levelSDev
+                       ,speedSDev
+                       ,paramCorr
+                       ,residSDev
+                       ,runSDev
+                       ,drift
+                       ,tolerance
+                       ,buildID
+                       ,event
+                       );
+    }
+};
+
+
+
+/**
+ * Data storage for the test cases currently excluded from suite statistics.
+ * @remark one row per quarantined case; rewritten at the end of each run.
+ */
+struct TableQuarantine
+{
+    Column<string>    testCase{"Test"};                    ///< topic directory and Test-ID of the case
+    Column<double>       score{"Score"};                   ///< tolerance band (3·σ) relative to the runtime
+    Column<string>       since{"Since"};                   ///< Timestamp of the Testsuite run which excluded this case
+    Column<uint>    stableRuns{"Stable runs"};             ///< consecutive runs with score below the release level
+
+    auto allColumns()
+    {   return std::tie(testCase
+                       ,score
+                       ,since
+                       ,stableRuns
+                       );
+    }
+};
+
+
+
+/**
+ * Data storage for the aggregated Δ of each topic directory, per run.
+ * @remark only directories actually performed in a run get a row; the suite
+ *         statistics are composed from the latest row of each directory.
+ */
+struct TableSubtree
+{
+    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the Testsuite run
+    Column<string>     subtree{"Subtree"};                 ///< topic directory, relative to the Testsuite root
+    Column<size_t>       cases{"Cases"};                   ///< number of test cases aggregated (excluding quarantined)
+    Column<size_t> quarantined{"Quarantined"};             ///< further test cases performed, yet quarantined
+    Column<double>    sumDelta{"Delta (sum)"};             ///< Σ Δ of the test cases
+    Column<double>  sumSqDelta{"Delta² (sum)"};            ///< Σ Δ² of the test cases
+    Column<double>    sumSqTol{"Tolerance² (sum)"};        ///< Σ tolerance² of the test cases (error propagation)
+    Column<double>    maxDelta{"Delta (max)"};             ///< maximum (absolute) Δ within this directory
+    Column<string>     profile{"Profile"};                 ///< build profile of the subject
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,subtree
+                       ,cases
+                       ,quarantined
+                       ,sumDelta
+                       ,sumSqDelta
+                       ,sumSqTol
+                       ,maxDelta
+                       ,profile
+                       );
+    }
+};
+
+
 
 using VecD = std::vector<double>;
 using TestTable = std::vector<std::reference_wrapper<TimingTest>>;
-using PlatformData = util::DataFile<TablePlatform>;
 using StatisticData = util::DataFile<TableStatistic>;
+using DriftData = util::DataFile<TableDrift>;
+using QuarantineData = util::DataFile<TableQuarantine>;
+using SubtreeData = util::DataFile<TableSubtree>;
 
 using util::RegressionData;
 using util::RegressionPoint;
@@ -180,16 +291,44 @@ class TimingData
     PlatformData   platform_;
     StatisticData  statistic_;
     ModelFit       modelFit_;
+    DriftData      drift_;
+    QuarantineData quarantine_;
+    SubtreeData    subtree_;
+    std::set<string> quarantined_;
+    bool           recalibrated_{false};
+
+    static string caseKey(TimingTest const& test)
+    {
+        return (test.topic.parent_path() / test.testID).string();
+    }
+
+    bool isQuarantined(TimingTest const& test)  const
+    {
+        return contains(quarantined_, caseKey(test));
+    }
+
+    /** only stable cases contribute to the platform model fit and drift tracking */
+    bool isPlatformRef(TimingTest const& test)  const
+    {
+        return test.platformRef and not isQuarantined(test);
+    }
 
 public:
     TimingData(fs::path filePlatform
               ,fs::path fileStatistic
               ,fs::path fileRegression
+              ,fs::path fileDrift
+              ,fs::path fileQuarantine
+              ,fs::path fileSubtree
               )
         : testData_{}
         , platform_{filePlatform}
         , statistic_{fileStatistic}
         , modelFit_{fileRegression}
+        , drift_{fileDrift}
+        , quarantine_{fileQuarantine}
+        , subtree_{fileSubtree}
+        , quarantined_{quarantine_.testCase.data.begin(), quarantine_.testCase.data.end()}
     {
         testData_.reserve(def::EXPECTED_TEST_CNT);
     }
@@ -203,6 +342,10 @@ public:
     {
         return testData_.size();
     }
+    std::set<string> const& quarantinedCases()  const
+    {
+        return quarantined_;
+    }
     size_t timeSeriesSize()  const
     {
         return statistic_.size();
@@ -228,6 +371,16 @@ public:
         return platform_.sdevDelta;
     }
 
+    string getCalibrationProfile() const
+    {
+        return hasPlatformCalibration()? string{platform_.profile} : "";
+    }
+
+    double getCalibrationJitter() const
+    {
+        return hasPlatformCalibration()? double{platform_.jitter} : 0.0;
+    }
+
     array<double,3> getDeltaStatistics()  const
     {
         return {statistic_.avgDelta
@@ -252,6 +405,7 @@ public:
         data.reserve(testData_.size());
         for (TimingTest const& test : testData_)
         {
+            if (not isPlatformRef(test)) continue;
             auto [samples, runtime, expense] = test.getAveragedDataPoint(avgPoints);
             if (expense <= 0.0) expense = 1.0; // no baseline yet; use timing as-is, unweighted
             data.emplace_back(RegressionPoint{samples, runtime / expense, expense});
@@ -259,7 +413,7 @@ public:
         return data;
     }
 
-    void buildPlatformModel(RegressionData points)
+    void buildPlatformModel(RegressionData points, string profile, double jitter)
     {
         auto clearColumn = [size=points.size()](auto& col){
                                col.data.clear();
@@ -283,6 +437,8 @@ public:
         // Mark new model with Timestamp of current Testsuite run
         platform_.timestamp = Config::timestamp;
         platform_.points = points.size();
+        platform_.profile = profile;
+        platform_.jitter = jitter;
 
         // capture data underlying the computed regression (for manual inspection)
         swap(modelFit_.prediction.data, predictedPoints);
@@ -300,17 +456,87 @@ public:
             modelFit_.runtime.data.push_back(p.w*p.y); // reverse normalisation to get real data
         }
         for (TimingTest& test : testData_)
-            modelFit_.testID.data.push_back(test.testID);
+            if (isPlatformRef(test))
+                modelFit_.testID.data.push_back(test.testID);
+    }
+
+    /** aggregated Δ of a group of test cases; can be combined by addition */
+    struct Aggregate
+    {
+        size_t cases{0};
+        size_t quarantined{0};
+        double sumDelta{0.0};
+        double sumSqDelta{0.0};
+        double sumSqTol{0.0};
+        double maxDelta{0.0};
+
+        void add(double delta, double sqDelta, double sqTol, double max, size_t cnt =1)
+        {
+            cases += cnt;
+            sumDelta += delta;
+            sumSqDelta += sqDelta;
+            sumSqTol += sqTol;     // error propagation; tolerance ~ 3·σ
+            maxDelta = std::max(maxDelta, max);
+        }
+    };
+
+    /**
+     * Combine the aggregates of this run with the latest comparable aggregate recorded since
+     * the current platform calibration for each further topic directory.
+     * @param filtered only for a filtered run, other directories are taken over from the records;
+     *        a complete run stands on its own, thereby retiring deleted or renamed directories
+     * @remark records of directories no longer present below the suite root are ignored
+     * @return the suite level aggregate, number of directories taken over, and if all are covered
+     */
+    auto composeSuite(std::map<string,Aggregate> const& current, string profile
+                     ,bool filtered, fs::path suiteRoot)  const
+    {
+        Aggregate total;
+        for (auto& [dir, group] : current)
+            total.add(group.sumDelta, group.sumSqDelta, group.sumSqTol, group.maxDelta, group.cases);
+        if (not filtered)
+            return make_tuple(total, size_t(0), true);
+
+        string calibration = hasPlatformCalibration()? string{platform_.timestamp} : "";
+        std::set<string> known, taken;
+        for (size_t i=subtree_.size(); 0 < i; --i)
+        {   // newest rows first
+            string dir = subtree_.subtree.data[i-1];
+            if (subtree_.timestamp.data[i-1] < calibration or contains(current, dir)) continue;
+            if (not fs::is_directory(suiteRoot / dir)) continue;
+            known.insert(dir);
+            if (contains(taken, dir) or not BuildInfo::isComparable(profile, subtree_.profile.data[i-1])) continue;
+            taken.insert(dir);
+            total.add(subtree_.sumDelta.data[i-1], subtree_.sumSqDelta.data[i-1]
+                     ,subtree_.sumSqTol.data[i-1], subtree_.maxDelta.data[i-1]
+                     ,subtree_.cases.data[i-1]);
+        }
+        return make_tuple(total, taken.size(), known.size() == taken.size());
+    }
+
+    /** @return number of test cases (including quarantined) of the newest record for this directory */
+    std::optional<size_t> recordedMembers(string dir)  const
+    {
+        for (size_t i=subtree_.size(); 0 < i; --i)
+            if (subtree_.subtree.data[i-1] == dir)
+                return subtree_.cases.data[i-1] + subtree_.quarantined.data[i-1];
+        return std::nullopt;
     }
 
     /**
      * capture current global timing statistics as a single time series data point.
-     * @remark observing only actual delta against established baseline for each test.
+     * @remark observing only actual delta against established baseline for each test;
+     *         quarantined test cases and benchmark metrics are not included.
+     *         The aggregates per topic directory are recorded in any case, while the
+     *         suite level data point is composed and judged for reliability afterwards.
      * @param avgPoints individual past measurements to pre-average for each test case data point
+     * @param filtered only a selection of test cases was performed; directories where less
+     *         cases were performed than recorded are not updated, but taken over from the record
      * @return current delta averaged over all test cases,
      *         and error propagation from the tolerance band of all included test cases
      */
-    auto calcSuiteStatistics(uint avgPoints)
+    auto calcSuiteStatistics(uint avgPoints, BuildInfo const& build, bool foreignProfile, double jitter
+                            ,bool filtered, fs::path suiteRoot)
     {
         assert(not isnil(testData_));
         statistic_.dupRow();
@@ -319,36 +545,95 @@ public:
             statistic_.socket = platform_.socket;
             statistic_.speed  = platform_.speed;
         }
-        size_t n = statistic_.points = testData_.size();
-        double avg=0.0, max=0.0, err=0.0;
-        VecD deltas; deltas.reserve(n);
+        std::map<string,Aggregate> current;
+        size_t quarantined = 0;
         for (TimingTest const& test : testData_)
         {
+            if (not test.platformRef) continue;   // benchmark metrics follow their own scale
+            Aggregate& group = current[test.topic.parent_path().string()];
+            if (isQuarantined(test))
+            {
+                ++group.quarantined;
+                ++quarantined;
+                continue;
+            }
             auto [delta, tolerance] = test.getAveragedError(avgPoints);
-            deltas.push_back(delta);
-            avg += delta;
-            err += tolerance*tolerance;    // error propagation; tolerance ~ 3·σ
-            max = std::max(max, fabs(delta));
+            group.add(delta, delta*delta, tolerance*tolerance, fabs(delta));
+        }
+        if (filtered)
+            for (auto group = current.begin(); group != current.end(); )
+            {
+                auto recorded = recordedMembers(group->first);
+                if (recorded and group->second.cases + group->second.quarantined < *recorded)
+                    group = current.erase(group);
+                else
+                    ++group;
+            }
+        for (auto& [dir, group] : current)
+        {
+            subtree_.newRow();
+            subtree_.timestamp  = Config::timestamp;
+            subtree_.subtree    = dir;
+            subtree_.cases      = group.cases;
+            subtree_.quarantined = group.quarantined;
+            subtree_.sumDelta   = group.sumDelta;
+            subtree_.sumSqDelta = group.sumSqDelta;
+            subtree_.sumSqTol   = group.sumSqTol;
+            subtree_.maxDelta   = group.maxDelta;
+            subtree_.profile    = build.profile;
+        }
+        auto [total, composed, complete] = composeSuite(current, build.profile, filtered, suiteRoot);
+
+        size_t n = statistic_.points = total.cases;
+        double avg=0.0, err=0.0, var=0.0;
+        if (0 < n)
+        {
+            avg = total.sumDelta / n;
+            err = sqrt(total.sumSqTol) / n;             // ~ 3·σ
+            var = std::max(0.0, total.sumSqDelta - n*avg*avg) / (n<2? 1 : n-1);
         }
-        avg /= n;
         statistic_.avgDelta  = avg;
-        statistic_.maxDelta  = max;
-        statistic_.sdevDelta = util::sdev(deltas, avg);
-        statistic_.tolerance = sqrt(err)/n;       // ~ 3·σ
+        statistic_.maxDelta  = total.maxDelta;
+        statistic_.sdevDelta = sqrt(var);
+        statistic_.tolerance = err;
+        statistic_.quarantined = quarantined;
+        statistic_.composed = composed;
         statistic_.timestamp = Config::timestamp; // current Testsuite run
-
-        if ((n < 5 or max == 0.0) and 1 < statistic_.size())
-            statistic_.dropLastRow();             // unreliable statistics, possibly a filtered suite run
-                                                  // discard data to prevent poisoning global statistics
+        statistic_.version = build.version;
+        statistic_.buildID = build.buildID;
+        statistic_.profile = build.profile;
+        statistic_.jitter = jitter;
+
+        bool reliable = MIN_SUITE_POINTS <= n     // judged on the composed total, not on this run alone
+                    and total.maxDelta != 0.0
+                    and not foreignProfile
+                    and complete;
+        if (not reliable and 1 < statistic_.size())
+            statistic_.dropLastRow();             // unreliable statistics, e.g. a filtered suite run lacking
+                                                  // data for other subtrees, or a build not matching the
+                                                  // calibration; discard data to prevent poisoning global statistics
         return make_tuple(double{statistic_.avgDelta}
                          ,double{statistic_.tolerance});
     }
 
+    /** the avgDelta time series, segmented to runs with comparable build profile */
+    VecD comparableDeltaSeries()  const
+    {
+        string current = statistic_.profile;
+        VecD series;
+        series.reserve(statistic_.size());
+        for (size_t i=0; i < statistic_.size(); ++i)
+            if (BuildInfo::isComparable(current, statistic_.profile.data[i]))
+                series.push_back(statistic_.avgDelta.data[i]);
+        return series;
+    }
+
     /** calculate statistics over the past time series for the avgDelta */
     auto calcDeltaPastStatistics(uint avgPoints)
     {
-        double movingAvg = util::averageLastN(statistic_.avgDelta.data, avgPoints);
-        double pastSDev = util::sdevLastN(statistic_.avgDelta.data, avgPoints, movingAvg);
+        VecD series = comparableDeltaSeries();
+        double movingAvg = util::averageLastN(series, avgPoints);
+        double pastSDev = util::sdevLastN(series, avgPoints, movingAvg);
         return make_tuple(movingAvg, pastSDev);
     }
 
@@ -356,32 +641,365 @@ public:
     auto calcDeltaTrend(uint avgPoints) const
     {
         return computeTimeSeriesLinearRegression(
-                   util::lastN(statistic_.avgDelta.data, avgPoints));
+                   util::lastN(comparableDeltaSeries(), avgPoints));
     }
 
-    /** find time span into the past without changes to the platform model */
+    /** find time span into the past without changes to the platform model,
+     *  counting only Testsuite runs with a comparable build profile */
     uint stablePlatformTimespan()  const
     {
         if (not hasPlatformCalibration())
-            return timeSeriesSize();
+            return comparableDeltaSeries().size();
         double anchor = platform_.speed;    // current platform model factor
-        auto timeSeries = backwards(statistic_.speed.data);
+        string current = statistic_.profile;
         uint points = 0;
-        for (auto p = begin(timeSeries);
-             p != end(timeSeries) and *p == anchor;
-             ++p
-            )
-            ++points;
+        for (size_t i=statistic_.size(); 0 < i and statistic_.speed.data[i-1] == anchor; --i)
+            if (BuildInfo::isComparable(current, statistic_.profile.data[i-1]))
+                ++points;
         return points;
     }
 
 
+    /**
+     * Aggregate the current relative Δ of test cases into groups of related cases,
+     * and compare each group against the remainder of the suite. Groups are formed
+     * by each directory within the topic path, and by the synth engine used.
+     * @remark comparing against the remainder cancels out any shift common to all
+     *         test cases, which is the subject of the global trend observation.
+     *         Significant clusters are picked greedily, most significant first;
+     *         cases already attributed to a cluster are then no longer used as
+     *         reference, so that the complement of a shifted group is not flagged.
+     *         Since each candidate group is tested, on a large suite some group would
+     *         exceed 3·σ by chance; thus the tolerance is widened to the Bonferroni
+     *         bound, keeping the false alarm rate of the whole run at that of a
+     *         single 3·σ test. Measurements taken on a disturbed system are omitted.
+     */
+    auto calcClusterShifts(size_t minSize)  const
+    {
+        using ClusterShift = Timings::ClusterShift;
+        VecD relDelta, relTolerance;
+        std::map<string, std::vector<size_t>> groups;
+        for (TimingTest const& test : testData_)
+        {
+            if (not isPlatformRef(test) or test.isDisturbed()) continue;
+            auto [samples, runtime, expense] = test.getAveragedDataPoint(1);
+            auto [delta, tolerance] = test.getAveragedError(1);
+            double expected = runtime - delta;
+            if (expense <= 0.0 or expected <= 0.0)
+                continue; // no baseline established yet
+            size_t idx = relDelta.size();
+            relDelta.push_back(delta / expected);
+            relTolerance.push_back(tolerance / expected);
+            for (fs::path dir = test.topic.parent_path(); not dir.empty(); dir = dir.parent_path())
+                groups[dir.string()+"/"].push_back(idx);
+            groups["engine:"+test.engine].push_back(idx);
+        }
+        // candidate groups; for identical sets of cases retain the most specific path
+        std::map<std::vector<size_t>, string> candidates;
+        for (auto& [group, members] : groups)
+            if (minSize <= members.size() and members.size() < relDelta.size())
+                candidates[members] = group;  // groups covering the whole suite ⟹ global trend
+
+        double alpha = std::erfc(CLUSTER_SIGMA / M_SQRT2);
+        double widening = candidates.empty()? 1.0
+                                            : util::normalQuantile(alpha / candidates.size()) / CLUSTER_SIGMA;
+        std::vector<bool> explained(relDelta.size(), false);
+        auto evaluate = [&](std::vector<size_t> const& members, string const& group)
+                            {
+                                std::vector<bool> isMember(relDelta.size(), false);
+                                for (size_t i : members) isMember[i] = true;
+                                double sum[2]{0,0}, err[2]{0,0};
+                                size_t cnt[2]{0,0};
+                                for (size_t i=0; i < relDelta.size(); ++i)
+                                    if (isMember[i] or not explained[i])
+                                    {
+                                        sum[isMember[i]] += relDelta[i];
+                                        err[isMember[i]] += relTolerance[i]*relTolerance[i];
+                                        ++cnt[isMember[i]];
+                                    }
+                                if (0 == cnt[false])
+                                    return ClusterShift{group, members.size()};
+                                return ClusterShift{group, members.size()
+                                                   ,sum[true]/cnt[true] - sum[false]/cnt[false]
+                                                   ,widening * util::errorSum(sqrt(err[true])/cnt[true]
+                                                                             ,sqrt(err[false])/cnt[false])};
+                            };
+        auto significance = [](ClusterShift const& c){ return fabs(c.shift) / (c.tolerance+1e-15); };
+
+        std::vector<ClusterShift> clusters;
+        while (not candidates.empty())
+        {
+            auto best = candidates.end();
+            ClusterShift bestShift;
+            for (auto pos = candidates.begin(); pos != candidates.end(); ++pos)
+            {
+                ClusterShift c = evaluate(pos->first, pos->second);
+                if (best == candidates.end() or significance(bestShift) < significance(c))
+                {
+                    best = pos;
+                    bestShift = c;
+            }   }
+            if (not bestShift.isSignificant())
+            {   // remaining groups for information only
+                for (auto& [members, group] : candidates)
+                    clusters.push_back(evaluate(members, group));
+                break;
+            }
+            clusters.push_back(bestShift);
+            for (size_t i : best->first) explained[i] = true;
+            candidates.erase(best);
+        }
+        return clusters;
+    }
+
+
+    /**
+     * Feed the measurements of the current run into the online estimate of the platform model.
+     * Recursive least squares with exponential forgetting: the information gathered so far is
+     * discounted by λ once per run, and then each test case contributes its normalised runtime,
+     * weighted by the expense factor (as for the calibration). Tracking starts from the calibrated
+     * platform model, which is given the weight of `priorRuns` runs.
+     * @remark the drift is judged against two sources of noise: the parameter uncertainty due to
+     *         the scatter of individual test cases, and the collective offset of a whole run, which
+     *         fluctuates from run to run (CPU clock, system load). Seen from the latter, the level
+     *         behaves like an exponentially weighted average, with variance σ²·(1-λ)/(1+λ).
+     * @param adapt adopt a significant drift as new platform model, yet only when the subject build
+     *         is unchanged since the last run; otherwise a change in the subject could be mistaken
+     *         for platform drift and silently absorbed into the model.
+     */
+    std::optional<Timings::PlatformDrift> trackDrift(BuildInfo const& build, double jitter, uint priorRuns, bool adapt)
+    {
+        RegressionData points;
+        for (TimingTest const& test : testData_)
+        {
+            if (not isPlatformRef(test)) continue;
+            auto [samples, runtime, expense] = test.getAveragedDataPoint(1);
+            if (0.0 < expense and 0.0 < runtime)  // only cases with established baseline
+                points.emplace_back(RegressionPoint{samples, runtime / expense, expense});
+        }
+        if (points.size() < MIN_DRIFT_POINTS)
+            return std::nullopt;
+
+        const double lambda = DRIFT_FORGETTING;
+        const double refSpeed = platform_.speed / MILLISEC_per_NANOSEC;    // regression based on timings in ms
+        auto reference = [&](double x){ return platform_.socket + refSpeed * x; };
+
+        // estimator state: θ = (level,speed) and P ~ inverse of the information matrix
+        double xRef, level, speed, p00, p01, p11, resVar, runVar;
+        uint runs;
+        string prevBuild;
+        bool restart = drift_.empty() or string{drift_.calibration} != string{platform_.timestamp};
+        if (restart)
+        {
+            double wsum=0, wxsum=0, wxxsum=0;
+            for (auto& p : points)
+            {
+                wsum   += p.w;
+                wxsum  += p.w * p.x;
+                wxxsum += p.w * p.x*p.x;
+            }
+            xRef = wxsum / wsum;
+            double varx = wxxsum - xRef * wxsum;           // Σw(x-xRef)²
+            level = reference(xRef);
+            speed = refSpeed;
+            p00 = 1.0 / (wsum * priorRuns);
+            p01 = 0.0;                                     // uncorrelated by choice of xRef
+            p11 = 0.0 < varx? 1.0 / (varx * priorRuns)
+                            : 0.0;                         // speed can not be tracked with uniform sample counts
+            resVar = platform_.sdevDelta * platform_.sdevDelta;
+            runVar = 0.0;
+            runs = 0;
+        }
+        else
+        {
+            xRef   = drift_.refSmp;
+            level  = drift_.level;
+            speed  = drift_.speed / MILLISEC_per_NANOSEC;
+            resVar = drift_.residSDev * drift_.residSDev;
+            runVar = drift_.runSDev * drift_.runSDev;
+            runs   = drift_.runs;
+            prevBuild = drift_.buildID;
+            double sdL = drift_.levelSDev;
+            double sdS = drift_.speedSDev / MILLISEC_per_NANOSEC;
+            double rho = std::clamp(double{drift_.paramCorr}, -0.999, 0.999);
+            double var = std::max(resVar, 1e-12);
+            p00 = sdL*sdL / var;
+            p01 = rho*sdL*sdS / var;
+            p11 = sdS*sdS / var;
+        }
+
+        // collective offset of this run against the prior estimate
+        double wsum=0, esum=0;
+        for (auto& p : points)
+        {
+            wsum += p.w;
+            esum += p.w * (p.y - level - speed * (p.x - xRef));
+        }
+        double runOffset = esum / wsum;
+
+        p00 /= lambda; p01 /= lambda; p11 /= lambda;      // forget old information
+        for (auto& p : points)
+        {
+            double phi = p.x - xRef;
+            double g0 = p00 + p01*phi;                     // P·φ
+            double g1 = p01 + p11*phi;
+            double denom = 1.0/p.w + g0 + g1*phi;          // 1/w + φᵀ·P·φ
+            double k0 = g0 / denom;                        // gain
+            double k1 = g1 / denom;
+            double err = p.y - level - speed*phi;
+            level += k0 * err;
+            speed += k1 * err;
+            p00 -= k0 * g0;
+            p01 -= k0 * g1;
+            p11 -= k1 * g1;
+        }
+        double sqErr=0, maxErr=0;
+        for (auto& p : points)
+        {
+            double err = p.y - level - speed * (p.x - xRef);
+            sqErr += p.w * err*err;
+            maxErr = std::max(maxErr, fabs(err));
+        }
+        double currVar = sqErr / points.size();
+        resVar = (restart and resVar == 0.0)? currVar : lambda*resVar + (1-lambda)*currVar;
+        runVar = restart? runOffset*runOffset : lambda*runVar + (1-lambda)*runOffset*runOffset;
+        ++runs;
+
+        double expected = reference(xRef);
+        Timings::PlatformDrift result;
+        result.runs = runs;
+        result.drift = (level - expected) / expected;
+        result.tolerance = 3 * sqrt(std::max(resVar*p00, runVar*(1-lambda)/(1+lambda))) / expected;
+        result.significant = MIN_DRIFT_RUNS <= runs and result.tolerance < fabs(result.drift);
+        result.recalibrated = result.significant and adapt
+                          and not isnil(build.buildID) and build.buildID == prevBuild;
+
+        drift_.dupRow();
+        drift_.timestamp   = Config::timestamp;
+        drift_.calibration = platform_.timestamp;
+        drift_.runs        = runs;
+        drift_.refSmp      = xRef;
+        drift_.level       = level;
+        drift_.speed       = speed * MILLISEC_per_NANOSEC;
+        drift_.levelSDev   = sqrt(resVar * p00);
+        drift_.speedSDev   = sqrt(resVar * p11) * MILLISEC_per_NANOSEC;
+        drift_.paramCorr   = 0.0 < p11? p01 / sqrt(p00 * p11) : 0.0;
+        drift_.residSDev   = sqrt(resVar);
+        drift_.runSDev     = sqrt(runVar);
+        drift_.drift       = result.drift;
+        drift_.tolerance   = result.tolerance;
+        drift_.buildID     = build.buildID;
+        drift_.event       = result.recalibrated? "recalibrate"
+                           : result.significant?  "drift"
+                           : restart?             "init" : "";
+        if (result.recalibrated)
+        {   // discrete recalibration event: adopt the tracked estimate as new platform model
+            platform_.dupRow();
+            platform_.socket    = level - speed * xRef;
+            platform_.speed     = speed * MILLISEC_per_NANOSEC;
+            platform_.maxDelta  = maxErr;
+            platform_.sdevDelta = sqrt(resVar);
+            platform_.timestamp = Config::timestamp;
+            platform_.points    = points.size();
+            platform_.profile   = build.profile;
+            platform_.jitter    = jitter;
+            drift_.calibration  = Config::timestamp;  // continue tracking against the new model
+            drift_.runs         = 0;
+            recalibrated_ = true;
+        }
+        return result;
+    }
+
+
+    /**
+     * Assess the stability of all test cases performed in this run, and
+     * exclude or include them for the suite statistics, with hysteresis.
+     * @param avgPoints past measurements to average for the runtime
+     */
+    Timings::Quarantine updateQuarantine(uint avgPoints)
+    {
+        std::map<string, size_t> rows;
+        for (size_t i=0; i < quarantine_.size(); ++i)
+            rows[quarantine_.testCase.data[i]] = i;
+
+        Timings::Quarantine result;
+        std::set<string> released;
+        for (TimingTest const& test : testData_)
+        {
+            if (not test.platformRef) continue;   // benchmark metrics are not part of suite statistics
+            auto [samples, runtime, expense] = test.getAveragedDataPoint(avgPoints);
+            auto [delta, tolerance] = test.getAveragedError(avgPoints);
+            if (expense <= 0.0 or runtime <= 0.0)
+                continue; // no baseline established yet
+            double score = tolerance / runtime;
+            string key = caseKey(test);
+            auto row = rows.find(key);
+            if (row == rows.end())
+            {
+                if (score <= def::QUARANTINE_ENTER) continue;
+                quarantine_.newRow();
+                quarantine_.testCase   = key;
+                quarantine_.score      = score;
+                quarantine_.since      = Config::timestamp;
+                quarantine_.stableRuns = 0u;
+                rows[key] = quarantine_.size() - 1;
+                result.entered.push_back(key+" ±"+formatPercent(score).substr(1));
+            }
+            else
+            {
+                size_t i = row->second;
+                quarantine_.score.data[i] = score;
+                quarantine_.stableRuns.data[i] = score < def::QUARANTINE_RELEASE? quarantine_.stableRuns.data[i] + 1 : 0;
+                if (def::QUARANTINE_STABLE_RUNS <= quarantine_.stableRuns.data[i])
+                {
+                    released.insert(key);
+                    result.released.push_back(key+" ±"+formatPercent(score).substr(1));
+                }
+            }
+        }
+        if (not released.empty())
+        {   // rebuild the table without the released cases
+            TableQuarantine remaining;
+            for (size_t i=0; i < quarantine_.size(); ++i)
+                if (not contains(released, quarantine_.testCase.data[i]))
+                {
+                    remaining.testCase.data.push_back(quarantine_.testCase.data[i]);
+                    remaining.score.data.push_back(quarantine_.score.data[i]);
+                    remaining.since.data.push_back(quarantine_.since.data[i]);
+                    remaining.stableRuns.data.push_back(quarantine_.stableRuns.data[i]);
+                }
+            swap(quarantine_.testCase.data,   remaining.testCase.data);
+            swap(quarantine_.score.data,      remaining.score.data);
+            swap(quarantine_.since.data,      remaining.since.data);
+            swap(quarantine_.stableRuns.data, remaining.stableRuns.data);
+        }
+        quarantined_.clear();
+        for (size_t i=0; i < quarantine_.size(); ++i)
+        {
+            quarantined_.insert(quarantine_.testCase.data[i]);
+            result.current.push_back(quarantine_.testCase.data[i]
+                                    +" ±"+formatPercent(quarantine_.score.data[i]).substr(1)
+                                    +" since "+quarantine_.since.data[i]);
+        }
+        return result;
+    }
+
+
     void save(bool includingCalibration, uint timingsKeep, uint calibrationKeep)
     {
         statistic_.save(timingsKeep);
-        if (not includingCalibration) return;
+        quarantine_.save();
+        if (not subtree_.empty())
+        {   // retain about timingsKeep rows for each directory
+            std::set<string> dirs{subtree_.subtree.data.begin(), subtree_.subtree.data.end()};
+            subtree_.save(timingsKeep * dirs.size());
+        }
+        if (not drift_.empty())
+            drift_.save(timingsKeep);
+        if (not (includingCalibration or recalibrated_)) return;
         platform_.save(calibrationKeep);
-        modelFit_.save();
+        if (includingCalibration)
+            modelFit_.save();
         for (TimingTest& test : testData_)
             test.recalc_and_save_current([this](uint notes, size_t samples)
                                          { return evalPlatformModel(notes,samples); });
@@ -404,22 +1022,39 @@ public:
 Timings::~Timings() { }
 
 Timings::Timings(fs::path root
+                ,fs::path subject
                 ,uint keepT
                 ,uint keepB
                 ,uint baseline
-                ,uint longterm)
+                ,uint longterm
+                ,double contamination
+                ,bool recalibrate
+                ,bool filtered)
     : data_{new TimingData{FileNameSpec(def::TIMING_SUITE_PLATFORM)
                             .enforceExt(def::EXT_DATA_CSV)
                           ,FileNameSpec(def::TIMING_SUITE_STATISTIC)
                             .enforceExt(def::EXT_DATA_CSV)
                           ,FileNameSpec(def::TIMING_SUITE_REGRESSION)
                             .enforceExt(def::EXT_DATA_CSV)
+                          ,FileNameSpec(def::TIMING_SUITE_DRIFT)
+                            .enforceExt(def::EXT_DATA_CSV)
+                          ,FileNameSpec(def::TIMING_SUITE_QUARANTINE)
+                            .enforceExt(def::EXT_DATA_CSV)
+                          ,FileNameSpec(def::TIMING_SUITE_SUBTREE)
+                            .enforceExt(def::EXT_DATA_CSV)
                           }}
+    , subject_{subject}
+    , builds_{}
+    , predictor_{}
     , suitePath{consolidated(root)}
     , timingsKeep{keepT}
     , baselineKeep{keepB}
     , baselineAvg{baseline}
     , longtermAvg{longterm}
+    , contaminationLimit{contamination}
+    , adaptDrift{recalibrate}
+    , filteredRun{filtered}
+    , jitter_{0.0}
 { }
 
 
@@ -433,10 +1068,14 @@ PTimings Timings::setup(Config const& config)
     fs::current_path(suiteRoot); // CWD to testsuite root
 
     return PTimings{new Timings(suiteRoot
+                               ,config.subject
                                ,config.timingsKeep
                                ,config.baselineKeep
                                ,config.baselineAvg
                                ,config.longtermAvg
+                               ,config.contaminationLimit
+                               ,config.recalibrate
+                               ,not isnil(config.filter)
                                )};
 }
 
@@ -446,10 +1085,25 @@ void Timings::attach(TimingTest& singleTestcaseData)
     data_->attach(singleTestcaseData);
 }
 
+/**
+ * @remark the stored timings of all test cases are loaded on first demand,
+ *         which only happens when the Testsuite contains new cases.
+ */
+std::optional<Timings::Prediction> Timings::predictExpense(TimingTest const& newCase, double platform)
+{
+    if (platform <= 0.0 or not isCalibrated())
+        return std::nullopt;
+    if (not predictor_)
+        predictor_.reset(new ExpensePredictor{suitePath, data_->quarantinedCases()});
+    return predictor_->predict(newCase.topic, newCase.engine, platform);
+}
+
 void Timings::fitNewPlatformModel()
 {
     data_->buildPlatformModel(
-            data_->preprocessRegressionData(baselineAvg));
+            data_->preprocessRegressionData(baselineAvg)
+           ,subjectBuild().profile
+           ,jitter_);
 }
 
 void Timings::calcSuiteStatistics()
@@ -458,7 +1112,8 @@ void Timings::calcSuiteStatistics()
         throw error::LogicBroken("No timing measurement performed yet.");
 
     tie(suite.currAvgDelta
-       ,suite.tolerance) = data_->calcSuiteStatistics(baselineAvg);
+       ,suite.tolerance) = data_->calcSuiteStatistics(baselineAvg, subjectBuild(), isProfileMismatch(), jitter_
+                                                     ,filteredRun, suitePath);
 
     uint availData = data_->stablePlatformTimespan();
     suite.shortTerm = std::min(availData, baselineAvg);
@@ -475,6 +1130,34 @@ void Timings::calcSuiteStatistics()
 }
 
 
+/**
+ * Update the online estimate of the platform model with the current run.
+ * @return the drift observed, or `nullopt` if not tracked, since the platform model is
+ *         not calibrated or calibrated for a different build profile, or too few test
+ *         cases with established baseline were performed (filtered suite run).
+ */
+std::optional<Timings::PlatformDrift> Timings::trackPlatformDrift()
+{
+    if (0 == dataCnt() or not isCalibrated() or isProfileMismatch())
+        return std::nullopt;
+    return data_->trackDrift(subjectBuild(), jitter_, baselineAvg, adaptDrift);
+}
+
+
+/** @remark to be performed prior to any suite statistics or platform model fit */
+Timings::Quarantine Timings::updateQuarantine()
+{
+    return data_->updateQuarantine(baselineAvg);
+}
+
+
+/** @remark only groups of at least MIN_CLUSTER_SIZE test cases are considered */
+std::vector<Timings::ClusterShift> Timings::calcClusterShifts()  const
+{
+    return data_->calcClusterShifts(MIN_CLUSTER_SIZE);
+}
+
+
 void Timings::saveData(bool includingCalibration)
 {
     // tests have navigated down into the tree;
@@ -510,6 +1193,63 @@ array<double,3> Timings::getDeltaStatistics()  const
 }
 
 
+/** @return build of the subject configured for the Testsuite, as used for the suite statistics */
+BuildInfo const& Timings::subjectBuild()  const
+{
+    return subjectBuild(subject_);
+}
+
+/** @remark a test case may define its own `Test.subject`; each executable
+ *          is inspected lazily, since only relevant when timings are measured */
+BuildInfo const& Timings::subjectBuild(fs::path subject)  const
+{
+    auto pos = builds_.find(subject);
+    if (pos == builds_.end())
+        pos = builds_.emplace(subject, BuildInfo::inspect(subject)).first;
+    return pos->second;
+}
+
+/** @return profile of the subject build used for the current platform calibration */
+string Timings::calibrationProfile()  const
+{
+    return data_->getCalibrationProfile();
+}
+
+/** the platform model was calibrated with a differently optimised build */
+bool Timings::isProfileMismatch()  const
+{
+    return isProfileMismatch(subjectBuild());
+}
+
+bool Timings::isProfileMismatch(BuildInfo const& build)  const
+{
+    return isCalibrated()
+       and not BuildInfo::isComparable(build.profile, calibrationProfile());
+}
+
+
+void Timings::setJitter(double score)
+{
+    jitter_ = score;
+}
+
+/**
+ * @return factor to scale timing tolerances, relating the jitter probed for the
+ *         current run to the jitter seen when the platform model was calibrated;
+ *         neutral (1.0) when either is unknown.
+ * @remark the factor is clamped: a very quiet run shall not tighten tolerances
+ *         below the actual measurement noise, and a very noisy run should rather
+ *         be flagged by the SystemWatch than be excused by wide tolerances.
+ */
+double Timings::jitterFactor()  const
+{
+    double reference = data_->getCalibrationJitter();
+    if (jitter_ <= 0.0 or reference <= 0.0)
+        return 1.0;
+    return std::clamp(jitter_ / reference, JITTER_FACTOR_MIN, JITTER_FACTOR_MAX);
+}
+
+
 size_t Timings::dataCnt()  const
 {
     return data_->dataCnt();
@@ -29,6 +29,10 @@
  ** points observed in the testcases, because each local TimingObservation
  ** hooks itself into this global Timings aggregator.
  ** 
+ ** Test cases with inherently unstable runtime would dominate the error propagation
+ ** of the suite statistics and distort the platform model; such cases are _quarantined_
+ ** automatically, while still judged individually against their own tolerance band.
+ ** 
  ** @todo WIP as of 9/21
  ** @see [setup and wiring](\ref setup::build(Config const&))
  ** @see TimingObservation.hpp
@@ -42,11 +46,17 @@
 
 #include "Config.hpp"
 #include "util/nocopy.hpp"
+#include "suite/BuildInfo.hpp"
+#include "suite/ExpensePredictor.hpp"
 
 #include <functional>
 #include <string>
+#include <optional>
 #include <memory>
+#include <vector>
 #include <array>
+#include <map>
+#include <cmath>
 
 
 namespace suite {
@@ -68,14 +78,20 @@ class TimingTest
 {
 
 protected:
-    TimingTest(string testID)
+    TimingTest(string testID, fs::path topic, string engine, bool platformRef =true)
         : testID{testID}
+        , topic{topic}
+        , engine{engine}
+        , platformRef{platformRef}
     { }
 
 public:
     virtual ~TimingTest() { }  ///< this is an interface
 
     const string testID;
+    const fs::path topic;   ///< test case path relative to the Testsuite root
+    const string engine;    ///< synth engine(s) used by the test script, e.g. "PAD"
+    const bool platformRef; ///< contributes to the platform model fit and drift tracking
 
     /// Abstracted Data point: `(samples,runtime,expense)`
     using Point = std::tuple<double,double,double>;
@@ -85,6 +101,7 @@ public:
 
     virtual Point getAveragedDataPoint(size_t avgPoints)  const =0;
     virtual Error getAveragedError(size_t avgPoints)      const =0;
+    virtual bool isDisturbed()                            const =0; ///< current measurement contaminated?
     virtual void recalc_and_save_current(PlatformFun)           =0;
 };
 
@@ -98,8 +115,11 @@ class Timings
     : util::NonCopyable
 {
     PData data_;
+    fs::path subject_;
+    mutable std::map<fs::path, BuildInfo> builds_;
+    std::unique_ptr<ExpensePredictor> predictor_;
 
-    Timings(fs::path, uint,uint,uint,uint);
+    Timings(fs::path, fs::path, uint,uint,uint,uint, double, bool, bool);
 public:
    ~Timings();
     static PTimings setup(Config const&);
@@ -115,9 +135,55 @@ public:
     string sumariseCalibration() const;
     double getModelTolerance() const;
 
+    BuildInfo const& subjectBuild()  const;
+    BuildInfo const& subjectBuild(fs::path subject)  const;
+    string calibrationProfile()  const;
+    bool isProfileMismatch()  const;
+    bool isProfileMismatch(BuildInfo const&)  const;
+
+    void setJitter(double score);
+    double getJitter()  const { return jitter_; }
+    double jitterFactor()  const;
+
     void calcSuiteStatistics();
     array<double,3> getDeltaStatistics()  const;
 
+    /** cases excluded from suite statistics and platform model, due to unstable runtime */
+    struct Quarantine
+    {
+        std::vector<string> entered;   ///< excluded since this run
+        std::vector<string> released;  ///< stabilised, and thus included again
+        std::vector<string> current;   ///< all excluded cases, with their stability score
+    };
+    Quarantine updateQuarantine();
+
+    /** provisional expense for a case without baseline, estimated from similar cases */
+    using Prediction = ExpensePredictor::Prediction;
+    std::optional<Prediction> predictExpense(TimingTest const&, double platform);
+
+    /** collective timing shift of a group of related test cases */
+    struct ClusterShift
+    {
+        string group;            ///< topic subtree (`dir/`) or `engine:<ID>`
+        size_t cases{0};
+        double shift{0.0};       ///< relative Δ of this group, against the rest of the suite
+        double tolerance{0.0};   ///< ~ 3·σ by error propagation, widened for the number of groups tested
+
+        bool isSignificant()  const { return tolerance < fabs(shift); }
+    };
+    std::vector<ClusterShift> calcClusterShifts()  const;
+
+    /** gradual change of the platform, tracked online since the last calibration */
+    struct PlatformDrift
+    {
+        uint runs{0};             ///< Testsuite runs tracked against the current platform model
+        double drift{0.0};        ///< relative deviation of the tracked estimate from the platform model
+        double tolerance{0.0};    ///< ~ 3·σ of the tracked estimate
+        bool significant{false};
+        bool recalibrated{false}; ///< the tracked estimate was adopted as new platform model
+    };
+    std::optional<PlatformDrift> trackPlatformDrift();
+
     struct SuiteStatistics
     {
         double currAvgDelta{0.0};
@@ -141,6 +207,12 @@ public:
     const uint baselineKeep;  ///< number of past baseline definitions to retain
     const uint baselineAvg;   ///< number of past measurements to average for baseline decisions
     const uint longtermAvg;   ///< number of past measurements to average for long term trends
+    const double contaminationLimit; ///< measurements taken under heavier system disturbance are discounted
+    const bool adaptDrift;    ///< adopt significant platform drift as new platform model
+    const bool filteredRun;   ///< only a selection of the Testsuite is performed
+
+private:
+    double jitter_;           ///< platform jitter score probed at start of this run (0 = not probed)
 };
 
 
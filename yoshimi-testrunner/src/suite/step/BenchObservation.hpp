@@ -0,0 +1,141 @@
+/*
+ *  BenchObservation - extract metrics reported by a benchmark command
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file BenchObservation.hpp
+ ** Extract the metrics reported by an arbitrary benchmark command (`Test.type=BENCH`).
+ ** Each metric is declared with a regular expression, where the first capture group
+ ** yields the numeric value; the last matching line of output is used. The values are
+ ** converted to nanoseconds with the declared unit, and exposed as TimingSource each,
+ ** to be processed by the usual TimingObservation / TimingJudgement / PersistTimings.
+ ** Since a benchmark computes no sound, the declared number of samples is used as
+ ** input for the platform model, which scales the expectation for the metric.
+ **
+ ** @see OutputObservation.hpp
+ ** @see setup::BenchMould
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_BENCH_OBSERVATION_HPP_
+#define TESTRUNNER_SUITE_STEP_BENCH_OBSERVATION_HPP_
+
+
+#include "util/error.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/step/Invocation.hpp"
+#include "suite/step/OutputObservation.hpp"
+
+#include <optional>
+#include <utility>
+#include <vector>
+#include <string>
+
+namespace suite{
+namespace step {
+
+using std::string;
+using std::optional;
+
+using MetricDefs = std::vector<std::pair<string,string>>;
+
+
+/**
+ * Retrieve the declared metrics from the output of a benchmark command.
+ */
+class BenchObservation
+    : public TestStep
+{
+public:
+    /** a single metric, observed as timing measurement */
+    class Metric
+        : public TimingSource
+    {
+        optional<double> value_;
+        size_t samples_;
+
+        friend class BenchObservation;
+
+    public:
+        const string name;
+        const regex pattern;
+
+        Metric(string metricName, string regExp, size_t samples)
+            : value_{}
+            , samples_{samples}
+            , name{metricName}
+            , pattern{regExp, regex::optimize}
+        { }
+
+        double getRuntime()  const override { return *value_;  }
+        uint   getNotesCnt() const override { return 0;         }
+        size_t getSamples()  const override { return samples_;  }
+        bool   wasCaptured() const override { return value_.has_value(); }
+    };
+
+private:
+    Invocation& theTest_;
+    double nanosPerUnit_;
+    std::vector<Metric> metrics_;
+
+
+    Result perform()  override
+    {
+        if (not theTest_.isPerformed())
+            return Result::Warn("Skip BenchObservation");
+
+        string missing;
+        for (Metric& metric : metrics_)
+        {
+            smatch mat = theTest_.grepOutput(metric.pattern);
+            if (mat.empty() or not mat[1].matched)
+                missing += " "+metric.name;
+            else
+                metric.value_ = util::parseAs<double>(mat[1]) * nanosPerUnit_;
+        }
+        if (not util::isnil(missing))
+            return Result{ResCode::MALFUNCTION, "Metrics not reported by the benchmark:"+missing};
+        return Result::OK();
+    }
+
+public:
+    BenchObservation(Invocation& invocation
+                    ,MetricDefs const& definitions
+                    ,string unit
+                    ,size_t samples)
+        : theTest_{invocation}
+        , nanosPerUnit_{unit=="ns"? 1.0 : unit=="us"? 1e3 : unit=="ms"? 1e6 : unit=="s"? 1e9 : 0.0}
+        , metrics_{}
+    {
+        if (nanosPerUnit_ == 0.0)
+            throw error::Misconfig("Unknown unit "+util::formatVal(unit)+" for benchmark metrics (ns|us|ms|s)");
+        metrics_.reserve(definitions.size());
+        for (auto& [name,pattern] : definitions)
+            metrics_.emplace_back(name, pattern, samples);
+    }
+
+    /** @note stable storage: the TimingObservation of each metric refers to these */
+    std::vector<Metric>& metrics()  { return metrics_; }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_BENCH_OBSERVATION_HPP_*/
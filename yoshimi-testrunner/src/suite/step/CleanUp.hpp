@@ -40,6 +40,7 @@
 #include "suite/TestStep.hpp"
 #include "suite/step/Scaffolding.hpp"
 #include "suite/step/SoundObservation.hpp"
+#include "suite/step/SystemWatch.hpp"
 #include "suite/Progress.hpp"
 #include "suite/Result.hpp"
 
@@ -61,11 +62,14 @@ class CleanUp
     Progress& progressLog_;
 
     MaybeRef<SoundObservation> soundProbe_;
+    MaybeRef<SystemWatch> systemWatch_;
 
 
     Result perform()  override
     try {
         scaffolding_.cleanUp();
+        if (systemWatch_)
+            systemWatch_->conclude();
         progressLog_.clearLog();
         if (soundProbe_)
             soundProbe_->discardStorage();
@@ -83,10 +87,12 @@ class CleanUp
 public:
     CleanUp(Scaffolding& scaffolding
            ,MaybeRef<SoundObservation> sound
+           ,MaybeRef<SystemWatch> systemWatch
            ,Progress& progressLog)
         : scaffolding_{scaffolding}
         , progressLog_{progressLog}
         , soundProbe_{sound}
+        , systemWatch_{systemWatch}
     { }
 };
 
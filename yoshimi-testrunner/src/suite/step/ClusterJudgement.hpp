@@ -0,0 +1,98 @@
+/*
+ *  ClusterJudgement - detect collective timing shifts within groups of test cases
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file ClusterJudgement.hpp
+ ** Spot timing regressions affecting a group of related test cases collectively.
+ ** A change in some specific part of Yoshimi, e.g. the analog filter code, typically
+ ** slows down a whole set of test cases by a small amount, which might well remain
+ ** within the tolerance band of each individual case. However, these cases are usually
+ ** organised into a common topic subtree, or they use the same synth engine. Thus the
+ ** relative Δ of the cases in such a group is averaged and compared to the remainder
+ ** of the suite; by error propagation, the tolerance of the group average is much
+ ** narrower than the individual tolerances, allowing to detect such a shift.
+ **
+ ** @see Timings::calcClusterShifts()
+ ** @see TrendJudgement.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_CLUSTER_JUDGEMENT_HPP_
+#define TESTRUNNER_SUITE_STEP_CLUSTER_JUDGEMENT_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/format.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+#include <cmath>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Step to assess collective timing shifts of related test cases.
+ * @remark precondition is a calibrated platform model and established
+ *         baselines; otherwise TrendJudgement already flagged the problem.
+ */
+class ClusterJudgement
+    : public TestStep
+{
+    Progress& progressLog_;
+    suite::PTimings timings_;
+
+
+    Result perform()  override
+    {
+        if (0 == timings_->dataCnt() or not timings_->isCalibrated()
+            or timings_->isProfileMismatch())
+            return Result::OK();
+
+        string findings;
+        for (auto& cluster : timings_->calcClusterShifts())
+        {
+            string msg = cluster.group+" "+util::formatPercent(cluster.shift)
+                       +" ±"+util::formatPercent(cluster.tolerance).substr(1)
+                       +" ("+formatVal(cluster.cases)+" cases)";
+            progressLog_.out("Cluster: "+msg);
+            if (cluster.isSignificant())
+                findings += (isnil(findings)? "":"; ") + msg;
+        }
+        if (isnil(findings))
+            return Result::OK();
+        return Result::Warn("Collective timing shift against the rest of the suite: "+findings);
+    }
+
+
+public:
+    ClusterJudgement(Progress& log
+                    ,suite::PTimings globalTimings)
+        : progressLog_{log}
+        , timings_{globalTimings}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_CLUSTER_JUDGEMENT_HPP_*/
@@ -0,0 +1,218 @@
+/*
+ *  DiffProfile - test steps for differential profiling against a reference build
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file DiffProfile.cpp
+ ** Implementation of the differential profiling steps.
+ ** The subject is sampled every 250µs of CPU time per thread; the ring buffers are drained
+ ** every 20ms, which also picks up threads started meanwhile. Time per function is computed
+ ** as share of the samples of this invocation, multiplied with the reported runtime; thus
+ ** differences in the platform speed between invocations are largely cancelled out.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "suite/step/DiffProfile.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using util::formatVal;
+using util::Column;
+using util::SamplingProfiler;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const auto SAMPLING_INTERVAL = std::chrono::milliseconds(20);
+    const uint64_t SAMPLING_PERIOD_ns = 250000;
+    const size_t LOG_FUNCTIONS = 5;
+}
+
+/**
+ * Data storage for the per-function differences of the latest profiling run.
+ */
+struct TableProfile
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>    function{"Function"};           ///< demangled name, or [file] if no symbol found
+    Column<double>     refSelf{"Ref self ms"};        ///< time with the reference executing this function
+    Column<double>    candSelf{"Cand self ms"};       ///< time with the candidate executing this function
+    Column<double>       delta{"Delta ms"};           ///< candidate - reference (self)
+    Column<double>    refTotal{"Ref total ms"};       ///< time with this function on the call stack (reference)
+    Column<double>   candTotal{"Cand total ms"};      ///< time with this function on the call stack (candidate)
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,function
+                       ,refSelf
+                       ,candSelf
+                       ,delta
+                       ,refTotal
+                       ,candTotal
+                       );
+    }
+};
+
+using ProfileData = util::DataFile<TableProfile>;
+
+
+
+ProfileSampling::~ProfileSampling()
+{
+    conclude();
+}
+
+
+Result ProfileSampling::perform()
+{
+    conclude(); // safety: never run two samplers
+    profile_ = util::Profile{};
+    int pid = launcher_.subjectPID();
+    if (0 == pid)
+        return Result::Warn("Skip ProfileSampling: subject not running locally");
+    profiler_.reset(new SamplingProfiler{pid, SAMPLING_PERIOD_ns});
+    permitted_ = profiler_->permitted();
+    active_ = true;
+    sampler_ = std::thread([this]{ sampleLoop(); });
+    return Result::OK();
+}
+
+
+util::Profile const& ProfileSampling::conclude()
+{
+    {
+        std::lock_guard<std::mutex> guard{lock_};
+        if (not active_) return profile_;
+        active_ = false;
+    }
+    stopSignal_.notify_all();
+    if (sampler_.joinable())
+        sampler_.join();
+    profile_ = profiler_->conclude();
+    permitted_ = profiler_->permitted();
+    profiler_.reset();
+    return profile_;
+}
+
+
+void ProfileSampling::sampleLoop()
+{
+    std::unique_lock<std::mutex> guard{lock_};
+    while (not stopSignal_.wait_for(guard, SAMPLING_INTERVAL, [this]{ return not active_; }))
+    {
+        guard.unlock();
+        profiler_->sample();
+        guard.lock();
+    }
+}
+
+
+
+Result ProfileCapture::perform()
+{
+    functions_.clear();
+    auto& profile = sampling_.conclude();
+    if (not sampling_.permitted())
+        return Result::Warn("Skip ProfileCapture: perf_event_open() denied; "
+                            "see /proc/sys/kernel/perf_event_paranoid");
+    if (not output_.wasCaptured() or 0 == profile.samples)
+        return Result::Warn("Skip ProfileCapture: no samples or no runtime captured.");
+
+    runtime_ms_ = output_.getRuntime() / 1e6;
+    double msPerSample = runtime_ms_ / profile.samples;
+    for (util::FunctionCost const& cost : profile.functions)
+        functions_[cost.function] = Timing{cost.self * msPerSample, cost.total * msPerSample};
+    if (0 < profile.lost)
+        return Result::Warn("Profile incomplete: "+formatVal(profile.lost)+" samples lost.");
+    return Result::OK();
+}
+
+
+
+/** @remark rounds without captured profile are disregarded */
+Result DiffProfile::perform()
+{
+    std::map<string, FunctionDelta> functions;
+    auto accumulate = [&](ProfileRuns const& runs, bool isRef) -> std::pair<uint,double>
+                        {
+                            uint rounds{0};
+                            double runtime{0};
+                            for (ProfileCapture const& run : runs)
+                                if (run.isCaptured())
+                                {
+                                    ++rounds;
+                                    runtime += run.runtime_ms();
+                                }
+                            for (ProfileCapture const& run : runs)
+                                if (run.isCaptured())
+                                    for (auto& [fun,timing] : run.functions())
+                                    {
+                                        FunctionDelta& entry = functions[fun];
+                                        entry.function = fun;
+                                        (isRef? entry.refSelf_ms  : entry.candSelf_ms)  += timing.self_ms / rounds;
+                                        (isRef? entry.refTotal_ms : entry.candTotal_ms) += timing.total_ms / rounds;
+                                    }
+                            return {rounds, rounds? runtime/rounds : 0.0};
+                        };
+    auto [refRounds, refRuntime]   = accumulate(reference_, true);
+    auto [candRounds, candRuntime] = accumulate(candidate_, false);
+    if (0 == refRounds or 0 == candRounds)
+        return Result::Warn("Skip DiffProfile: no profile captured for "
+                           +string{0 == refRounds? "reference":"candidate"});
+
+    std::vector<FunctionDelta> deltas;
+    for (auto& [fun,entry] : functions)
+        deltas.push_back(entry);
+    std::sort(deltas.begin(), deltas.end()
+             ,[](FunctionDelta const& d1, FunctionDelta const& d2)
+               { return std::fabs(d1.delta()) > std::fabs(d2.delta()); });
+
+    ProfileData data{pathSpec_[def::KEY_fileProfile]};
+    for (auto entry = deltas.rbegin(); entry != deltas.rend(); ++entry)
+    {// newest row is stored first: thus the largest difference comes on top
+        data.newRow();
+        data.timestamp = Config::timestamp;
+        data.function  = entry->function;
+        data.refSelf   = entry->refSelf_ms;
+        data.candSelf  = entry->candSelf_ms;
+        data.delta     = entry->delta();
+        data.refTotal  = entry->refTotal_ms;
+        data.candTotal = entry->candTotal_ms;
+    }
+    data.save(deltas.size());
+
+    progressLog_.out("Profile: runtime "+formatVal(refRuntime)+"ms (reference) → "+formatVal(candRuntime)+"ms");
+    for (size_t i=0; i < deltas.size() and i < LOG_FUNCTIONS; ++i)
+        progressLog_.out("Profile: "+string{deltas[i].delta() > 0? "+":""}+formatVal(deltas[i].delta())
+                        +"ms "+deltas[i].function);
+
+    profileDiff_->record(pathSpec_.getTopic(), refRuntime, candRuntime, move(deltas));
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,202 @@
+/*
+ *  DiffProfile - test steps for differential profiling against a reference build
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file DiffProfile.hpp
+ ** Test steps to profile interleaved invocations of reference and candidate subject.
+ ** Each profiled invocation is accompanied by a ProfileSampling, which attaches the
+ ** util::SamplingProfiler after launch, and a ProfileCapture, which concludes sampling
+ ** after the test and converts the samples into time per function, using the runtime
+ ** reported by this invocation. The DiffProfile finally averages over the rounds,
+ ** compares reference and candidate, and stores the table in `<TestID>-profile.csv`.
+ **
+ ** @see ProfileDiff.hpp
+ ** @see setup::ExeCliMould
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_DIFF_PROFILE_HPP_
+#define TESTRUNNER_SUITE_STEP_DIFF_PROFILE_HPP_
+
+
+#include "util/profiler.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/ProfileDiff.hpp"
+#include "suite/step/Scaffolding.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/OutputObservation.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Sample call chains of the subject in the background,
+ * starting after launch, prior to the test invocation.
+ * @note #conclude must be called after the test invocation
+ *       to stop the sampling thread and retrieve the profile.
+ */
+class ProfileSampling
+    : public TestStep
+{
+    Scaffolding& launcher_;
+
+    std::unique_ptr<util::SamplingProfiler> profiler_;
+    std::thread sampler_;
+    std::mutex lock_;
+    std::condition_variable stopSignal_;
+    bool active_{false};
+    bool permitted_{true};
+
+    util::Profile profile_;
+
+    Result perform()  override;
+
+public:
+   ~ProfileSampling();
+    ProfileSampling(Scaffolding& launcher)
+        : launcher_{launcher}
+    { }
+
+    /** stop sampling (idempotent)
+     * @return samples attributed to functions */
+    util::Profile const& conclude();
+
+    bool permitted()  const { return permitted_; }
+
+private:
+    void sampleLoop();
+};
+
+
+
+/**
+ * Conclude the profile of a single invocation and
+ * convert the samples into time spent per function.
+ */
+class ProfileCapture
+    : public TestStep
+{
+public:
+    struct Timing
+    {
+        double self_ms{0};
+        double total_ms{0};
+    };
+
+private:
+    ProfileSampling& sampling_;
+    OutputObservation& output_;
+
+    double runtime_ms_{0};
+    std::map<string, Timing> functions_;
+
+    Result perform()  override;
+
+public:
+    ProfileCapture(ProfileSampling& sampling
+                  ,OutputObservation& output)
+        : sampling_{sampling}
+        , output_{output}
+    { }
+
+    bool isCaptured()  const { return not functions_.empty(); }
+    double runtime_ms()  const { return runtime_ms_; }
+    std::map<string, Timing> const& functions()  const { return functions_; }
+};
+
+using ProfileRuns = std::vector<std::reference_wrapper<ProfileCapture>>;
+
+
+
+/**
+ * Compare the profiles of reference and candidate, averaged over the rounds;
+ * store the per-function differences and hand them over to the suite::ProfileDiff.
+ */
+class DiffProfile
+    : public TestStep
+{
+    ProfileRuns reference_;
+    ProfileRuns candidate_;
+    PathSetup& pathSpec_;
+    PProfileDiff profileDiff_;
+    Progress& progressLog_;
+
+    Result perform()  override;
+
+public:
+    DiffProfile(ProfileRuns reference
+               ,ProfileRuns candidate
+               ,PathSetup& pathSetup
+               ,PProfileDiff profileDiff
+               ,Progress& progressLog)
+        : reference_{move(reference)}
+        , candidate_{move(candidate)}
+        , pathSpec_{pathSetup}
+        , profileDiff_{profileDiff}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+
+/**
+ * Write the summary of all differential profiles at the end of the Testsuite.
+ */
+class PersistProfileDiff
+    : public TestStep
+{
+    PProfileDiff profileDiff_;
+    Progress& progressLog_;
+
+
+    Result perform()  override
+    try {
+        profileDiff_->save();
+        progressLog_.note("Profile: "+profileDiff_->describe());
+        return Result::OK();
+    }
+    catch(error::State& writeFailure)
+    {
+        return Result::Warn(string{"Unable to store differential profile -- "}
+                           + writeFailure.what());
+    }
+
+public:
+    PersistProfileDiff(PProfileDiff profileDiff
+                      ,Progress& progressLog)
+        : profileDiff_{profileDiff}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_DIFF_PROFILE_HPP_*/
@@ -0,0 +1,85 @@
+/*
+ *  JitterProbe - estimate the current platform jitter at start of the Testsuite
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file JitterProbe.hpp
+ ** Probe the timing jitter of the execution platform, prior to running any test case.
+ ** Tolerances for timing judgements are derived from past fluctuations, which reflect
+ ** the _typical_ noise of the platform. On a day when the machine is noisier than usual,
+ ** many cases would drift beyond their tolerance, while on a very quiet machine, small
+ ** regressions remain hidden within the band. Thus the jitter score probed here is set
+ ** into the global Timings, where it is related to the score seen at calibration time,
+ ** to widen or narrow the tolerances accordingly.
+ **
+ ** @see util::probePlatformJitter()
+ ** @see Timings::jitterFactor()
+ ** @see TimingJudgement.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_JITTER_PROBE_HPP_
+#define TESTRUNNER_SUITE_STEP_JITTER_PROBE_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/format.hpp"
+#include "util/jitter.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Step to run the jitter probe and to record the
+ * resulting score for the current Testsuite run.
+ */
+class JitterProbe
+    : public TestStep
+{
+    Progress& progressLog_;
+    suite::PTimings timings_;
+
+
+    Result perform()  override
+    {
+        util::Jitter jitter = util::probePlatformJitter();
+        timings_->setJitter(jitter.score());
+        progressLog_.out("JitterProbe: "+jitter.describe()
+                        +", tolerance ×"+formatVal(timings_->jitterFactor()));
+        return Result::OK();
+    }
+
+
+public:
+    JitterProbe(Progress& log
+               ,suite::PTimings globalTimings)
+        : progressLog_{log}
+        , timings_{globalTimings}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_JITTER_PROBE_HPP_*/
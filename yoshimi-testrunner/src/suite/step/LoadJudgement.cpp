@@ -0,0 +1,190 @@
+/*
+ *  LoadJudgement - assess instrument load times against past measurements
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file LoadJudgement.cpp
+ ** Implementation of load time persistence and assessment.
+ ** The reference for each file is determined _before_ appending the current
+ ** measurement; at least MIN_REFERENCE_POINTS past measurements are required,
+ ** otherwise the load time is only recorded. The corpus total decides upon
+ ** failure, while deviations of individual files only raise a warning,
+ ** since single loads are short and thus more susceptible to jitter.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/LoadJudgement.hpp"
+#include "Config.hpp"
+
+#include <cmath>
+#include <vector>
+
+using util::formatVal;
+using util::Column;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const string CORPUS_TOTAL{"(corpus)"};
+    const uint MIN_REFERENCE_POINTS = 3;
+    const double MIN_TOLERANCE = 0.02;   // relative to average load time
+}
+
+/**
+ * Data storage for load time measurement time series.
+ * Each run adds one row per corpus file, plus the corpus total.
+ */
+struct TableLoadTime
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>        file{"File"};               ///< name of the loaded file, or `(corpus)` for the total
+    Column<double>      loadMs{"Load ms"};            ///< load time in milliseconds (averaged over repetitions)
+    Column<uint>   repetitions{"Repetitions"};
+    Column<double>   tolerance{"Tolerance"};          ///< tolerance band 3·σ of past measurements (0 = not yet established)
+    Column<double>   contamination{"Contamination"};  ///< system disturbance observed during measurement (0 = quiet)
+    Column<string>     buildID{"Build-ID"};           ///< GNU build-id of the subject (abbreviated)
+    Column<string>     profile{"Profile"};            ///< build profile (optimisation level) of the subject
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,file
+                       ,loadMs
+                       ,repetitions
+                       ,tolerance
+                       ,contamination
+                       ,buildID
+                       ,profile
+                       );
+    }
+};
+
+using LoadTimeData = util::DataFile<TableLoadTime>;
+
+
+namespace {
+    struct Reference
+    {
+        double avg{0.0};
+        double tolerance{0.0};
+        operator bool()  const { return 0.0 < tolerance; }
+    };
+
+    /** establish the reference for one file from past, undisturbed measurements */
+    Reference pastReference(LoadTimeData const& data, string const& file, string const& profile
+                           ,uint avgPoints, double contaminationLimit)
+    {
+        std::vector<double> past;
+        for (size_t i = data.size(); 0 < i and past.size() < avgPoints; --i)
+            if (data.file.data[i-1] == file
+                and data.contamination.data[i-1] <= contaminationLimit
+                and BuildInfo::isComparable(profile, data.profile.data[i-1]))
+                past.push_back(data.loadMs.data[i-1]);
+        if (past.size() < MIN_REFERENCE_POINTS)
+            return Reference{};
+        double avg = util::averageLastN(past, past.size());
+        double sdev = util::sdev(past, avg);
+        return Reference{avg, std::max(3*sdev, MIN_TOLERANCE*avg)};
+    }
+}
+
+
+
+Result LoadJudgement::perform()
+{
+    if (not loads_.isPerformed())
+        return Result::Warn("Skip LoadJudgement");
+
+    double contamination = systemWatch_? systemWatch_->conclude() : 0.0;
+    BuildInfo const& build = globalTimings_->subjectBuild(subject_);
+    uint avgPoints = globalTimings_->baselineAvg;
+    double contaminationLimit = globalTimings_->contaminationLimit;
+
+    auto loadTimes = loads_.getLoadTimes();
+    LoadTimeData data{pathSpec_[def::KEY_fileLoadtime]};
+
+    auto record = [&](string const& file, double ms, Reference const& ref)
+                    {
+                        data.newRow();
+                        data.timestamp = Config::timestamp;
+                        data.file = file;
+                        data.loadMs = ms;
+                        data.repetitions = loads_.getRepetitions();
+                        data.tolerance = ref.tolerance;
+                        data.contamination = contamination;
+                        data.buildID = build.buildID;
+                        data.profile = build.profile;
+                    };
+
+    string slowerFiles;
+    double total = 0.0;
+    std::vector<std::pair<string,Reference>> refs;
+    for (auto& [file,ms] : loadTimes)
+        refs.emplace_back(file, pastReference(data, file, build.profile, avgPoints, contaminationLimit));
+    Reference corpusRef = pastReference(data, CORPUS_TOTAL, build.profile, avgPoints, contaminationLimit);
+    for (auto& [file,ref] : refs)
+    {
+        double ms = loadTimes[file];
+        total += ms;
+        record(file, ms, ref);
+        if (ref and ref.tolerance < ms - ref.avg)
+            slowerFiles += " "+file+"(+"+formatVal(100*(ms - ref.avg)/ref.avg)+"%)";
+    }
+    record(CORPUS_TOTAL, total, corpusRef);
+    data.save(globalTimings_->timingsKeep * (loadTimes.size()+1));
+    loadTime_ = total;
+
+    Result judgement = [&]{
+        if (globalTimings_->isProfileMismatch(build))
+            return Result::Warn("Subject build profile "+formatVal(build.profile)
+                               +" differs from calibration. Load time ("+formatVal(total)+"ms) not judged");
+        if (contaminationLimit < contamination)
+            return Result::Warn("System disturbed during measurement (contamination="+formatVal(contamination)
+                               +"). Load time ("+formatVal(total)+"ms) not judged and excluded from statistics");
+        if (not corpusRef)
+            return Result::Warn("Establishing load time baseline. Corpus load time ("+formatVal(total)+"ms) not judged");
+
+        double delta = total - corpusRef.avg;
+        double tolerance = corpusRef.tolerance;
+        if (delta < -tolerance)
+            return Result::Warn("Load time "+formatVal(total)
+                               +"ms decreased by "+formatVal(100*delta / corpusRef.avg)+"% below average; Δ ="+formatVal(delta)+"ms");
+        if (tolerance < delta and delta <= 1.1 * tolerance)
+            return Result::Warn("Load time ("+formatVal(total)+"ms) slightly above average; Δ = "+formatVal(delta)+"ms");
+        if (tolerance < delta)
+            return Result::Fail("Test failed: Load time +"+formatVal(100*delta / corpusRef.avg)
+                               +"% above average; Δ = "+formatVal(delta)
+                               +"ms Load time="+formatVal(total)+"ms.");
+        if (not util::isnil(slowerFiles))
+            return Result::Warn("Individual files load slower:"+slowerFiles);
+        return Result::OK();
+    }();
+
+    succeeded = (ResCode::GREEN == judgement.code);
+    resCode = judgement.code;
+    msg_ = succeeded? "load time OK" : judgement.summary;
+    return judgement;
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,96 @@
+/*
+ *  LoadJudgement - assess instrument load times against past measurements
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file LoadJudgement.hpp
+ ** Persist and judge the load times captured by a LoadSequence.
+ ** Load times of each corpus file, together with the summed time for the whole
+ ** corpus (recorded as file `(corpus)`), are appended as time series to the file
+ ** `<TestID>-loadtime.csv` in the test directory. Since load times do not scale with
+ ** the sample count, the platform model is not applicable; rather, each new measurement
+ ** is compared against the average of past measurements of the same file, using a
+ ** tolerance band of 3σ observed over the last `baselineAvg` data points — the same
+ ** scheme as applied for the tolerance of regular timing tests. Measurements taken
+ ** on a disturbed system or with a differing build profile are not used as reference.
+ **
+ ** @see LoadSequence.hpp
+ ** @see TimingJudgement.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_LOAD_JUDGEMENT_HPP_
+#define TESTRUNNER_SUITE_STEP_LOAD_JUDGEMENT_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/LoadSequence.hpp"
+#include "suite/step/SystemWatch.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Step to record the load times of a corpus and to judge them
+ * against the tolerance band established by past measurements.
+ */
+class LoadJudgement
+    : public TestStep
+{
+    PathSetup& pathSpec_;
+    LoadSequence& loads_;
+    MaybeRef<SystemWatch> systemWatch_;
+    suite::PTimings globalTimings_;
+    fs::path subject_;
+    string msg_{"unknown load time result"};
+    double loadTime_{0.0};
+
+    Result perform()  override;
+
+public:
+    LoadJudgement(PathSetup& pathSetup
+                 ,LoadSequence& loads
+                 ,MaybeRef<SystemWatch> systemWatch
+                 ,suite::PTimings aggregator
+                 ,fs::path subject)
+        : pathSpec_{pathSetup}
+        , loads_{loads}
+        , systemWatch_{systemWatch}
+        , globalTimings_{aggregator}
+        , subject_{subject}
+    { }
+
+    bool succeeded = false;
+    ResCode resCode = ResCode::MALFUNCTION;
+
+    string describe()    const { return msg_; }
+    double getLoadTime() const { return loadTime_; }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_LOAD_JUDGEMENT_HPP_*/
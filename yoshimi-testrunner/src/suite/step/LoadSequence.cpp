@@ -0,0 +1,159 @@
+/*
+ *  LoadSequence - load a corpus of instruments and measure load times
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file LoadSequence.cpp
+ ** Implementation of timed instrument loading via Yoshimi CLI.
+ ** For each file a tiny script is sent: select the part, issue the `load` command
+ ** and then return to top level. The echo of this last command marks completion,
+ ** since Yoshimi handles CLI input strictly in sequence.
+ **
+ */
+
+
+#include "Config.hpp"
+#include "suite/step/LoadSequence.hpp"
+#include "suite/step/Script.hpp"
+#include "util/format.hpp"
+#include "util/parse.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+using util::formatVal;
+using util::parseAs;
+
+namespace suite{
+namespace step {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    bool isCorpusFile(fs::path const& file)
+    {
+        return fs::is_regular_file(file)
+           and (file.extension() == def::EXT_INSTRUMENT
+                or file.extension() == def::EXT_PATCHSET);
+    }
+
+    /** CLI script to load a single file and then
+     *  to provoke an echo once the load is complete */
+    class LoadScript
+        : public Script
+    {
+        static string buildCode(uint part, fs::path const& file)
+        {
+            string load = file.extension() == def::EXT_PATCHSET? def::CLI_LOAD_PATCHSET
+                                                                 : def::CLI_LOAD_INSTRUMENT;
+            return def::CLI_SELECT_PART+" "+formatVal(part)+"\n"
+                 + load+" "+file.string()+"\n"
+                 + def::CLI_TOPLEVEL;
+        }
+
+    public:
+        LoadScript(uint part, fs::path const& file)
+            : Script{buildCode(part, file)}
+        { }
+
+        string markWhenSriptIsFinished()  const override { return def::YOSHIMI_ECHO_TOPLEVEL_PATTERN; }
+        string markWhenScriptIsComplete() const override { return def::YOSHIMI_ECHO_LOAD_PATTERN; }
+    };
+}
+
+
+
+LoadSequence::LoadSequence(ExeLauncher& launcher
+                          ,fs::path corpusDir
+                          ,string repetitions
+                          ,string parts
+                          ,Progress& progress)
+    : launcher_{launcher}
+    , progressLog_{progress}
+    , corpus_{corpusDir}
+    , repetitions_{parseAs<uint>(repetitions)}
+    , parts_{parseAs<uint>(parts)}
+    , loadTimes_{}
+{
+    if (repetitions_ < 1 or parts_ < 1 or 16 < parts_)
+        throw error::Misconfig("Instrument load test requires at least one repetition "
+                               "and 1..16 parts, not "+formatVal(repetitions)+" / "+formatVal(parts));
+}
+
+
+/** @return corpus files sorted by name; empty if the corpus is missing */
+std::vector<fs::path> LoadSequence::findCorpusFiles()  const
+{
+    std::set<fs::path> files;
+    if (fs::is_directory(corpus_))
+        for (fs::directory_entry const& entry : fs::directory_iterator(corpus_))
+            if (isCorpusFile(entry.path()))
+                files.insert(entry.path());
+    return {files.begin(), files.end()};
+}
+
+
+/**
+ * @remark a missing or empty corpus is reported as malfunction of this
+ *         test case, since the corpus is external to the Testsuite.
+ */
+Result LoadSequence::perform()
+{
+    auto files = findCorpusFiles();
+    if (files.empty())
+        return Result{ResCode::MALFUNCTION
+                     ,"No instrument files (*"+def::EXT_INSTRUMENT+", *"+def::EXT_PATCHSET
+                     +") found in corpus "+formatVal(corpus_)};
+    progressLog_.out("LoadSequence: "+formatVal(files.size())+" files from "+formatVal(corpus_)
+                    +" ×"+formatVal(repetitions_)+" into "+formatVal(parts_)+" part(s)");
+    loadTimes_.clear();
+    return launcher_.maybe("loadCorpus",
+    [&] {
+            for (uint rep=0; rep < repetitions_; ++rep)
+                for (size_t i=0; i < files.size(); ++i)
+                {
+                    uint part = 1 + i % parts_;
+                    LoadScript script{part, fs::absolute(files[i])};
+                    auto start = Clock::now();
+                    Result res = launcher_.run(script);
+                    if (not res.is(ResCode::GREEN))
+                        return res;
+                    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                    loadTimes_[files[i].filename().string()].push_back(ms);
+                }
+            performed_ = true;
+            return Result::OK();
+        });
+}
+
+
+std::map<string,double> LoadSequence::getLoadTimes()  const
+{
+    std::map<string,double> averaged;
+    for (auto& [file, times] : loadTimes_)
+    {
+        double sum = 0.0;
+        for (double t : times) sum += t;
+        averaged[file] = sum / times.size();
+    }
+    return averaged;
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,98 @@
+/*
+ *  LoadSequence - load a corpus of instruments and measure load times
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file LoadSequence.hpp
+ ** Load a collection of instrument or patch files into a running Yoshimi instance.
+ ** Test cases of type def::TYPE_LOAD do not compute sound; rather they measure how long
+ ** it takes Yoshimi to load each file of a _corpus_ — a directory with instrument files
+ ** (`*.xiz`) or patch sets (`*.xmz`). All files are loaded through the CLI within a single
+ ** session of the subject, optionally several times, and cycling through several parts.
+ ** Each load is timed from sending the `load` command until Yoshimi echoes the following
+ ** command, which it reads only after the load has been completed.
+ **
+ ** @see LoadJudgement.hpp
+ ** @see ExeLauncher::run()
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_LOAD_SEQUENCE_HPP_
+#define TESTRUNNER_SUITE_STEP_LOAD_SEQUENCE_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/step/Scaffolding.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Step to load all files of a corpus consecutively and
+ * to capture the time spent for each load (in milliseconds).
+ */
+class LoadSequence
+    : public TestStep
+{
+    ExeLauncher& launcher_;
+    Progress& progressLog_;
+    fs::path corpus_;
+    uint repetitions_;
+    uint parts_;
+
+    std::map<string, std::vector<double>> loadTimes_;
+    bool performed_ = false;
+
+    Result perform()  override;
+
+public:
+    LoadSequence(ExeLauncher& launcher
+                ,fs::path corpusDir
+                ,string repetitions
+                ,string parts
+                ,Progress& progress);
+
+    bool isPerformed()  const
+    {
+        return performed_
+           and not launcher_.isBroken();
+    }
+
+    /** @return load time for each file, averaged over repetitions */
+    std::map<string,double> getLoadTimes()  const;
+
+    uint getRepetitions()  const { return repetitions_; }
+
+private:
+    std::vector<fs::path> findCorpusFiles()  const;
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_LOAD_SEQUENCE_HPP_*/
@@ -115,7 +115,7 @@ namespace { // handling the atomic flag...
  */
 future<void> MatchTask::MatchBuilder::activate()
 {
-    matchTask_.condition_ = make_unique<MatchCond>(primary_,precond_,logger_);
+    matchTask_.condition_ = make_unique<MatchCond>(primary_,precond_,failConds_,logger_);
     promise<void> newPromise;
     std::swap(matchTask_.promise_, newPromise);
     enable(matchTask_.active_);
@@ -128,31 +128,43 @@ void MatchTask::evaluate(string const& outputLine)
 {
     if (not isEnabled(active_)) return;
     assert(condition_);
-    if (condition_->doCheck(outputLine))
-    {   // condition fulfilled
-        disable(active_);
-        promise_.set_value(); // => signal successful match
+    switch (condition_->doCheck(outputLine))
+    {
+        case MatchCond::FULFILLED:
+            disable(active_);
+            promise_.set_value(); // => signal successful match
+            break;
+        case MatchCond::FAILED:
+            disable(active_);
+            promise_.set_exception(
+                make_exception_ptr(error::Rejected("Yoshimi reported »"+outputLine+"«")));
+            break;
+        case MatchCond::PENDING:
+            break;
     }
 }
 
 
 /**
  * @remark implements the actual matching logic; applied to each line of output:
+ *   - any failure condition terminates matching, irrespective of the precondition
  *   - if a precondition was given, attempt to fulfil the precondition first
  *   - then attempt to fulfil the main condition
- * @return the RegEx match performed on the given line,
- *     will be `empty()` when the match was not successful.
+ * @return verdict after evaluating this line
  */
-bool MatchCond::doCheck(string const& line)
+MatchCond::Verdict MatchCond::doCheck(string const& line)
 {
     if (logger_) logger_->get().out(line);
+    for (Matcher& failCond : failConds_)
+        if (failCond(line))
+            return FAILED;
     if (precond_ and not fulfilledPrecond_)
     {
         fulfilledPrecond_ = precond_(line);
         if (not fulfilledPrecond_)
-            return false; // bail out
+            return PENDING; // bail out
     }
-    return primary_(line);
+    return primary_(line)? FULFILLED : PENDING;
 }
 
 
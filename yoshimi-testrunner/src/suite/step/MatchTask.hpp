@@ -36,12 +36,16 @@
  ** conditions is coordinated by a atomic flag variable within the MatchTask component.
  ** - from the MatchTask, a builder is established to define the actual conditions
  ** - conditions are given as functor, referring to an output line string, returning a RegExp match.
- ** - a MatchCond state object is heap allocated with the main condition and possibly a precondition.
+ ** - a MatchCond state object is heap allocated with the main condition and possibly a precondition,
+ **   together with any number of _failure conditions_ to be watched simultaneously.
  ** - then the atomic flag is flipped, activating the match evaluation in the Watcher thread.
- ** - this causes each further line of output to be fed into the MatchCond instance for evaluation...
+ ** - this causes each further line of output to be fed into the MatchCond instance for evaluation;
+ **   all conditions are checked in a single pass over each line, failure conditions first.
  ** - if a match is detected, the atomic flag is flipped to deactivate evaluation
- ** - and then the resulting `std::smatch` object is stored into the `promise`
+ ** - and then the `promise` is fulfilled, or loaded with error::Rejected on a failure condition,
  ** - which in turn will unblock the main thread waiting on the `future` end of the channel.
+ ** Failure conditions thus allow to detect error messages from the subject right away,
+ ** instead of waiting for the timeout on a marker that will never appear.
  ** 
  ** @todo WIP as of 8/21
  ** @see Watcher.hpp
@@ -64,6 +68,7 @@
 #include <atomic>
 #include <thread>
 #include <string>
+#include <vector>
 
 namespace suite{
 namespace step {
@@ -82,19 +87,24 @@ class MatchCond
 {
 public:
     using Matcher = std::function<bool(string const&)>;
+    using Matchers = std::vector<Matcher>;
 
-    MatchCond(Matcher targetCond, Matcher precond, MaybeLogger logger)
+    enum Verdict { PENDING, FULFILLED, FAILED };
+
+    MatchCond(Matcher targetCond, Matcher precond, Matchers failConds, MaybeLogger logger)
         : primary_{targetCond}
         , precond_{precond}
+        , failConds_{move(failConds)}
         , logger_{logger}
     { }
 
     /** invoke the matching functor(s). */
-    bool doCheck(string const& line);
+    Verdict doCheck(string const& line);
 
 private:
     Matcher primary_;
     Matcher precond_;
+    Matchers failConds_;
     bool fulfilledPrecond_ = false;
     MaybeLogger logger_;
 };
@@ -131,6 +141,7 @@ public:
         MatchTask& matchTask_;
         Matcher primary_;
         Matcher precond_;
+        MatchCond::Matchers failConds_;
         MaybeLogger logger_;
 
     public:
@@ -146,6 +157,15 @@ public:
             return move(*this);
         }
 
+        /** fail immediately when this condition matches;
+         *  can be given repeatedly, an empty Matcher is ignored */
+        MatchBuilder failOn(Matcher failCond)
+        {
+            if (failCond)
+                failConds_.push_back(move(failCond));
+            return move(*this);
+        }
+
         MatchBuilder logOutputInto(Progress& logger)
         {
             logger_ = logger;
@@ -0,0 +1,159 @@
+/*
+ *  Memoisation - test steps to reuse and record verdicts of sound verification
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file Memoisation.hpp
+ ** Test steps to integrate the suite::Memo cache into the Testsuite.
+ ** Whether a memoised verdict can be reused is decided while building the Testsuite;
+ ** in this case a single MemoVerdict step replaces the complete wiring of the test case.
+ ** Otherwise the test is performed as usual, and MemoRecord retains the verdict if green.
+ **
+ ** @see suite::Memo
+ ** @see ExeCliMould::materialise()
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_MEMOISATION_HPP_
+#define TESTRUNNER_SUITE_STEP_MEMOISATION_HPP_
+
+
+#include "suite/TestStep.hpp"
+#include "suite/step/Invocation.hpp"
+#include "suite/step/SoundJudgement.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Result.hpp"
+#include "suite/Memo.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Report the verdict of a previous run in place of the test case,
+ * since none of the inputs changed since then.
+ */
+class MemoVerdict
+    : public TestStep
+{
+    fs::path topic_;
+    string verdict_;
+    Progress& progressLog_;
+
+
+    Result perform()  override
+    {
+        progressLog_.indicateTest(topic_);
+        Statistics data{topic_
+                       ,ResCode::GREEN
+                       ,0.0
+                       ,true
+                       };
+        return Result(std::move(data), "Memo; "+verdict_);
+    }
+
+public:
+    MemoVerdict(fs::path topic
+               ,string verdict
+               ,Progress& progressLog)
+        : topic_{topic}
+        , verdict_{verdict}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+
+/**
+ * Retain the verdict of a green sound verification for reuse in the next run;
+ * any other outcome invalidates the memoised verdict.
+ */
+class MemoRecord
+    : public TestStep
+{
+    PMemo memo_;
+    fs::path topic_;
+    string key_;
+    Invocation& theTest_;
+    SoundJudgement& judgeSound_;
+
+
+    Result perform()  override
+    {
+        if (theTest_.isPerformed() and judgeSound_.succeeded)
+            memo_->store(topic_, key_, judgeSound_.describe());
+        else
+            memo_->drop(topic_);
+        return Result::OK();
+    }
+
+public:
+    MemoRecord(PMemo memo
+              ,fs::path topic
+              ,string key
+              ,Invocation& ivo
+              ,SoundJudgement& soundJudgement)
+        : memo_{memo}
+        , topic_{topic}
+        , key_{key}
+        , theTest_{ivo}
+        , judgeSound_{soundJudgement}
+    { }
+};
+
+
+
+/**
+ * Store the memoised verdicts at the end of the Testsuite
+ * and indicate how many test cases could be skipped.
+ */
+class PersistMemo
+    : public TestStep
+{
+    PMemo memo_;
+    Progress& progressLog_;
+
+
+    Result perform()  override
+    try {
+        memo_->save();
+        progressLog_.note("Memo: "+memo_->describe());
+        return Result::OK();
+    }
+    catch(error::State& writeFailure)
+    {
+        return Result::Warn(string{"Unable to store memoised verdicts -- "}
+                           + writeFailure.what());
+    }
+
+public:
+    PersistMemo(PMemo memo
+               ,Progress& progressLog)
+        : memo_{memo}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_MEMOISATION_HPP_*/
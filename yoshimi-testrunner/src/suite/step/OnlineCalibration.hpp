@@ -0,0 +1,104 @@
+/*
+ *  OnlineCalibration - track gradual drift of the platform model
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file OnlineCalibration.hpp
+ ** Follow gradual changes of the platform between explicit calibrations.
+ ** The platform model is fitted once with `--calibrate`, yet the machine evolves: kernel
+ ** and library updates, firmware, thermal behaviour. Thus after each regular Testsuite run,
+ ** the timing measurements are fed into an online estimator (recursive least squares with
+ ** exponential forgetting), which tracks the platform model with a memory of a few runs;
+ ** its compact state is stored in `Suite-drift.csv`. When the tracked estimate departs
+ ** significantly from the calibrated model, this is a discrete _recalibration event:_
+ ** the estimate is adopted as new platform model, provided the subject build did not
+ ** change since the last run (and setting `recalibrate` is enabled); otherwise the drift
+ ** is reported, since it might just as well be caused by a change in Yoshimi.
+ **
+ ** @see Timings::trackPlatformDrift()
+ ** @see PlatformCalibration.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_ONLINE_CALIBRATION_HPP_
+#define TESTRUNNER_SUITE_STEP_ONLINE_CALIBRATION_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/format.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+using util::formatVal;
+using util::formatPercent;
+
+
+/**
+ * Step to update the online estimate of the platform model,
+ * and to recalibrate when it drifted significantly.
+ * @remark not used when calibrating explicitly with `--calibrate`.
+ */
+class OnlineCalibration
+    : public TestStep
+{
+    Progress& progressLog_;
+    suite::PTimings timings_;
+
+
+    Result perform()  override
+    {
+        auto drift = timings_->trackPlatformDrift();
+        if (not drift)
+            return Result::OK();
+
+        string msg = formatPercent(drift->drift)
+                   +" ±"+formatPercent(drift->tolerance).substr(1)
+                   +" ("+formatVal(drift->runs)+" runs since calibration)";
+        progressLog_.out("Drift: platform "+msg);
+        if (drift->recalibrated)
+        {
+            progressLog_.note("Calibration: adopted drifted platform model; "+timings_->sumariseCalibration());
+            return Result::Warn("Platform drift "+msg+" -- platform model recalibrated.");
+        }
+        if (drift->significant and not timings_->adaptDrift)
+            return Result::Warn("Platform drift "+msg+" -- consider to run with --calibrate.");
+        if (drift->significant)
+            return Result::Warn("Platform drift "+msg+" -- not recalibrated, since the subject build "
+                                "is unknown or changed since the last run; consider to run with --calibrate.");
+        return Result::OK();
+    }
+
+
+public:
+    OnlineCalibration(Progress& log
+                     ,suite::PTimings globalTimings)
+        : progressLog_{log}
+        , timings_{globalTimings}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_ONLINE_CALIBRATION_HPP_*/
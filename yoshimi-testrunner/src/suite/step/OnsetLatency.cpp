@@ -0,0 +1,138 @@
+/*
+ *  OnsetLatency - measure the delay from note-on to audible output
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file OnsetLatency.cpp
+ ** Implementation of note onset latency measurement.
+ ** The onset is searched within the whole cycle following each note-on. Notes without
+ ** detectable onset (e.g. when the sound of the preceding note is still louder) are
+ ** excluded from the average, but their count is recorded. An increase is flagged when
+ ** the average latency exceeds the past average by more than the past fluctuation,
+ ** and at least by one sample frame.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/OnsetLatency.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using util::formatVal;
+using util::Column;
+using util::VecD;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const uint MIN_REFERENCE_POINTS = 3;
+}
+
+/**
+ * Data storage for the time series of note onset latency.
+ */
+struct TableLatency
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<uint>         notes{"Notes"};              ///< number of scheduled note-on events
+    Column<uint>        silent{"Silent"};             ///< notes without detectable onset
+    Column<double>      avgLat{"Latency avg ms"};     ///< average delay from note-on to onset
+    Column<double>      maxLat{"Latency max ms"};     ///< maximum delay from note-on to onset
+    Column<double>   tolerance{"Tolerance"};          ///< 3·σ of past average latency (ms)
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,notes
+                       ,silent
+                       ,avgLat
+                       ,maxLat
+                       ,tolerance
+                       );
+    }
+};
+
+using LatencyData = util::DataFile<TableLatency>;
+
+
+
+Result OnsetLatency::perform()
+{
+    if (not soundProbe_ or not testData_.wasCaptured())
+        return Result::Warn("Skip OnsetLatency");
+    if (noteDuration_ <= 0.0)
+        return Result::Warn("Unable to derive note-on times: test script does not set the note duration.");
+
+    size_t rate   = testData_.getSmpRate();
+    size_t chunk  = std::max<size_t>(1, testData_.getChunkSiz());
+    size_t cycle  = size_t(std::ceil(noteDuration_ * rate / chunk)) * chunk;
+    size_t cycles = testData_.getSamples() / cycle;
+    if (0 == cycles)
+        return Result::Warn("Note cycle of "+formatVal(cycle)+" frames exceeds the sound probe.");
+
+    std::vector<size_t> noteOn;
+    for (size_t i=0; i < cycles; ++i)
+        noteOn.push_back(i * cycle);
+    auto onsets = soundProbe_.detectOnsets(noteOn, cycle);
+
+    VecD latencies;
+    for (auto& onset : onsets)
+        if (onset)
+            latencies.push_back(1000.0 * *onset / rate);
+    uint silent = onsets.size() - latencies.size();
+    if (latencies.empty())
+        return Result::Warn("No note onset detected in the sound probe.");
+
+    double avg = util::averageLastN(latencies, latencies.size());
+    double max = *std::max_element(latencies.begin(), latencies.end());
+
+    LatencyData data{pathSpec_[def::KEY_fileLatency]};
+    VecD const& series = data.avgLat.data;
+    VecD past{series.end() - std::min<size_t>(series.size(), globalTimings_->baselineAvg), series.end()};
+    double pastAvg = past.size()? util::averageLastN(past, past.size()) : 0.0;
+    double tolerance = past.size()? 3 * util::sdev(past, pastAvg) : 0.0;
+
+    data.newRow();
+    data.timestamp = Config::timestamp;
+    data.notes  = onsets.size();
+    data.silent = silent;
+    data.avgLat = avg;
+    data.maxLat = max;
+    data.tolerance = tolerance;
+    data.save(globalTimings_->timingsKeep);
+
+    progressLog_.out("OnsetLatency: "+formatVal(latencies.size())+" notes, avg="+formatVal(avg)
+                    +"ms max="+formatVal(max)+"ms"+(silent? " ("+formatVal(silent)+" silent)":""));
+
+    double minDelta = 1000.0 / rate;   // one sample frame
+    if (MIN_REFERENCE_POINTS <= past.size()
+        and std::max(tolerance, minDelta) < avg - pastAvg)
+        return Result::Warn("Note onset latency increased to "+formatVal(avg)
+                           +"ms (avg of past: "+formatVal(pastAvg)+"ms, max now "+formatVal(max)+"ms)");
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
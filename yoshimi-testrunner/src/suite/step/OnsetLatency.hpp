@@ -0,0 +1,93 @@
+/*
+ *  OnsetLatency - measure the delay from note-on to audible output
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file OnsetLatency.hpp
+ ** Measure the latency between scheduled note-on and the onset of sound in the probe.
+ ** For live playing, the delay until a note becomes audible matters as much as throughput;
+ ** changes to envelope or buffer handling can add latency without altering the sound much.
+ ** The TestInvoker within Yoshimi plays notes in fixed cycles: each cycle lasts `duration`
+ ** seconds, rounded up to a multiple of the buffer size, and starts with a note-on. Thus
+ ** the note-on positions can be derived from the test parameters and the reported sample
+ ** count, and the onset of each note is detected in the sound probe with sample accuracy.
+ ** Since rendering is deterministic, latency does not fluctuate like run times; the
+ ** average and maximum latency are stored as time series in `<TestID>-latency.csv`,
+ ** and any increase against past measurements is flagged.
+ **
+ ** @see util::SoundProbe::detectOnsets()
+ ** @see SoundObservation.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_ONSET_LATENCY_HPP_
+#define TESTRUNNER_SUITE_STEP_ONSET_LATENCY_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/OutputObservation.hpp"
+#include "suite/step/SoundObservation.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Step to detect note onsets in the sound probe,
+ * and to assess the latency against past measurements.
+ */
+class OnsetLatency
+    : public TestStep
+{
+    SoundObservation& soundProbe_;
+    OutputObservation& testData_;
+    PathSetup& pathSpec_;
+    Progress& progressLog_;
+    suite::PTimings globalTimings_;
+    double noteDuration_;
+
+    Result perform()  override;
+
+public:
+    OnsetLatency(SoundObservation& sound
+                ,OutputObservation& output
+                ,PathSetup& pathSetup
+                ,Progress& progress
+                ,suite::PTimings aggregator
+                ,double noteDuration)
+        : soundProbe_{sound}
+        , testData_{output}
+        , pathSpec_{pathSetup}
+        , progressLog_{progress}
+        , globalTimings_{aggregator}
+        , noteDuration_{noteDuration}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_ONSET_LATENCY_HPP_*/
@@ -58,11 +58,30 @@ using std::optional;
 using util::parseAs;
 
 
+/**
+ * Interface: a raw timing measurement, as consumed by the TimingObservation.
+ * @remark runtime in nanoseconds, with the number of samples and notes
+ *         computed, which are the input for the platform model.
+ */
+class TimingSource
+{
+public:
+    virtual ~TimingSource() { }  ///< this is an interface
+
+    virtual double getRuntime()  const =0;
+    virtual uint   getNotesCnt() const =0;
+    virtual size_t getSamples()  const =0;
+    virtual bool   wasCaptured() const =0;
+};
+
+
+
 /**
  * Extract focused information from captured execution logs.
  */
 class OutputObservation
     : public TestStep
+    , public TimingSource
 {
     Invocation& theTest_;
 
@@ -103,12 +122,13 @@ public:
         : theTest_{invocation}
     { }
 
-    double getRuntime()  const { return assumePresent(runtime_); }
-    uint   getNotesCnt() const { return assumePresent(notesCnt_);}
-    size_t getSamples()  const { return assumePresent(samples_); }
+    double getRuntime()  const override { return assumePresent(runtime_); }
+    uint   getNotesCnt() const override { return assumePresent(notesCnt_);}
+    size_t getSamples()  const override { return assumePresent(samples_); }
     uint   getSmpRate()  const { return assumePresent(smpRate_); }
+    size_t getChunkSiz() const { return assumePresent(chunkSiz_);}
 
-    bool wasCaptured()   const
+    bool wasCaptured()   const override
     {
         return theTest_.isPerformed()
            and runtime_.has_value()
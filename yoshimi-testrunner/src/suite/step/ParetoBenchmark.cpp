@@ -0,0 +1,308 @@
+/*
+ *  ParetoBenchmark - quality versus cost of synth engine settings
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ParetoBenchmark.cpp
+ ** Implementation of the quality-versus-cost evaluation.
+ ** The _cost_ of a grid point is its runtime relative to the reference render, and the
+ ** _difference_ is the peak RMS(30ms) of the residual in dB relative to the overall RMS,
+ ** as used for sound verification. A bit-identical render has no defined difference level;
+ ** it is recorded as #NO_DIFFERENCE. Since runtimes fluctuate, points with very similar
+ ** cost may swap their place on the frontier from run to run; such changes are only noted.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "suite/step/ParetoBenchmark.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <map>
+
+using util::formatVal;
+using util::Column;
+using util::isnil;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const size_t NANOSEC_per_MILLISEC = 1000*1000;
+    const double NO_DIFFERENCE = -400;   // dB(RMS), far below the least float bit (-138dB)
+    const size_t HISTORY_RUNS = 12;
+}
+
+/**
+ * Data storage for the time series of the quality-versus-cost grid.
+ * Each run adds one row per grid point, the reference first.
+ */
+struct TablePareto
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>       build{"Build"};              ///< version and build-ID of the subject
+    Column<string>       point{"Point"};              ///< values of all axes, e.g. `size=1024,interpolation=linear`
+    Column<double>     runtime{"Runtime ms"};         ///< runtime of the render for this grid point
+    Column<double>        cost{"Cost"};               ///< runtime relative to the reference render
+    Column<double>        diff{"Diff dB RMS"};        ///< peak RMS of the difference against the reference
+    Column<uint>      frontier{"Frontier"};           ///< 1 if the point belongs to the Pareto frontier in this run
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,build
+                       ,point
+                       ,runtime
+                       ,cost
+                       ,diff
+                       ,frontier
+                       );
+    }
+};
+
+using ParetoData = util::DataFile<TablePareto>;
+
+
+namespace {
+    struct Entry
+    {
+        string point;
+        double runtime;
+        double cost;
+        double diff;
+        bool frontier;
+    };
+
+    /** @return past runs, newest first, each with the build and its grid points */
+    std::vector<std::pair<string, std::vector<Entry>>> pastRuns(ParetoData const& data, string& build)
+    {
+        std::vector<std::pair<string, std::vector<Entry>>> runs;
+        std::vector<string> builds;
+        for (size_t i = data.size(); 0 < i; --i)
+        {
+            string const& timestamp = data.timestamp.data[i-1];
+            if (runs.empty() or runs.back().first != timestamp)
+            {
+                if (runs.size() == HISTORY_RUNS) break;
+                runs.emplace_back(timestamp, std::vector<Entry>{});
+                builds.push_back(data.build.data[i-1]);
+            }
+            runs.back().second.push_back(Entry{data.point.data[i-1]
+                                              ,data.runtime.data[i-1]
+                                              ,data.cost.data[i-1]
+                                              ,data.diff.data[i-1]
+                                              ,0 < data.frontier.data[i-1]});
+        }
+        for (size_t r=0; r < runs.size(); ++r)
+            runs[r].first += "  "+builds[r];
+        build = builds.empty()? "" : builds.front();
+        return runs;
+    }
+
+    string escapeHtml(string text)
+    {
+        string res;
+        for (char c : text)
+            switch (c)
+            {
+                case '<': res += "&lt;";  break;
+                case '>': res += "&gt;";  break;
+                case '&': res += "&amp;"; break;
+                case '"': res += "&quot;";break;
+                default:  res += c;
+            }
+        return res;
+    }
+
+    string showDiff(double diff)
+    {
+        return diff <= NO_DIFFERENCE? "identical" : formatVal(std::round(diff * 10) / 10)+"dB";
+    }
+
+    string showCost(double cost)
+    {
+        return formatVal(std::round(cost * 1000) / 1000)+"×";
+    }
+
+    void renderHtml(fs::path htmlFile, string const& testID, string const& build
+                   ,std::vector<Entry> const& current
+                   ,std::vector<std::pair<string, std::vector<Entry>>> const& history)
+    {
+        std::map<string,double> previousCost;
+        if (1 < history.size())
+            for (Entry const& entry : history[1].second)
+                previousCost[entry.point] = entry.cost;
+
+        std::ofstream html{htmlFile};
+        if (not html.good())
+            throw error::State("Unable to write "+formatVal(htmlFile));
+        html << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\">\n"
+             << "<title>Quality versus cost: "<<escapeHtml(testID)<<"</title>\n"
+             << "<style>table{border-collapse:collapse} th,td{border:1px solid #bbb;padding:2px 8px}"
+                " td.num{text-align:right} tr.frontier{font-weight:bold;background:#e6f2e6}</style>\n"
+             << "</head><body>\n"
+             << "<h1>Quality versus cost: "<<escapeHtml(testID)<<"</h1>\n"
+             << "<p>Run "<<escapeHtml(Config::timestamp)<<" &mdash; subject "<<escapeHtml(build)<<"</p>\n"
+             << "<table>\n<tr><th>Point</th><th>Runtime ms</th><th>Cost</th><th>Previous cost</th>"
+                "<th>Diff dB(RMS)</th><th>Frontier</th></tr>\n";
+        for (Entry const& entry : current)
+        {
+            auto prev = previousCost.find(entry.point);
+            html << "<tr"<<(entry.frontier? " class=\"frontier\"":"")<<">"
+                 << "<td>"<<escapeHtml(entry.point)<<"</td>"
+                 << "<td class=\"num\">"<<formatVal(std::round(entry.runtime * 100) / 100)<<"</td>"
+                 << "<td class=\"num\">"<<showCost(entry.cost)<<"</td>"
+                 << "<td class=\"num\">"<<(prev == previousCost.end()? "--" : showCost(prev->second))<<"</td>"
+                 << "<td class=\"num\">"<<showDiff(entry.diff)<<"</td>"
+                 << "<td>"<<(entry.frontier? "&#x2714;":"")<<"</td></tr>\n";
+        }
+        html << "</table>\n<h2>Frontier history</h2>\n<table>\n<tr><th>Run</th><th>Frontier (cost, diff)</th></tr>\n";
+        for (auto& [run, entries] : history)
+        {
+            string frontier;
+            for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+                if (it->frontier)
+                    frontier += (isnil(frontier)? "":"<br>")
+                              + escapeHtml(it->point)+" ("+showCost(it->cost)+", "+showDiff(it->diff)+")";
+            html << "<tr><td>"<<escapeHtml(run)<<"</td><td>"<<frontier<<"</td></tr>\n";
+        }
+        html << "</table>\n</body></html>\n";
+    }
+}
+
+
+
+Result ParetoPoint::perform()
+try {
+    if (not output_.wasCaptured() or not sound_)
+        return Result::Warn("Skip ParetoPoint "+label+": no render captured.");
+
+    runtime_ms = output_.getRuntime() / NANOSEC_per_MILLISEC;
+    FileNameSpec& reference = pathSpec_[def::KEY_fileParetoRef];
+    if (isReference_)
+    {
+        sound_.saveProbe(reference);
+        diff_dB = NO_DIFFERENCE;
+        return Result::OK();
+    }
+    if (not fs::exists(reference))
+        return Result::Warn("Skip ParetoPoint "+label+": reference render missing.");
+
+    sound_.buildDiff(reference);
+    if (auto mismatch = sound_.checkDiffSane())
+        return Result::Warn("ParetoPoint "+label+" not comparable: "+*mismatch);
+    diff_dB = std::max(NO_DIFFERENCE, sound_.getDiffRMSPeak());
+    return Result::OK();
+}
+catch(error::State& soundFailure)
+{
+    return Result{ResCode::MALFUNCTION, "ParetoPoint "+label+" -- "+soundFailure.what()};
+}
+
+
+
+Result ParetoFrontier::perform()
+{
+    fs::path reference = pathSpec_[def::KEY_fileParetoRef];
+    std::error_code noThrow;
+    fs::remove(reference, noThrow);
+
+    if (points_.empty() or not points_.front().get().wasCaptured())
+        return Result{ResCode::MALFUNCTION, "Pareto benchmark: reference render failed."};
+
+    double refRuntime = *points_.front().get().runtime_ms;
+    std::vector<Entry> current;
+    string missing;
+    for (ParetoPoint& point : points_)
+        if (point.wasCaptured())
+            current.push_back(Entry{point.label, *point.runtime_ms
+                                   ,0.0 < refRuntime? *point.runtime_ms / refRuntime : 0.0
+                                   ,*point.diff_dB, false});
+        else
+            missing += " "+point.label;
+
+    // frontier: walking by increasing cost, each point must come closer to the reference
+    std::vector<Entry*> byCost;
+    for (Entry& entry : current)
+        byCost.push_back(&entry);
+    std::sort(byCost.begin(), byCost.end()
+             ,[](Entry* l, Entry* r){ return l->runtime < r->runtime
+                                          or (l->runtime == r->runtime and l->diff < r->diff); });
+    double bestDiff = std::numeric_limits<double>::infinity();
+    for (Entry* entry : byCost)
+        if (entry->diff < bestDiff)
+        {
+            entry->frontier = true;
+            bestDiff = entry->diff;
+        }
+
+    string build = globalTimings_? globalTimings_->subjectBuild(subject_).describe() : string{"?"};
+    ParetoData data{pathSpec_[def::KEY_filePareto]};
+    string lastBuild;
+    auto previous = pastRuns(data, lastBuild);
+    for (Entry const& entry : current)
+    {
+        data.newRow();
+        data.timestamp = Config::timestamp;
+        data.build     = build;
+        data.point     = entry.point;
+        data.runtime   = entry.runtime;
+        data.cost      = entry.cost;
+        data.diff      = entry.diff;
+        data.frontier  = entry.frontier? 1:0;
+    }
+    data.save((globalTimings_? globalTimings_->timingsKeep : HISTORY_RUNS) * current.size());
+
+    auto history = pastRuns(data, build);
+    fs::path htmlFile = pathSpec_[def::KEY_filePareto];
+    renderHtml(htmlFile.replace_extension(def::EXT_DATA_HTML)
+              ,pathSpec_.getTestcaseID(), build, current, history);
+
+    frontier_.clear();
+    for (Entry* entry : byCost)
+        if (entry->frontier)
+            frontier_ += (isnil(frontier_)? "":" | ")
+                       + entry->point+" "+showCost(entry->cost)+" "+showDiff(entry->diff);
+    progressLog_.note("Pareto: "+frontier_);
+
+    if (not previous.empty())
+    {
+        string dropped;
+        for (Entry const& past : previous.front().second)
+            if (past.frontier)
+                for (Entry const& entry : current)
+                    if (entry.point == past.point and not entry.frontier)
+                        dropped += " "+entry.point;
+        if (not isnil(dropped))
+            progressLog_.note("Pareto: no longer on the frontier since "+lastBuild+":"+dropped);
+    }
+
+    succeeded = isnil(missing);
+    resCode = succeeded? ResCode::GREEN : ResCode::WARNING;
+    if (not succeeded)
+        return Result::Warn("Pareto benchmark: no result for"+missing);
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
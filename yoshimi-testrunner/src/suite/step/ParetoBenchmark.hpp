@@ -0,0 +1,145 @@
+/*
+ *  ParetoBenchmark - quality versus cost of synth engine settings
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file ParetoBenchmark.hpp
+ ** Gauge the trade-off between sound quality and computation cost for a grid of settings.
+ ** A test case of type def::TYPE_PARETO declares a block `Grid`, where each line assigns a
+ ** CLI command to a value of some quality _axis_ (e.g. oscillator size or interpolation).
+ ** The test script is rendered once for each combination of values; the combination of
+ ** the first value on each axis is taken as the highest quality _reference._ The render of
+ ** each further grid point is compared against the reference by util::SoundProbe::buildDiff,
+ ** and its peak RMS difference is set against the runtime. A point belongs to the _Pareto
+ ** frontier_ if no other point is both faster and closer to the reference. All points are
+ ** stored as time series in `<TestID>-pareto.csv`, tagged with the subject build, so that
+ ** the frontier can be tracked across releases; the current table together with the
+ ** frontier of past runs is rendered into `<TestID>-pareto.html`.
+ **
+ ** @see setup::ParetoMould
+ ** @see SoundObservation.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_PARETO_BENCHMARK_HPP_
+#define TESTRUNNER_SUITE_STEP_PARETO_BENCHMARK_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/OutputObservation.hpp"
+#include "suite/step/SoundObservation.hpp"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace suite{
+namespace step {
+
+using std::string;
+using std::optional;
+
+
+/**
+ * Capture runtime and difference against the reference for a single grid point.
+ * @remark the reference point stores its sound as WAV, to be used by all further points;
+ *         thus the reference must be performed first.
+ */
+class ParetoPoint
+    : public TestStep
+{
+    OutputObservation& output_;
+    SoundObservation& sound_;
+    PathSetup& pathSpec_;
+    bool isReference_;
+
+    Result perform()  override;
+
+public:
+    const string label;
+    optional<double> runtime_ms;
+    optional<double> diff_dB;
+
+    ParetoPoint(string pointLabel
+               ,bool isReference
+               ,OutputObservation& output
+               ,SoundObservation& sound
+               ,PathSetup& pathSetup)
+        : output_{output}
+        , sound_{sound}
+        , pathSpec_{pathSetup}
+        , isReference_{isReference}
+        , label{pointLabel}
+    { }
+
+    bool wasCaptured()  const { return runtime_ms and diff_dB; }
+};
+
+using ParetoPoints = std::vector<std::reference_wrapper<ParetoPoint>>;
+
+
+/**
+ * Determine the Pareto frontier of runtime versus difference,
+ * record all points and render the table as HTML.
+ */
+class ParetoFrontier
+    : public TestStep
+{
+    ParetoPoints points_;
+    PathSetup& pathSpec_;
+    Progress& progressLog_;
+    suite::PTimings globalTimings_;
+    fs::path subject_;
+
+    string frontier_;
+
+    Result perform()  override;
+
+public:
+    ParetoFrontier(ParetoPoints points
+                  ,PathSetup& pathSetup
+                  ,Progress& progress
+                  ,suite::PTimings aggregator
+                  ,fs::path subject)
+        : points_{std::move(points)}
+        , pathSpec_{pathSetup}
+        , progressLog_{progress}
+        , globalTimings_{aggregator}
+        , subject_{subject}
+    { }
+
+    bool succeeded = false;
+    ResCode resCode = ResCode::MALFUNCTION;
+
+    string describe()  const
+    {
+        return succeeded? "Pareto frontier: "+frontier_
+                        : "No Pareto frontier determined.";
+    }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_PARETO_BENCHMARK_HPP_*/
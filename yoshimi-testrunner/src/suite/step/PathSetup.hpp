@@ -44,6 +44,7 @@
 #include "Config.hpp"
 #include "suite/TestStep.hpp"
 
+#include <initializer_list>
 #include <optional>
 #include <utility>
 #include <string>
@@ -111,6 +112,25 @@ public:
         return move(*this);
     }
 
+    /** use an existing file with one of the alternative extensions instead,
+     *  in case the file with the enforced extension does not exist (yet) */
+    FileNameSpec&& acceptAlternatives(std::initializer_list<string> typeMarkers)
+    {
+        if (not fs::exists(spec_))
+            for (string const& alternative : typeMarkers)
+            {
+                fs::path candidate{spec_};
+                candidate.replace_extension(alternative);
+                if (fs::exists(candidate))
+                {
+                    spec_ = candidate;
+                    enforcedExt_ = alternative;
+                    break;
+                }
+            }
+        return move(*this);
+    }
+
     /** @note checks if the file actually exists _and_
      *        enables enforcement later on access */
     bool verifyPresent()
@@ -182,7 +202,8 @@ class PathSetup
                                       .enforceExt(EXT_SOUND_RAW)});
         insert({KEY_fileBaseline, FileNameSpec(SOUND_BASELINE_MARK)
                                       .enforceExt(EXT_SOUND_WAV)
-                                      .disambiguate(testcaseID)});
+                                      .disambiguate(testcaseID)
+                                      .acceptAlternatives({EXT_SOUND_RF64, EXT_SOUND_W64})});
         insert({KEY_fileResidual, FileNameSpec(SOUND_RESIDUAL_MARK)
                                       .enforceExt(EXT_SOUND_WAV)
                                       .disambiguate(testcaseID)});
@@ -192,6 +213,33 @@ class PathSetup
         insert({KEY_fileExpense,  FileNameSpec(TIMING_EXPENSE_MARK)
                                       .enforceExt(EXT_DATA_CSV)
                                       .disambiguate(testcaseID)});
+        insert({KEY_fileLoadtime, FileNameSpec(TIMING_LOADTIME_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileSceneCost,FileNameSpec(TIMING_SCENECOST_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileLatency,  FileNameSpec(TIMING_LATENCY_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileRtAudit,  FileNameSpec(TIMING_RTAUDIT_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileStartup,  FileNameSpec(TIMING_STARTUP_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileProfile,  FileNameSpec(TIMING_PROFILE_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileInstrument,FileNameSpec(TIMING_INSTRUMENT_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_filePareto,   FileNameSpec(TIMING_PARETO_MARK)
+                                      .enforceExt(EXT_DATA_CSV)
+                                      .disambiguate(testcaseID)});
+        insert({KEY_fileParetoRef,FileNameSpec(SOUND_PARETO_REF_MARK)
+                                      .enforceExt(EXT_SOUND_WAV)
+                                      .disambiguate(testcaseID)});
 
         return Result::OK();
     }
@@ -212,8 +260,24 @@ public:
     }
 
 
+    /** @return the file configured for the key, specialised for a further
+     *          dimension of the test case, e.g. `<TestID>-<metric>-runtime.csv` */
+    fs::path forDimension(string const& key, string const& dimension)  const
+    {
+        fs::path file = operator[](key);
+        if (isnil(dimension))
+            return file;
+        string name = file.filename();
+        string prefix = getTestcaseID()+"-";
+        return file.replace_filename(util::startsWith(name, prefix)? prefix+dimension+"-"+name.substr(prefix.size())
+                                                                   : dimension+"-"+name);
+    }
+
     string getTestcaseID()  const
     { return topicPath_.stem(); }
+
+    fs::path getTopic()  const
+    { return topicPath_; }
 };
 
 
@@ -95,6 +95,10 @@ class PlatformCalibration
             progressLog_.note("Calibration: +++ establish new Platform Model +++");
         else
             progressLog_.note("Calibration: +++ re-fit Platform Model to current data +++");
+        if (timings_->isProfileMismatch())
+            progressLog_.note("Calibration: switching build profile "+timings_->calibrationProfile()
+                             +" -> "+timings_->subjectBuild().profile);
+        progressLog_.note("Calibration: subject "+timings_->subjectBuild().describe());
         progressLog_.out("Calibration: preparing "+str(timings_->dataCnt())+" data points...");
         timings_->fitNewPlatformModel();
         progressLog_.note("Calibration: "+timings_->sumariseCalibration());
@@ -0,0 +1,285 @@
+/*
+ *  PreloadShim - test steps to count allocations and lock waits within the subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file PreloadShim.cpp
+ ** Implementation of the instrumentation steps.
+ ** Threads are matched by their slot in the segment; threads started after the mark are counted
+ ** from their creation. The thread with most allocations is named in the log, to give a hint where
+ ** to look. The thread which consumed most CPU time is deemed to be the rendering thread; its
+ ** counters are recorded and judged separately, since activity of the CLI, GUI or loader threads
+ ** would otherwise dilute changes within the rendering path. The CPU time is only published when
+ ** the subject exits regularly; otherwise the rendering thread remains unknown for this run.
+ ** Increases must exceed 3·σ of the past values and at least 5%; moreover, a handful of
+ ** allocations or 0.1ms of lock wait are tolerated, since the CLI may pass a few notifications.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/PreloadShim.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+
+using util::formatVal;
+using util::Column;
+using util::VecD;
+using util::ShimSegment;
+using util::ShimCounters;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const uint MIN_REFERENCE_POINTS = 3;
+    const double MIN_ALLOC_DELTA = 10;    // allocations during the test
+    const double MIN_WAIT_DELTA  = 0.1;   // ms
+    const double MIN_RELATIVE    = 0.05;
+}
+
+/**
+ * Data storage for the time series of allocations and lock waits within the subject.
+ */
+struct TableInstrument
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<double>      allocs{"Allocs"};             ///< heap allocations in all threads during the test
+    Column<double>       bytes{"Alloc bytes"};        ///< sum of requested allocation sizes
+    Column<double>       frees{"Frees"};              ///< heap deallocations in all threads
+    Column<double>   perSample{"Allocs/sample"};      ///< allocations per computed sample
+    Column<double>   lockCalls{"Lock calls"};         ///< calls to pthread_mutex_lock
+    Column<double>   contended{"Contended"};          ///< ...where the mutex was held by another thread
+    Column<double>    lockWait{"Lock wait ms"};       ///< time spent waiting for contended locks
+    Column<string>   hotThread{"Hot thread"};         ///< thread with most allocations
+    Column<double>  tolAllocs{"Tol allocs/sample"};   ///< 3·σ of past allocations per sample
+    Column<double>    tolWait{"Tol wait ms"};         ///< 3·σ of past lock wait
+    Column<string> renderThread{"Render thread"};     ///< thread with most CPU time (empty if unknown)
+    Column<double> renderAllocs{"Render allocs"};     ///< heap allocations in the rendering thread
+    Column<double> renderPerSample{"Render allocs/sample"};
+    Column<double>  renderWait{"Render wait ms"};     ///< lock wait within the rendering thread
+    Column<double> tolRenderAllocs{"Tol render allocs/sample"};
+    Column<double> tolRenderWait{"Tol render wait ms"};
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,allocs
+                       ,bytes
+                       ,frees
+                       ,perSample
+                       ,lockCalls
+                       ,contended
+                       ,lockWait
+                       ,hotThread
+                       ,tolAllocs
+                       ,tolWait
+                       ,renderThread
+                       ,renderAllocs
+                       ,renderPerSample
+                       ,renderWait
+                       ,tolRenderAllocs
+                       ,tolRenderWait
+                       );
+    }
+};
+
+using InstrumentData = util::DataFile<TableInstrument>;
+
+
+namespace {
+    struct Reference
+    {
+        double avg{0.0};
+        double tolerance{0.0};
+        size_t points{0};
+        operator bool()  const { return MIN_REFERENCE_POINTS <= points; }
+    };
+
+    /** @return average and 3·σ of the last values in the series,
+     *          optionally only from runs where the rendering thread was known */
+    Reference pastReference(InstrumentData const& data, Column<double> const& series
+                           ,uint avgPoints, bool renderOnly)
+    {
+        VecD past;
+        for (size_t i=data.size(); 0 < i and past.size() < avgPoints; --i)
+            if (not renderOnly or not util::isnil(data.renderThread.data[i-1]))
+                past.push_back(series.data[i-1]);
+        size_t n = past.size();
+        if (not n)
+            return Reference{};
+        double avg = util::averageLastN(past, n);
+        return Reference{avg, 3 * util::sdev(past, avg), n};
+    }
+
+    bool isAllocIncrease(double perSample, Reference const& ref, double samples)
+    {
+        return ref
+           and std::max(ref.tolerance, MIN_RELATIVE * ref.avg) < perSample - ref.avg
+           and MIN_ALLOC_DELTA < (perSample - ref.avg) * samples;
+    }
+
+    bool isWaitIncrease(double lockWait, Reference const& ref)
+    {
+        return ref
+           and std::max({ref.tolerance, MIN_RELATIVE * ref.avg, MIN_WAIT_DELTA}) < lockWait - ref.avg;
+    }
+
+    string describeThread(ShimCounters const& thread)
+    {
+        return thread.name+"["+formatVal(thread.tid)+"]";
+    }
+}
+
+
+
+/** @remark without the library, the test is performed uninstrumented */
+Result PreloadShim::perform()
+{
+    segment_.reset();
+    start_.clear();
+    try {
+        ShimSegment::locateLibrary();
+        segment_.reset(new ShimSegment);
+        return Result::OK();
+    }
+    catch(error::Misconfig& missing)
+    {
+        return Result::Warn(string{"Skip PreloadShim: "}+missing.what());
+    }
+}
+
+
+VectorS PreloadShim::environment()  const
+{
+    return segment_? segment_->environment() : VectorS{};
+}
+
+
+bool PreloadShim::isAttached()  const
+{
+    return segment_ and segment_->isAttached();
+}
+
+
+void PreloadShim::mark()
+{
+    if (segment_)
+        start_ = segment_->snapshot();
+}
+
+
+std::vector<ShimCounters> PreloadShim::conclude()
+{
+    if (not segment_)
+        return {};
+    std::vector<ShimCounters> threads = segment_->snapshot();
+    for (size_t i=0; i < threads.size() and i < start_.size(); ++i)
+        threads[i] = threads[i] - start_[i];
+    segment_.reset();
+    start_.clear();
+    return threads;
+}
+
+
+
+Result PreloadJudgement::perform()
+{
+    if (not shim_.isAttached())
+    {
+        shim_.conclude();
+        return Result::Warn("Skip PreloadJudgement: subject did not load the preload library.");
+    }
+    auto threads = shim_.conclude();
+    ShimCounters sum;
+    for (auto& thread : threads)
+        sum += thread;
+    auto hot = std::max_element(threads.begin(), threads.end()
+                               ,[](ShimCounters const& t1, ShimCounters const& t2){ return t1.allocs < t2.allocs; });
+    auto render = std::max_element(threads.begin(), threads.end()
+                                  ,[](ShimCounters const& t1, ShimCounters const& t2){ return t1.cpu_ns < t2.cpu_ns; });
+    bool knowRender = render != threads.end() and 0 < render->cpu_ns;
+    ShimCounters renderCnt = knowRender? *render : ShimCounters{};
+    string hotThread = hot == threads.end()? "" : describeThread(*hot);
+    string renderThread = knowRender? describeThread(*render) : "";
+    double samples = output_.wasCaptured()? output_.getSamples() : 0;
+    double perSample = samples? sum.allocs / samples : 0.0;
+    double lockWait = sum.lockWait_ns / 1e6;
+    double renderPerSample = samples? renderCnt.allocs / samples : 0.0;
+    double renderWait = renderCnt.lockWait_ns / 1e6;
+
+    progressLog_.out("PreloadShim: allocs="+formatVal(sum.allocs)+" ("+formatVal(perSample)+"/sample)"
+                    +" bytes="+formatVal(sum.bytes)+" frees="+formatVal(sum.frees)
+                    +" locks="+formatVal(sum.lockCalls)+" contended="+formatVal(sum.contended)
+                    +" wait="+formatVal(lockWait)+"ms; most allocations in "+hotThread);
+    progressLog_.out(knowRender? "PreloadShim: rendering thread "+renderThread
+                                 +" allocs="+formatVal(renderCnt.allocs)+" ("+formatVal(renderPerSample)+"/sample)"
+                                 +" locks="+formatVal(renderCnt.lockCalls)+" contended="+formatVal(renderCnt.contended)
+                                 +" wait="+formatVal(renderWait)+"ms"
+                               : "PreloadShim: rendering thread unknown (no CPU times published by the subject)");
+
+    InstrumentData data{pathSpec_[def::KEY_fileInstrument]};
+    uint avgPoints = globalTimings_->baselineAvg;
+    Reference refAllocs = pastReference(data, data.perSample, avgPoints, false);
+    Reference refWait   = pastReference(data, data.lockWait,  avgPoints, false);
+    Reference refRenderAllocs = pastReference(data, data.renderPerSample, avgPoints, true);
+    Reference refRenderWait   = pastReference(data, data.renderWait,      avgPoints, true);
+
+    data.newRow();
+    data.timestamp = Config::timestamp;
+    data.allocs    = sum.allocs;
+    data.bytes     = sum.bytes;
+    data.frees     = sum.frees;
+    data.perSample = perSample;
+    data.lockCalls = sum.lockCalls;
+    data.contended = sum.contended;
+    data.lockWait  = lockWait;
+    data.hotThread = hotThread;
+    data.tolAllocs = refAllocs.tolerance;
+    data.tolWait   = refWait.tolerance;
+    data.renderThread    = renderThread;
+    data.renderAllocs    = renderCnt.allocs;
+    data.renderPerSample = renderPerSample;
+    data.renderWait      = renderWait;
+    data.tolRenderAllocs = knowRender? refRenderAllocs.tolerance : 0.0;
+    data.tolRenderWait   = knowRender? refRenderWait.tolerance : 0.0;
+    data.save(globalTimings_->timingsKeep);
+
+    string findings;
+    if (knowRender and isAllocIncrease(renderPerSample, refRenderAllocs, samples))
+        findings += " allocations per sample in rendering thread "+renderThread+" "+formatVal(renderPerSample)
+                  + " (avg of past: "+formatVal(refRenderAllocs.avg)+");";
+    if (knowRender and isWaitIncrease(renderWait, refRenderWait))
+        findings += " lock wait in rendering thread "+renderThread+" "+formatVal(renderWait)
+                  + "ms (avg of past: "+formatVal(refRenderWait.avg)+"ms);";
+    if (isAllocIncrease(perSample, refAllocs, samples))
+        findings += " allocations per sample "+formatVal(perSample)+" (avg of past: "+formatVal(refAllocs.avg)+")"
+                  + ", mostly in "+hotThread+";";
+    if (isWaitIncrease(lockWait, refWait))
+        findings += " lock wait "+formatVal(lockWait)+"ms (avg of past: "+formatVal(refWait.avg)+"ms);";
+    if (not util::isnil(findings))
+        return Result::Warn("Subject instrumentation shows increase:"+findings);
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,139 @@
+/*
+ *  PreloadShim - test steps to count allocations and lock waits within the subject
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file PreloadShim.hpp
+ ** Instrument the subject with a preload library, to observe heap allocations and mutex contention.
+ ** Both are classical causes of latency spikes within the audio rendering path, yet invisible from
+ ** outside the process. When launched with `--instrument`, timed test cases performed locally get
+ ** the library `libtestshim.so` injected with `LD_PRELOAD`; it counts calls, bytes and lock wait
+ ** time per thread into a shared memory segment. The counters are marked after launch, so that
+ ** only the activity caused by the test script and the test itself is taken into account.
+ ** Allocations per computed sample and the total lock wait time are tracked as time series
+ ** in `<TestID>-instrument.csv`, and a warning is issued when either increases.
+ **
+ ** @see preload/testshim.cpp
+ ** @see util::ShimSegment
+ ** @see RealtimeAudit.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_PRELOAD_SHIM_HPP_
+#define TESTRUNNER_SUITE_STEP_PRELOAD_SHIM_HPP_
+
+
+#include "util/shim.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+#include "suite/step/Scaffolding.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/OutputObservation.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Prepare the shared memory segment prior to launch, and
+ * provide the environment to load the preload library.
+ * @note must be passed as LaunchEnvironment to the ExeLauncher.
+ */
+class PreloadShim
+    : public TestStep
+    , public LaunchEnvironment
+{
+    std::unique_ptr<util::ShimSegment> segment_;
+    std::vector<util::ShimCounters> start_;
+
+    Result perform()  override;
+
+public:
+    VectorS environment()  const override;
+
+    /** take the current counters as start of the measurement */
+    void mark();
+
+    bool isAttached()  const;
+
+    /** @return increase of the counters since #mark, per thread;
+     *          the segment is discarded afterwards */
+    std::vector<util::ShimCounters> conclude();
+};
+
+
+/**
+ * Mark the counters after launch, prior to the test invocation.
+ */
+class PreloadMark
+    : public TestStep
+{
+    PreloadShim& shim_;
+
+    Result perform()  override
+    {
+        shim_.mark();
+        return Result::OK();
+    }
+
+public:
+    PreloadMark(PreloadShim& shim)
+        : shim_{shim}
+    { }
+};
+
+
+
+/**
+ * Sum up allocations and lock waits caused by the test,
+ * record them and compare them with past measurements.
+ */
+class PreloadJudgement
+    : public TestStep
+{
+    PreloadShim& shim_;
+    OutputObservation& output_;
+    PathSetup& pathSpec_;
+    PTimings globalTimings_;
+    Progress& progressLog_;
+
+    Result perform()  override;
+
+public:
+    PreloadJudgement(PreloadShim& shim
+                    ,OutputObservation& output
+                    ,PathSetup& pathSetup
+                    ,PTimings globalTimings
+                    ,Progress& progressLog)
+        : shim_{shim}
+        , output_{output}
+        , pathSpec_{pathSetup}
+        , globalTimings_{globalTimings}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_PRELOAD_SHIM_HPP_*/
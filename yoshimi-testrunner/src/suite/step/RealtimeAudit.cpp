@@ -0,0 +1,186 @@
+/*
+ *  RealtimeAudit - test steps to audit real-time safety of the rendering thread
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file RealtimeAudit.cpp
+ ** Implementation of the real-time audit.
+ ** Threads are sampled every 50ms, which is more often than the SystemWatch, since the
+ ** `/proc` counters of a thread are lost when it terminates. Only past measurements taken
+ ** with the same method are compared, since perf counters add the system calls, and the
+ ** threshold for a warning is at least a few events, to tolerate occasional preemption.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/RealtimeAudit.hpp"
+#include "Config.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using util::formatVal;
+using util::Column;
+using util::VecD;
+using util::ThreadAudit;
+using util::ThreadCounters;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const auto SAMPLING_INTERVAL = std::chrono::milliseconds(50);
+    const uint MIN_REFERENCE_POINTS = 3;
+    const double MIN_DELTA = 5;   // violation events
+}
+
+/**
+ * Data storage for the time series of real-time hazards in the rendering thread.
+ */
+struct TableRealtimeAudit
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>      thread{"Thread"};             ///< name of the thread identified as rendering thread
+    Column<long>   minorFaults{"Minor faults"};       ///< page faults without I/O
+    Column<long>   majorFaults{"Major faults"};       ///< page faults requiring I/O
+    Column<long>   volSwitches{"Vol switches"};       ///< voluntary context switches (blocking)
+    Column<long> involSwitches{"Invol switches"};     ///< involuntary context switches (preemption)
+    Column<long>      syscalls{"Syscalls"};           ///< system calls, -1 if not counted
+    Column<double>  violations{"Violations"};         ///< faults + involuntary switches + syscalls
+    Column<double>   tolerance{"Tolerance"};          ///< 3·σ of past violations
+    Column<string>      method{"Method"};             ///< `perf` or `proc`
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,thread
+                       ,minorFaults
+                       ,majorFaults
+                       ,volSwitches
+                       ,involSwitches
+                       ,syscalls
+                       ,violations
+                       ,tolerance
+                       ,method
+                       );
+    }
+};
+
+using RealtimeAuditData = util::DataFile<TableRealtimeAudit>;
+
+
+
+RealtimeAudit::~RealtimeAudit()
+{
+    conclude();
+}
+
+
+Result RealtimeAudit::perform()
+{
+    conclude(); // safety: never run two samplers
+    threads_.clear();
+    int pid = launcher_.subjectPID();
+    if (0 == pid)
+        return Result::Warn("Skip RealtimeAudit: subject not running locally");
+    audit_.reset(new ThreadAudit{pid});
+    method_ = audit_->method();
+    active_ = true;
+    sampler_ = std::thread([this]{ sampleLoop(); });
+    return Result::OK();
+}
+
+
+std::vector<ThreadCounters> const& RealtimeAudit::conclude()
+{
+    {
+        std::lock_guard<std::mutex> guard{lock_};
+        if (not active_) return threads_;
+        active_ = false;
+    }
+    stopSignal_.notify_all();
+    if (sampler_.joinable())
+        sampler_.join();
+    threads_ = audit_->conclude();
+    method_ = audit_->method();
+    audit_.reset();
+    return threads_;
+}
+
+
+void RealtimeAudit::sampleLoop()
+{
+    std::unique_lock<std::mutex> guard{lock_};
+    while (not stopSignal_.wait_for(guard, SAMPLING_INTERVAL, [this]{ return not active_; }))
+    {
+        guard.unlock();
+        audit_->sample();
+        guard.lock();
+    }
+}
+
+
+
+/** @remark the rendering thread is the one consuming most CPU time; page faults decide a tie */
+Result RealtimeJudgement::perform()
+{
+    auto& threads = audit_.conclude();
+    if (threads.empty())
+        return Result::Warn("Skip RealtimeJudgement: no threads audited.");
+    auto render = std::max_element(threads.begin(), threads.end()
+                                  ,[](ThreadCounters const& t1, ThreadCounters const& t2)
+                                    {
+                                        return t1.cpuTicks < t2.cpuTicks
+                                            or (t1.cpuTicks == t2.cpuTicks and t1.minorFaults < t2.minorFaults);
+                                    });
+    double violations = render->violations();
+    progressLog_.out("RealtimeAudit("+audit_.method()+"): rendering thread "+render->describe());
+
+    RealtimeAuditData data{pathSpec_[def::KEY_fileRtAudit]};
+    VecD past;
+    for (size_t i=data.size(); 0 < i and past.size() < globalTimings_->baselineAvg; --i)
+        if (data.method.data[i-1] == audit_.method())
+            past.push_back(data.violations.data[i-1]);
+    double pastAvg = past.size()? util::averageLastN(past, past.size()) : 0.0;
+    double tolerance = past.size()? 3 * util::sdev(past, pastAvg) : 0.0;
+
+    data.newRow();
+    data.timestamp     = Config::timestamp;
+    data.thread        = render->name;
+    data.minorFaults   = render->minorFaults;
+    data.majorFaults   = render->majorFaults;
+    data.volSwitches   = render->volSwitches;
+    data.involSwitches = render->involSwitches;
+    data.syscalls      = render->syscalls.value_or(-1);
+    data.violations    = violations;
+    data.tolerance     = tolerance;
+    data.method        = audit_.method();
+    data.save(globalTimings_->timingsKeep);
+
+    if (MIN_REFERENCE_POINTS <= past.size()
+        and std::max(tolerance, MIN_DELTA) < violations - pastAvg)
+        return Result::Warn("Real-time hazards in rendering thread increased: "+formatVal(violations)
+                           +" events (avg of past: "+formatVal(pastAvg)+"); "+render->describe());
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,125 @@
+/*
+ *  RealtimeAudit - test steps to audit real-time safety of the rendering thread
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file RealtimeAudit.hpp
+ ** Watch the threads of the subject for events hazardous to real-time audio.
+ ** When launched with `--audit`, timed test cases performed locally are accompanied
+ ** by a util::ThreadAudit, sampling the threads of the Yoshimi subprocess in the background
+ ** while the test is running. Afterwards, the thread which consumed most CPU time is taken
+ ** as the rendering thread; its page faults, involuntary context switches and system calls
+ ** are summed up as _violations,_ and tracked as a time series in `<TestID>-rtaudit.csv`.
+ ** A warning is issued when the violations increase beyond the past fluctuations.
+ **
+ ** @see util::ThreadAudit
+ ** @see SystemWatch.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_REALTIME_AUDIT_HPP_
+#define TESTRUNNER_SUITE_STEP_REALTIME_AUDIT_HPP_
+
+
+#include "util/rtaudit.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+#include "suite/step/Scaffolding.hpp"
+#include "suite/step/PathSetup.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Sample the threads of the subject in the background,
+ * starting after launch, prior to the test invocation.
+ * @note #conclude must be called after the test invocation
+ *       to stop the sampling thread and retrieve the findings.
+ */
+class RealtimeAudit
+    : public TestStep
+{
+    Scaffolding& launcher_;
+
+    std::unique_ptr<util::ThreadAudit> audit_;
+    std::thread sampler_;
+    std::mutex lock_;
+    std::condition_variable stopSignal_;
+    bool active_{false};
+
+    std::vector<util::ThreadCounters> threads_;
+    string method_;
+
+    Result perform()  override;
+
+public:
+   ~RealtimeAudit();
+    RealtimeAudit(Scaffolding& launcher)
+        : launcher_{launcher}
+    { }
+
+    /** stop sampling (idempotent)
+     * @return counters for each thread of the subject */
+    std::vector<util::ThreadCounters> const& conclude();
+
+    string method()  const { return method_; }
+
+private:
+    void sampleLoop();
+};
+
+
+
+/**
+ * Identify the rendering thread, record its hazard counters
+ * and compare them with past measurements.
+ */
+class RealtimeJudgement
+    : public TestStep
+{
+    RealtimeAudit& audit_;
+    PathSetup& pathSpec_;
+    PTimings globalTimings_;
+    Progress& progressLog_;
+
+    Result perform()  override;
+
+public:
+    RealtimeJudgement(RealtimeAudit& audit
+                     ,PathSetup& pathSetup
+                     ,PTimings globalTimings
+                     ,Progress& progressLog)
+        : audit_{audit}
+        , pathSpec_{pathSetup}
+        , globalTimings_{globalTimings}
+        , progressLog_{progressLog}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_REALTIME_AUDIT_HPP_*/
@@ -0,0 +1,86 @@
+/*
+ *  SandboxReset - reset the private home of the subject prior to launch
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file SandboxReset.hpp
+ ** Prepare the private home directory for the next launch of the subject.
+ ** This step is wired immediately before an ExeLauncher and passed to it as
+ ** LaunchEnvironment, so that Yoshimi finds its configuration in the sandbox.
+ **
+ ** @see suite::Sandbox
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_SANDBOX_RESET_HPP_
+#define TESTRUNNER_SUITE_STEP_SANDBOX_RESET_HPP_
+
+
+#include "util/error.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Sandbox.hpp"
+#include "suite/step/Scaffolding.hpp"
+
+#include <string>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Reset the sandbox from its seed and provide the environment to use it.
+ * @note must be passed as LaunchEnvironment to the ExeLauncher.
+ */
+class SandboxReset
+    : public TestStep
+    , public LaunchEnvironment
+{
+    PSandbox sandbox_;
+
+
+    Result perform()  override
+    try {
+        sandbox_->reset();
+        return Result::OK();
+    }
+    catch(fs::filesystem_error& fsErr)
+    {
+        return Result{ResCode::MALFUNCTION, "Unable to reset the sandbox -- "+string{fsErr.what()}};
+    }
+
+public:
+    SandboxReset(PSandbox sandbox)
+        : sandbox_{sandbox}
+    {
+        if (not sandbox_)
+            throw error::LogicBroken("SandboxReset wired without a sandbox.");
+    }
+
+    VectorS environment()  const override
+    {
+        return sandbox_->environment();
+    }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_SANDBOX_RESET_HPP_*/
@@ -33,12 +33,15 @@
 
 #include "suite/step/Scaffolding.hpp"
 #include "suite/step/PrepareScript.hpp"
+#include "suite/step/PathSetup.hpp"
 #include "suite/step/Watcher.hpp"
 #include "util/format.hpp"
 #include "util/parse.hpp"
 #include "Config.hpp"
 
 #include <cassert>
+#include <chrono>
+#include <fstream>
 #include <utility>
 #include <string>
 #include <regex>
@@ -48,6 +51,7 @@ using std::regex;
 using std::smatch;
 using std::string;
 using util::formatVal;
+using util::isnil;
 
 namespace suite{
 namespace step {
@@ -69,6 +73,21 @@ namespace {// Implementation helpers
                 };
     }
 
+    /** how to detect that Yoshimi rejected some command
+     * @return empty Matcher when no failure pattern is configured */
+    MatchCond::Matcher expectFailureMarker(string failPattern)
+    {
+        if (isnil(failPattern))
+            return MatchCond::Matcher{};
+        try {
+            return buildMatcherFor(failPattern);
+        }
+        catch(std::regex_error& ex)
+        {
+            throw error::Misconfig("Invalid failPattern "+formatVal(failPattern)+": "+ex.what());
+        }
+    }
+
     /** how to detect that a script has finished */
     MatchCond::Matcher expectFinishedMarker(Script const& script)
     {
@@ -91,20 +110,27 @@ namespace {// Implementation helpers
 // Emit VTables and dtors here....
 Scaffolding::~Scaffolding() { }
 ExeLauncher::~ExeLauncher() { }
+CommandLauncher::~CommandLauncher() { }
+RemoteLauncher::~RemoteLauncher() { }
+LaunchEnvironment::~LaunchEnvironment() { }
 
 
 
 ExeLauncher::ExeLauncher(fs::path testSubject
                         ,fs::path topicPath
                         ,string timeoutSpec
+                        ,string failPattern
                         ,string exeArguments
                         ,Progress& progress
-                        ,MaybeScript script)
+                        ,MaybeScript script
+                        ,Environments environment)
     : subject_{testSubject}
     , topicPath_{topicPath}
     , timeoutSec_{parseDuration(timeoutSpec)}
     , progressLog_{progress}
     , testScript_{script}
+    , failureMarker_{expectFailureMarker(failPattern)}
+    , environment_{move(environment)}
     , arguments_{move(util::tokeniseCmdline(exeArguments))}
 { }
 
@@ -115,9 +141,16 @@ Result ExeLauncher::perform()
     if (not fs::exists(subject_))
         return Result{ResCode::MALFUNCTION, "Executable not found: "+formatVal(subject_)};
 
+    VectorS environment;
+    for (MaybeEnvironment source : environment_)
+        if (source)
+            for (string& setting : source->environment())
+                environment.push_back(move(setting));
+
     progressLog_.out("ExeLaucher: start Yoshimi subprocess...");
+    auto launchTime = std::chrono::steady_clock::now();
     subprocess_.reset(
-        new Watcher{launchSubprocess(subject_, arguments_)});
+        new Watcher{launchSubprocess(subject_, arguments_, environment)});
 
     progressLog_.out("ExeLaucher: wait for Yoshimi to become ready...");
     return maybe("startupYoshimi",
@@ -126,6 +159,7 @@ Result ExeLauncher::perform()
                     .onCondition(MATCH_YOSHIMI_READY)
                     .activate();
             waitFor(condition);
+            startupTime_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count();
             return Result::OK();
         });
 }
@@ -141,7 +175,7 @@ Result ExeLauncher::triggerTest()
     auto theEnd = subprocess_->retrieveExitCode();
     int exitCode = waitFor(theEnd);
     subprocess_.reset();  // join Watcher Thread
-    if (0 == exitCode)
+    if (0 == exitCode or isBroken())  // a killed subject exits with failure anyway
         return result;
     else
         return Result{ResCode::MALFUNCTION
@@ -155,20 +189,27 @@ Result ExeLauncher::run(Script const& script)
     return maybe("runScript",
     [&] {
             assert(subprocess_);
-            for (auto& line : script)
-                subprocess_->send2child(line);
-
+            // activate matching prior to sending, so no echo can slip through
             auto condition = subprocess_->matchTask
                     .onCondition(expectFinishedMarker(script))
                     .withPrecondition(expectEndMarker(script))
+                    .failOn(failureMarker_)
                     .logOutputInto(progressLog_)
                     .activate();
+            for (auto& line : script)
+                subprocess_->send2child(line);
             waitFor(condition);
             return Result::OK();
         });
 }
 
 
+int ExeLauncher::subjectPID()  const
+{
+    return subprocess_? subprocess_->pid() : 0;
+}
+
+
 void ExeLauncher::cleanUp()
 {
     if (subprocess_)
@@ -198,4 +239,159 @@ void ExeLauncher::markFailed()
 }
 
 
+
+
+
+
+CommandLauncher::CommandLauncher(fs::path topicPath
+                                ,string timeoutSpec
+                                ,string commandLine
+                                ,Progress& progress)
+    : topicPath_{topicPath}
+    , timeoutSec_{parseDuration(timeoutSpec)}
+    , progressLog_{progress}
+    , executable_{}
+    , arguments_{move(util::tokeniseCmdline(commandLine))}
+{
+    if (arguments_.empty())
+        throw error::Misconfig("Empty command to launch for "+formatVal(topicPath));
+    executable_ = arguments_.front();
+    arguments_.erase(arguments_.begin());
+}
+
+
+/** @remark the command is only launched when the test is triggered */
+Result CommandLauncher::perform()
+{
+    progressLog_.indicateTest(topicPath_);
+    if (executable_.has_parent_path() and not fs::exists(executable_))
+        return Result{ResCode::MALFUNCTION, "Command not found: "+formatVal(executable_)};
+    return Result::OK();
+}
+
+
+/**
+ * Run the command to completion, capturing its output.
+ * @remark a condition never matching is installed solely
+ *         to log all output lines into the Progress log.
+ */
+Result CommandLauncher::triggerTest()
+{
+    progressLog_.out("CommandLauncher: run "+formatVal(executable_)+"...");
+    subprocess_.reset(
+        new Watcher{launchSubprocess(executable_, arguments_)});
+    subprocess_->matchTask
+               .onCondition([](string const&){ return false; })
+               .logOutputInto(progressLog_)
+               .activate();
+    auto theEnd = subprocess_->retrieveExitCode();
+    if (std::future_status::timeout == theEnd.wait_for(timeoutSec_))
+    {
+        Scaffolding::markFailed();
+        subprocess_->kill();
+        subprocess_.reset();
+        return Result{ResCode::MALFUNCTION
+                     ,"TIMEOUT after "+formatVal(timeoutSec_.count())+"s waiting for the command to complete"};
+    }
+    int exitCode = theEnd.get();
+    subprocess_.reset();  // join Watcher Thread
+    if (0 == exitCode)
+        return Result::OK();
+    else
+        return Result{ResCode::MALFUNCTION
+                     ,"Command exited with failure code: "
+                     + showYoshimiExit(exitCode)};
+}
+
+
+int CommandLauncher::subjectPID()  const
+{
+    return subprocess_? subprocess_->pid() : 0;
+}
+
+
+void CommandLauncher::cleanUp()
+{
+    if (subprocess_)
+    {
+        subprocess_->kill();
+        subprocess_.reset();
+    }
+}
+
+
+
+
+
+RemoteLauncher::RemoteLauncher(PDispatcher dispatcher
+                              ,fs::path topicPath
+                              ,string timeoutSpec
+                              ,Progress& progress
+                              ,PathSetup& pathSetup)
+    : dispatcher_{move(dispatcher)}
+    , topicPath_{topicPath}
+    , timeoutSec_{parseDuration(timeoutSpec)}
+    , progressLog_{progress}
+    , pathSetup_{pathSetup}
+    , outcome_{dispatcher_->enqueue(topicPath.string())}
+{ }
+
+
+Result RemoteLauncher::perform()
+{
+    progressLog_.indicateTest(topicPath_);
+    dispatcher_->relayNotices(progressLog_);
+    return Result::OK();
+}
+
+
+/**
+ * Wait for the remote worker to deliver the outcome.
+ * @remark a worker may still be busy with other cases; thus the
+ *         timeout from the test spec only applies while no worker
+ *         is connected at all. Lost workers are detected by the
+ *         Dispatcher and the case is then handed to another worker.
+ */
+Result RemoteLauncher::triggerTest()
+{
+    progressLog_.out("Await test result from remote worker...");
+    auto waiting = Duration::zero();
+    while (std::future_status::timeout == outcome_.wait_for(std::chrono::seconds(1)))
+    {
+        dispatcher_->relayNotices(progressLog_);
+        waiting = dispatcher_->workerCnt()? Duration::zero() : waiting + std::chrono::seconds(1);
+        if (waiting >= timeoutSec_)
+        {
+            Scaffolding::markFailed();
+            return Result{ResCode::MALFUNCTION
+                         ,"No worker connected within "+formatVal(timeoutSec_.count())+"s"};
+        }
+    }
+    dispatcher_->relayNotices(progressLog_);
+    RemoteOutcome outcome = outcome_.get();
+    contamination_ = outcome.contamination;
+    for (auto& [isError, line] : outcome.output)
+        if (isError)
+            progressLog_.err(line);
+        else
+            progressLog_.out(line);
+    if (not isnil(outcome.probe))
+    {
+        std::ofstream probeFile{string(pathSetup_[def::KEY_fileProbe]), std::ios::binary | std::ios::trunc};
+        probeFile.write(outcome.probe.data(), std::streamsize(outcome.probe.size()));
+        if (not probeFile)
+            throw error::State("Unable to store sound probe received from worker "+outcome.worker);
+    }
+    if (ResCode::MALFUNCTION == outcome.code)
+        Scaffolding::markFailed();
+    return Result{outcome.code, "("+outcome.worker+") "+outcome.summary};
+}
+
+
+void RemoteLauncher::cleanUp()
+{
+    /* NOP: the remote worker cleans up on its own */
+}
+
+
 }}//(End)namespace suite::step
@@ -40,6 +40,8 @@
 #include "suite/TestStep.hpp"
 #include "suite/Progress.hpp"
 #include "suite/step/Script.hpp"
+#include "suite/step/MatchTask.hpp"
+#include "suite/Dispatcher.hpp"
 
 #include <filesystem>
 #include <optional>
@@ -57,7 +59,25 @@ using Duration = decltype(std::chrono::seconds(std::declval<int>()));
 using MaybeScript = suite::MaybeRef<suite::step::Script>;
 
 
+/**
+ * Interface: additional environment settings for a subprocess to launch,
+ * which become available only when the test is actually performed.
+ */
+class LaunchEnvironment
+{
+public:
+    virtual ~LaunchEnvironment();  ///< this is an interface
+
+    /** @return settings in the form `KEY=value` */
+    virtual VectorS environment()  const =0;
+};
+
+using MaybeEnvironment = suite::MaybeRef<LaunchEnvironment>;
+using Environments = std::vector<MaybeEnvironment>;
+
+
 class Watcher;
+class PathSetup;
 
 
 /**
@@ -83,6 +103,9 @@ public:
     virtual Result triggerTest() =0;
     virtual void   cleanUp()     =0;
 
+    /** @return process ID of the running subject, or 0 if not run locally */
+    virtual int subjectPID()  const { return 0; }
+
     bool isBroken()  const
     { return not sane_; }
 
@@ -103,12 +126,21 @@ class ExeLauncher
     fs::path topicPath_;
     Duration  timeoutSec_;
     Progress& progressLog_;
-    VectorS   arguments_;
 
     /** (optional) a dedicated test script */
     MaybeScript testScript_;
 
+    /** (optional) output indicating that Yoshimi rejected the script */
+    MatchCond::Matcher failureMarker_;
+
+    /** (optional) additional environment settings for the subject */
+    Environments environment_;
+
+    /** additional command line arguments for the subject */
+    VectorS   arguments_;
+
     unique_ptr<Watcher> subprocess_;
+    double startupTime_{0.0};
 
 
     Result perform()     override;
@@ -121,11 +153,17 @@ public:
     ExeLauncher(fs::path testSubject
                ,fs::path topicPath
                ,string timeoutSpec
+               ,string failPattern
                ,string exeArguments
                ,Progress& progress
-               ,MaybeScript script);
+               ,MaybeScript script
+               ,Environments environment ={});
 
     Result run(Script const&);
+    int subjectPID()  const override;
+
+    /** @return time in ms from launch until Yoshimi reported to be up and running */
+    double startupTime()  const { return startupTime_; }
 
 private:
     template<typename T>
@@ -135,6 +173,77 @@ private:
 
 
 
+/**
+ * Specialised Scaffolding to run an arbitrary command as benchmark.
+ * The command is launched when triggered and runs to completion,
+ * while all output is captured into the Progress log.
+ */
+class CommandLauncher
+    : public Scaffolding
+{
+    fs::path  topicPath_;
+    Duration  timeoutSec_;
+    Progress& progressLog_;
+    fs::path  executable_;
+    VectorS   arguments_;
+
+    unique_ptr<Watcher> subprocess_;
+
+
+    Result perform()     override;
+    Result triggerTest() override;
+    void   cleanUp()     override;
+
+public:
+   ~CommandLauncher();
+    CommandLauncher(fs::path topicPath
+                   ,string timeoutSpec
+                   ,string commandLine
+                   ,Progress& progress);
+
+    int subjectPID()  const override;
+};
+
+
+
+/**
+ * Specialised Scaffolding to delegate the test invocation to a remote worker.
+ * The test case is enqueued with the suite::Dispatcher right away when building
+ * the suite, allowing the workers to run ahead; when triggered, the outcome is
+ * awaited and the relayed output and sound probe are placed as if the test
+ * had been performed locally.
+ */
+class RemoteLauncher
+    : public Scaffolding
+{
+    PDispatcher dispatcher_;
+    fs::path  topicPath_;
+    Duration  timeoutSec_;
+    Progress& progressLog_;
+    PathSetup& pathSetup_;
+
+    std::future<RemoteOutcome> outcome_;
+    double contamination_{0.0};
+
+
+    Result perform()     override;
+    Result triggerTest() override;
+    void   cleanUp()     override;
+
+public:
+   ~RemoteLauncher();
+    RemoteLauncher(PDispatcher dispatcher
+                  ,fs::path topicPath
+                  ,string timeoutSpec
+                  ,Progress& progress
+                  ,PathSetup& pathSetup);
+
+    /** system load score, as sampled by the worker while the subject was running */
+    double contamination()  const { return contamination_; }
+};
+
+
+
 /** blocking wait with the timeout configured in test spec */
 template<typename T>
 T ExeLauncher::waitFor(std::future<T>& condition)
@@ -168,6 +277,13 @@ catch(error::FailedLaunch& crash)
                  ,"Crash while "+operationID
                  +": " + crash.what()};
 }
+catch(error::Rejected& failure)
+{
+    this->markFailed();
+    return Result{ResCode::MALFUNCTION
+                 ,"Failure while "+operationID
+                 +": " + failure.what()};
+}
 catch(...)
 {
     this->markFailed();
@@ -0,0 +1,172 @@
+/*
+ *  SceneCost - attribute the runtime of a scene to its parts and effects
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file SceneCost.cpp
+ ** Implementation of differential cost attribution for scenes.
+ ** The cost of a component is `runtime(full) - runtime(without component)`; the
+ ** _share_ relates this cost to the runtime of the full scene. Since the runtime
+ ** of the full scene itself fluctuates, the cost is subject to error propagation
+ ** from both measurements, and thus only a drift beyond 3σ of past costs (and at
+ ** least 2% of the full runtime) is flagged. A share is deemed disturbed when either
+ ** the full run or the variant run was contaminated by system load; such rows are
+ ** kept for the record, but excluded from the reference of later runs.
+ **
+ */
+
+
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/SceneCost.hpp"
+#include "suite/BuildInfo.hpp"
+#include "Config.hpp"
+
+#include <cmath>
+
+using util::formatVal;
+using util::Column;
+using util::VecD;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const size_t NANOSEC_per_MILLISEC = 1000*1000;
+    const string FULL_SCENE{"(full)"};
+    const uint MIN_REFERENCE_POINTS = 3;
+    const double MIN_TOLERANCE = 0.02;   // relative to full runtime
+}
+
+/**
+ * Data storage for the time series of component costs within a scene.
+ * Each run adds one row for the full scene, and one row per variant.
+ */
+struct TableSceneCost
+{
+    Column<string>   timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>     variant{"Variant"};            ///< label of the variant, or `(full)` for the complete scene
+    Column<double>     runtime{"Runtime ms"};         ///< runtime of this variant
+    Column<double>        cost{"Cost ms"};            ///< runtime of the full scene minus runtime of this variant
+    Column<double>       share{"Share"};              ///< cost relative to the runtime of the full scene
+    Column<double>   contamination{"Contamination"};  ///< system disturbance observed during full or variant run (0 = quiet)
+    Column<string>     profile{"Profile"};            ///< build profile (optimisation level) of the subject
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,variant
+                       ,runtime
+                       ,cost
+                       ,share
+                       ,contamination
+                       ,profile
+                       );
+    }
+};
+
+using SceneCostData = util::DataFile<TableSceneCost>;
+
+
+namespace {
+    /** @return `(avg, 3·σ)` of past undisturbed costs for the variant, or `(0,0)` if insufficient data */
+    std::pair<double,double> pastCost(SceneCostData const& data, string const& variant, string const& profile
+                                     ,uint avgPoints, double contaminationLimit)
+    {
+        VecD past;
+        for (size_t i = data.size(); 0 < i and past.size() < avgPoints; --i)
+            if (data.variant.data[i-1] == variant
+                and data.contamination.data[i-1] <= contaminationLimit
+                and BuildInfo::isComparable(profile, data.profile.data[i-1]))
+                past.push_back(data.share.data[i-1]);
+        if (past.size() < MIN_REFERENCE_POINTS)
+            return {0.0, 0.0};
+        double avg = util::averageLastN(past, past.size());
+        return {avg, 3 * util::sdev(past, avg)};
+    }
+
+    string showPercent(double relVal)
+    {
+        return formatVal(std::round(relVal * 1000) / 10) + "%";
+    }
+}
+
+
+
+Result SceneCost::perform()
+{
+    if (not fullScene_.wasCaptured())
+        return Result::Warn("Skip SceneCost: no runtime for the full scene.");
+
+    double fullTime = fullScene_.getRuntime() / NANOSEC_per_MILLISEC;
+    double fullContamination = systemWatch_? systemWatch_->conclude() : 0.0;
+    string const& profile = globalTimings_->subjectBuild(subject_).profile;
+    double contaminationLimit = globalTimings_->contaminationLimit;
+
+    SceneCostData data{pathSpec_[def::KEY_fileSceneCost]};
+    auto record = [&](string const& label, double runtime, double contamination)
+                    {
+                        data.newRow();
+                        data.timestamp = Config::timestamp;
+                        data.variant = label;
+                        data.runtime = runtime;
+                        data.cost = fullTime - runtime;
+                        data.share = 0.0 < fullTime? (fullTime - runtime) / fullTime : 0.0;
+                        data.contamination = contamination;
+                        data.profile = profile;
+                    };
+
+    string breakdown, drifts, disturbed;
+    std::vector<std::tuple<string,double,double,std::pair<double,double>>> costs;
+    for (auto& [label, output, watch] : variants_)
+        if (output->wasCaptured())
+            costs.emplace_back(label, output->getRuntime() / NANOSEC_per_MILLISEC
+                              ,std::max(fullContamination, watch->conclude())
+                              ,pastCost(data, label, profile, globalTimings_->baselineAvg, contaminationLimit));
+        else
+            drifts += " "+label+"(no runtime)";
+
+    record(FULL_SCENE, fullTime, fullContamination);
+    for (auto& [label, runtime, contamination, ref] : costs)
+    {
+        record(label, runtime, contamination);
+        double share = data.share;
+        breakdown += " "+label+"="+showPercent(share);
+        if (contaminationLimit < contamination)
+        {
+            disturbed += " "+label;
+            continue;
+        }
+        auto [avg, tolerance] = ref;
+        tolerance = std::max(tolerance, MIN_TOLERANCE);
+        if (0.0 < ref.second and tolerance < fabs(share - avg))
+            drifts += " "+label+"("+showPercent(avg)+"→"+showPercent(share)+")";
+    }
+    data.save(globalTimings_->timingsKeep * (costs.size()+1));
+
+    progressLog_.note("SceneCost: full="+formatVal(fullTime)+"ms"+breakdown);
+    if (not util::isnil(disturbed))
+        progressLog_.note("SceneCost: system disturbed, cost not judged:"+disturbed);
+    if (not util::isnil(drifts))
+        return Result::Warn("Scene component cost changed:"+drifts);
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,108 @@
+/*
+ *  SceneCost - attribute the runtime of a scene to its parts and effects
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file SceneCost.hpp
+ ** Attribute the computation cost of a multi-part scene to its individual components.
+ ** A test case of type def::TYPE_SCENE loads a complete Yoshimi state with several active
+ ** parts and effects, and then plays the note pattern of the test script. Besides this
+ ** full run, which is verified for sound and runtime like any other test, the same test
+ ** is repeated for each _variant_ defined in the spec, where a single CLI command disables
+ ** one part or effect. The difference of runtime against the full scene is taken as the
+ ** cost of this component. These costs are stored as time series in `<TestID>-scenecost.csv`,
+ ** and a warning is issued when the cost of a component drifts beyond the fluctuations
+ ** observed in past runs. Like other runtime measurements, each row records the system
+ ** contamination and the build profile; disturbed runs or incompatible builds are
+ ** excluded from the reference, and a disturbed run is recorded but not judged.
+ **
+ ** @see setup::SceneMould
+ ** @see OutputObservation.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_SCENE_COST_HPP_
+#define TESTRUNNER_SUITE_STEP_SCENE_COST_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/OutputObservation.hpp"
+#include "suite/step/SystemWatch.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+#include <vector>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Step to compute the differential cost of each scene variant
+ * against the full scene, and to record these costs.
+ */
+class SceneCost
+    : public TestStep
+{
+public:
+    /** differential run with one component disabled */
+    struct Variant
+    {
+        string label;
+        OutputObservation* output;
+        SystemWatch* systemWatch;
+    };
+
+private:
+    PathSetup& pathSpec_;
+    OutputObservation& fullScene_;
+    MaybeRef<SystemWatch> systemWatch_;
+    std::vector<Variant> variants_;
+    Progress& progressLog_;
+    suite::PTimings globalTimings_;
+    fs::path subject_;
+
+    Result perform()  override;
+
+public:
+    SceneCost(PathSetup& pathSetup
+             ,OutputObservation& fullScene
+             ,MaybeRef<SystemWatch> systemWatch
+             ,std::vector<Variant> variants
+             ,Progress& progress
+             ,suite::PTimings aggregator
+             ,fs::path subject)
+        : pathSpec_{pathSetup}
+        , fullScene_{fullScene}
+        , systemWatch_{systemWatch}
+        , variants_{std::move(variants)}
+        , progressLog_{progress}
+        , globalTimings_{aggregator}
+        , subject_{subject}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_SCENE_COST_HPP_*/
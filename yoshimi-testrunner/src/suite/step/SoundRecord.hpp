@@ -56,6 +56,7 @@ namespace step {
  * Write sound probe data and residual (differences) into a WAV soundfile,
  * located next to the test case definition. Data is written only in case
  * of test failure, or when a new baseline waveform shall be established.
+ * Long renders exceeding 4GiB are written as RF64 automatically.
  */
 class SoundRecord
     : public TestStep
@@ -82,9 +83,10 @@ class SoundRecord
             and (not fs::exists(baseline)
                  or not judgement_.succeeded)
            )
-        {
-            soundProbe_.saveProbe(baseline);
-            return Result::Warn("Store "+string{baseline});
+        {   // container is chosen by size: RF64 beyond the 4GiB limit of WAV
+            auto container = soundProbe_.saveProbe(baseline);
+            return Result::Warn("Store "+string{baseline}
+                               +(container == util::SoundContainer::WAV? "" : " as "+util::containerName(container)));
         }
 
         return Result::OK();
@@ -0,0 +1,197 @@
+/*
+ *  StartupCost - test steps to control the page cache and track start-up times
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file StartupCost.cpp
+ ** Implementation of page cache eviction and start-up time tracking.
+ ** The shared libraries of the subject are located once by inspecting the ELF dynamic section.
+ ** Since the kernel is free to ignore the advice to drop pages, the outcome of the eviction is
+ ** checked with `mincore()` on a mapping of each file; only files without any resident page
+ ** count as evicted, and the share of pages still resident is recorded alongside.
+ ** Start-up times are only compared within the same cache mode and build profile, since a
+ ** cold start can easily take ten times as long; a warning is issued when the start-up time
+ ** increases beyond 3·σ of the past measurements, and at least by 5%.
+ **
+ */
+
+
+#include "util/elf.hpp"
+#include "util/data.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+#include "suite/step/StartupCost.hpp"
+#include "Config.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <map>
+
+using util::formatVal;
+using util::Column;
+using util::VecD;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const uint MIN_REFERENCE_POINTS = 3;
+    const double MIN_INCREASE = 0.05;   // relative to the average start-up time
+
+    struct Residency
+    {
+        size_t resident{0};
+        size_t pages{0};
+    };
+
+    /** @return pages of the file held in the page cache, as reported by `mincore()` */
+    Residency residentPages(int fd)
+    {
+        struct stat info;
+        if (0 != fstat(fd, &info) or 0 == info.st_size)
+            return Residency{};
+        size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+        size_t pages = (size_t(info.st_size) + pageSize-1) / pageSize;
+        void* mem = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED)
+            return Residency{0, pages};
+        std::vector<unsigned char> vec(pages);
+        size_t resident = 0;
+        if (0 == mincore(mem, size_t(info.st_size), vec.data()))
+            resident = size_t(std::count_if(vec.begin(), vec.end(), [](unsigned char v){ return v & 1; }));
+        munmap(mem, size_t(info.st_size));
+        return Residency{resident, pages};
+    }
+
+    /** advise the kernel to drop the file from the page cache
+     * @return pages still resident afterwards; all pages if the file can not be opened */
+    Residency evictFromPageCache(fs::path file)
+    {
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0)
+            return Residency{1, 1};
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        Residency remains = residentPages(fd);
+        close(fd);
+        return remains;
+    }
+
+    std::vector<fs::path> const& librariesOf(fs::path subject)
+    {
+        static std::map<fs::path, std::vector<fs::path>> cache;
+        auto pos = cache.find(subject);
+        if (pos == cache.end())
+            pos = cache.emplace(subject, util::sharedLibraries(subject)).first;
+        return pos->second;
+    }
+}
+
+/**
+ * Data storage for the time series of start-up times of the subject.
+ */
+struct TableStartup
+{
+    Column<string> timestamp{"Timestamp"};          ///< Timestamp of the Testsuite run
+    Column<string>      mode{"Mode"};               ///< cache mode: `warm` or `cold`
+    Column<double>   startup{"Startup ms"};         ///< time from launch until Yoshimi is up and running
+    Column<uint>     evicted{"Evicted files"};      ///< files without resident pages after eviction prior to launch
+    Column<double> tolerance{"Tolerance"};          ///< 3·σ of past start-up times in this mode
+    Column<string>   buildID{"Build-ID"};           ///< GNU build-id of the subject (abbreviated)
+    Column<string>   profile{"Profile"};            ///< build profile of the subject
+    Column<double>  resident{"Resident"};           ///< share of pages of those files still cached after eviction
+
+    auto allColumns()
+    {   return std::tie(timestamp
+                       ,mode
+                       ,startup
+                       ,evicted
+                       ,tolerance
+                       ,buildID
+                       ,profile
+                       ,resident
+                       );
+    }
+};
+
+using StartupData = util::DataFile<TableStartup>;
+
+
+
+Result EvictPageCache::perform()
+{
+    evicted = 0;
+    std::vector<fs::path> files{subject_, stateFile_};
+    auto& libs = librariesOf(subject_);
+    files.insert(files.end(), libs.begin(), libs.end());
+    size_t resident = 0, pages = 0;
+    for (auto& file : files)
+    {
+        Residency remains = evictFromPageCache(file);
+        if (0 == remains.resident)
+            ++evicted;
+        resident += remains.resident;
+        pages += remains.pages;
+    }
+    residentShare = pages? double(resident) / pages : 0.0;
+    progressLog_.out("EvictPageCache: "+formatVal(evicted)+" of "+formatVal(files.size())+" files evicted; "
+                    +formatVal(resident)+" of "+formatVal(pages)+" pages still resident");
+    return Result::OK();
+}
+
+
+
+Result StartupJudgement::perform()
+{
+    double startup = launcher_.startupTime();
+    if (startup <= 0.0)
+        return Result::Warn("Skip StartupJudgement: subject did not start up");
+
+    auto& build = globalTimings_->subjectBuild(subject_);
+    StartupData data{pathSpec_[def::KEY_fileStartup]};
+    VecD past;
+    for (size_t i=data.size(); 0 < i and past.size() < globalTimings_->baselineAvg; --i)
+        if (data.mode.data[i-1] == mode_
+            and BuildInfo::isComparable(build.profile, data.profile.data[i-1]))
+            past.push_back(data.startup.data[i-1]);
+    double pastAvg = past.size()? util::averageLastN(past, past.size()) : 0.0;
+    double tolerance = past.size()? 3 * util::sdev(past, pastAvg) : 0.0;
+
+    data.newRow();
+    data.timestamp = Config::timestamp;
+    data.mode      = mode_;
+    data.startup   = startup;
+    data.evicted   = eviction_? eviction_->evicted : 0;
+    data.tolerance = tolerance;
+    data.buildID   = build.buildID;
+    data.profile   = build.profile;
+    data.resident  = eviction_? eviction_->residentShare : 0.0;
+    data.save(globalTimings_->timingsKeep);
+
+    if (MIN_REFERENCE_POINTS <= past.size()
+        and std::max(tolerance, MIN_INCREASE * pastAvg) < startup - pastAvg)
+        return Result::Warn("Start-up ("+mode_+" cache) slower: "+formatVal(startup)
+                           +"ms (avg of past: "+formatVal(pastAvg)+"ms)");
+    return Result::OK();
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,118 @@
+/*
+ *  StartupCost - test steps to control the page cache and track start-up times
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file StartupCost.hpp
+ ** Establish defined page cache conditions for timed test cases.
+ ** Without further measures, the first test case of a run pays for loading the subject
+ ** executable, its libraries and the initial state from disk, while later cases find all
+ ** in the page cache. When launched with `--cache=warm`, a timed test case is preceded by
+ ** a warm-up invocation, which is discarded; with `--cache=cold`, those files are evicted
+ ** from the page cache before each launch. In both modes, the time from launch until Yoshimi
+ ** is up and running is tracked per mode as time series in `<TestID>-startup.csv`.
+ ** @remark eviction is advisory: pages still mapped by another process (e.g. `libc`)
+ **         remain in the page cache; the actual outcome is verified with `mincore()`.
+ **
+ ** @see ExeLauncher::startupTime()
+ ** @see setup::ExeCliMould
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_STARTUP_COST_HPP_
+#define TESTRUNNER_SUITE_STEP_STARTUP_COST_HPP_
+
+
+#include "util/file.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+#include "suite/step/Scaffolding.hpp"
+#include "suite/step/PathSetup.hpp"
+
+#include <string>
+#include <vector>
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Evict the subject executable, its shared libraries
+ * and the initial state from the page cache.
+ */
+class EvictPageCache
+    : public TestStep
+{
+    fs::path subject_;
+    fs::path stateFile_;
+    Progress& progressLog_;
+
+    Result perform()  override;
+
+public:
+    EvictPageCache(fs::path subject
+                  ,fs::path stateFile
+                  ,Progress& progressLog)
+        : subject_{subject}
+        , stateFile_{stateFile}
+        , progressLog_{progressLog}
+    { }
+
+    uint evicted{0};           ///< files without any page remaining in the cache
+    double residentShare{0.0}; ///< pages of all those files still cached after eviction
+};
+
+
+
+/**
+ * Record the start-up time of the subject for the current cache mode,
+ * and compare it with past measurements in the same mode.
+ */
+class StartupJudgement
+    : public TestStep
+{
+    ExeLauncher& launcher_;
+    PathSetup& pathSpec_;
+    PTimings globalTimings_;
+    fs::path subject_;
+    string mode_;
+    MaybeRef<EvictPageCache> eviction_;
+
+    Result perform()  override;
+
+public:
+    StartupJudgement(ExeLauncher& launcher
+                    ,PathSetup& pathSetup
+                    ,PTimings globalTimings
+                    ,fs::path subject
+                    ,string mode
+                    ,MaybeRef<EvictPageCache> eviction)
+        : launcher_{launcher}
+        , pathSpec_{pathSetup}
+        , globalTimings_{globalTimings}
+        , subject_{subject}
+        , mode_{mode}
+        , eviction_{eviction}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_STARTUP_COST_HPP_*/
@@ -42,9 +42,13 @@
 #include "suite/step/Invocation.hpp"
 #include "suite/step/SoundJudgement.hpp"
 #include "suite/step/TimingJudgement.hpp"
+#include "suite/step/LoadSequence.hpp"
+#include "suite/step/LoadJudgement.hpp"
+#include "suite/step/ParetoBenchmark.hpp"
 #include "suite/Result.hpp"
 
 #include <string>
+#include <vector>
 #include <utility>
 
 namespace suite{
@@ -108,5 +112,141 @@ public:
 };
 
 
+
+/**
+ * Summary for a test case measuring instrument load times;
+ * the statistics record the load time of the whole corpus.
+ */
+class LoadSummary
+    : public TestStep
+{
+    fs::path topic_;
+    LoadSequence& loads_;
+    MaybeRef<LoadJudgement> judgeLoad_;
+
+
+    Result perform()  override
+    {
+        if (not loads_.isPerformed())
+            return Result{ResCode::MALFUNCTION, "Testcase did not run: "+util::formatVal(topic_)};
+
+        string report{"Performed;"};
+        ResCode testOutcome{ResCode::GREEN};
+        if (judgeLoad_)
+        {
+            report += " "+judgeLoad_->describe();
+            if (not judgeLoad_->succeeded)
+                testOutcome = judgeLoad_->resCode;
+        }
+        Statistics data{topic_
+                       ,testOutcome
+                       ,judgeLoad_? judgeLoad_->getLoadTime() : 0.0
+                       };
+        return Result(std::move(data), report);
+    }
+
+public:
+    LoadSummary(fs::path topic
+               ,LoadSequence& loads
+               ,MaybeRef<LoadJudgement> loadJudgement)
+        : topic_{topic}
+        , loads_{loads}
+        , judgeLoad_{loadJudgement}
+    { }
+};
+
+
+
+
+/**
+ * Summary for a benchmark with several metrics; the worst judgement
+ * determines the outcome, and the first metric is recorded as runtime.
+ */
+class BenchSummary
+    : public TestStep
+{
+public:
+    using MetricJudgements = std::vector<std::pair<string, MaybeRef<TimingJudgement>>>;
+
+private:
+    fs::path topic_;
+    Invocation& theTest_;
+    MetricJudgements judgements_;
+
+
+    Result perform()  override
+    {
+        if (not theTest_.isPerformed())
+            return Result{ResCode::MALFUNCTION, "Testcase did not run: "+util::formatVal(topic_)};
+
+        string report{"Performed;"};
+        ResCode testOutcome{ResCode::GREEN};
+        for (auto& [metric,judgement] : judgements_)
+            if (judgement)
+            {
+                report += " "+metric+": "+judgement->describe();
+                if (not judgement->succeeded
+                    and int(judgement->resCode) > int(testOutcome))
+                    testOutcome = judgement->resCode;
+            }
+        double runtime = 0.0;
+        if (not judgements_.empty() and judgements_.front().second)
+            runtime = judgements_.front().second->getRuntime();
+        Statistics data{topic_
+                       ,testOutcome
+                       ,runtime
+                       };
+        return Result(std::move(data), report);
+    }
+
+public:
+    BenchSummary(fs::path topic
+                ,Invocation& ivo
+                ,MetricJudgements judgements)
+        : topic_{topic}
+        , theTest_{ivo}
+        , judgements_{std::move(judgements)}
+    { }
+};
+
+
+/**
+ * Summary for a quality-versus-cost benchmark; the runtime
+ * of the reference render is recorded for the test case.
+ */
+class ParetoSummary
+    : public TestStep
+{
+    fs::path topic_;
+    Invocation& reference_;
+    ParetoPoint& refPoint_;
+    ParetoFrontier& frontier_;
+
+
+    Result perform()  override
+    {
+        if (not reference_.isPerformed())
+            return Result{ResCode::MALFUNCTION, "Testcase did not run: "+util::formatVal(topic_)};
+
+        Statistics data{topic_
+                       ,frontier_.resCode
+                       ,refPoint_.runtime_ms.value_or(0.0)
+                       };
+        return Result(std::move(data), "Performed; "+frontier_.describe());
+    }
+
+public:
+    ParetoSummary(fs::path topic
+                 ,Invocation& ivo
+                 ,ParetoPoint& refPoint
+                 ,ParetoFrontier& frontier)
+        : topic_{topic}
+        , reference_{ivo}
+        , refPoint_{refPoint}
+        , frontier_{frontier}
+    { }
+};
+
+
 }}//(End)namespace suite::step
 #endif /*TESTRUNNER_SUITE_STEP_SUMMARY_HPP_*/
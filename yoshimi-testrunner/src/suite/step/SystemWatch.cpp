@@ -0,0 +1,127 @@
+/*
+ *  SystemWatch - test step to monitor the system state during timing measurements
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file SystemWatch.cpp
+ ** Implementation of the background sampling thread.
+ ** Sampling happens every 100ms; in addition, one sample is taken right when
+ ** starting and another one when concluding, so that even very short tests
+ ** are covered. Reading the pseudo files is cheap, yet the sampling thread
+ ** sleeps most of the time, to avoid disturbing the measurement itself.
+ **
+ */
+
+
+#include "suite/step/SystemWatch.hpp"
+#include "suite/step/Scaffolding.hpp"
+#include "util/format.hpp"
+
+#include <chrono>
+
+using util::SysLoad;
+using util::formatVal;
+using util::sampleSystemLoad;
+
+namespace suite{
+namespace step {
+
+namespace {
+    const auto SAMPLING_INTERVAL = std::chrono::milliseconds(100);
+}
+
+
+SystemWatch::~SystemWatch()
+{
+    conclude();
+}
+
+
+Result SystemWatch::perform()
+{
+    conclude(); // safety: never run two samplers
+    score_ = 0.0;
+    worst_ = SysLoad{};
+    if (remote_)
+    {// sampled by the worker running the subject
+        active_ = true;
+        return Result::OK();
+    }
+    start_ = sampleSystemLoad();
+    capture(start_);
+    active_ = true;
+    sampler_ = std::thread([this]{ sampleLoop(); });
+    return Result::OK();
+}
+
+
+double SystemWatch::conclude()
+{
+    {
+        std::lock_guard<std::mutex> guard{lock_};
+        if (not active_) return score_;
+        active_ = false;
+    }
+    if (remote_)
+    {
+        score_ = remote_->contamination();
+        progressLog_.out("SystemWatch: contamination="+formatVal(score_)+" sampled on remote worker");
+        return score_;
+    }
+    stopSignal_.notify_all();
+    if (sampler_.joinable())
+        sampler_.join();
+    capture(sampleSystemLoad());
+    progressLog_.out("SystemWatch: contamination="+formatVal(score_)+" worst: "+worst_.describe());
+    return score_;
+}
+
+
+void SystemWatch::sampleLoop()
+{
+    std::unique_lock<std::mutex> guard{lock_};
+    while (not stopSignal_.wait_for(guard, SAMPLING_INTERVAL, [this]{ return not active_; }))
+    {
+        guard.unlock();
+        SysLoad load = sampleSystemLoad();
+        guard.lock();
+        capture(load);
+    }
+}
+
+
+string SystemWatch::describe()  const
+{
+    return remote_? "sampled on remote worker"
+                  : worst_.describe();
+}
+
+
+/** @remark the worst sample determines the score, since even
+ *          a short disturbance can spoil a timing measurement */
+void SystemWatch::capture(SysLoad const& sample)
+{
+    SysLoad load = sample.since(start_);
+    double score = load.contamination();
+    if (score < score_) return;
+    score_ = score;
+    worst_ = load;
+}
+
+
+}}//(End)namespace suite::step
@@ -0,0 +1,105 @@
+/*
+ *  SystemWatch - test step to monitor the system state during timing measurements
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file SystemWatch.hpp
+ ** Observe the state of the execution platform while a timing test is running.
+ ** Timing measurements can be _contaminated_ by unrelated activities on the system:
+ ** background jobs, memory or I/O pressure, or a CPU slowing down due to frequency
+ ** scaling or thermal throttling. Such disturbances can not be distinguished from a
+ ** genuine change of the subject's performance by looking at the run time alone.
+ ** Thus a sampling thread is started right before the test invocation, to capture
+ ** the [system load indicators](\ref util::SysLoad) in short intervals; the worst
+ ** _contamination score_ seen while the test was running is attached to the timing
+ ** measurement, allowing to discount such data points from judgement and statistics.
+ ** When the test is delegated to a remote worker, sampling the coordinator's host would
+ ** be pointless; the worker observes its own system instead, and the score is adopted
+ ** from the RemoteLauncher when concluding.
+ **
+ ** @see util::sampleSystemLoad()
+ ** @see TimingObservation.hpp
+ ** @see TimingJudgement.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_SYSTEM_WATCH_HPP_
+#define TESTRUNNER_SUITE_STEP_SYSTEM_WATCH_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/sysload.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+
+namespace suite{
+namespace step {
+
+class RemoteLauncher;
+
+
+/**
+ * Sample system load indicators in the background,
+ * starting immediately prior to the test invocation.
+ * @note #conclude must be called after the test invocation
+ *       to stop the sampling thread and retrieve the findings.
+ */
+class SystemWatch
+    : public TestStep
+{
+    Progress& progressLog_;
+    MaybeRef<RemoteLauncher> remote_;
+
+    std::thread sampler_;
+    std::mutex lock_;
+    std::condition_variable stopSignal_;
+    bool active_{false};
+
+    util::SysLoad start_{};
+    util::SysLoad worst_{};
+    double score_{0.0};
+
+    Result perform()  override;
+
+public:
+   ~SystemWatch();
+    SystemWatch(Progress& log, MaybeRef<RemoteLauncher> remote =std::nullopt)
+        : progressLog_{log}
+        , remote_{remote}
+    { }
+
+    /** stop sampling (idempotent)
+     * @return highest contamination score observed */
+    double conclude();
+
+    double contamination()  const { return score_; }
+    string describe()       const;
+
+private:
+    void sampleLoop();
+    void capture(util::SysLoad const&);
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_SYSTEM_WATCH_HPP_*/
@@ -65,6 +65,29 @@ using std::string;
 using util::formatVal;
 
 
+/**
+ * Tolerance band for a single timing measurement: local fluctuations combined with the error
+ * of the platform model. Since the expense is normalised out of model values, the model error
+ * (stdev) underestimates the spread by this factor.
+ */
+inline double combinedTolerance(double localTolerance, double modelTolerance, double expense)
+{
+    return util::errorSum(localTolerance, modelTolerance * expense);
+}
+
+/** @return judgement of a single measurement's Δ against the tolerance band */
+inline ResCode judgeDelta(double delta, double tolerance)
+{
+    if (delta < -tolerance)
+        return ResCode::WARNING;
+    if (tolerance < delta and delta <= 1.1 * tolerance)
+        return ResCode::WARNING;
+    if (tolerance < delta)
+        return ResCode::VIOLATION;
+    return ResCode::GREEN;
+}
+
+
 /**
  * Step to assess the timing behaviour and decide upon success or failure.
  * - The actual timing measurement is done by the Test-Invoker built into Yoshimi
@@ -90,7 +113,8 @@ class TimingJudgement
         Result judgement = determineTestResult();
         succeeded = (ResCode::GREEN == judgement.code);
         resCode = judgement.code;
-        msg_ = succeeded? "timing OK" : judgement.summary;
+        msg_ = judgement.notice? "timing OK (provisional)"
+             : succeeded?        "timing OK" : judgement.summary;
         return judgement;
     }
 
@@ -98,22 +122,36 @@ class TimingJudgement
     {
         auto [runtime,expense,currDelta,tolerance]  = timings_.getTestResults();
         double modelTolerance = globalTimings_->getModelTolerance();    // ±3σ covers 99% of all cases
-        modelTolerance *= expense;   // since expense is normalised out of model values
-                                     // the model error(stdev) underestimates the spread by this factor
-        double overallTolerance = util::errorSum(tolerance, modelTolerance);
+        double overallTolerance = combinedTolerance(tolerance, modelTolerance, expense);
+        overallTolerance *= globalTimings_->jitterFactor();  // platform currently more or less noisy than at calibration
         runtime_ = runtime;
 
-        if (tolerance == 0.0 or modelTolerance == 0.0)
+        if (globalTimings_->isProfileMismatch(timings_.subjectBuild()))
+            return Result::Warn("Subject build profile "+formatVal(timings_.subjectBuild().profile)
+                               +" differs from calibration ("+formatVal(globalTimings_->calibrationProfile())
+                               +"). Runtime ("+formatVal(runtime)+"ms) not judged");
+
+        double contamination = timings_.getContamination();
+        if (globalTimings_->contaminationLimit < contamination)
+            return Result::Warn("System disturbed during measurement (contamination="+formatVal(contamination)
+                               +"). Runtime ("+formatVal(runtime)+"ms) not judged and excluded from statistics");
+
+        if (expense == 0.0 and not calibrationRun_ and modelTolerance > 0.0)
+            if (auto provisional = timings_.getProvisional())
+                return judgeProvisional(*provisional, modelTolerance);
+
+        if (tolerance == 0.0 or modelTolerance * expense == 0.0)
             return calibrationRun_? Result::Warn("Calibration run. Runtime ("+formatVal(runtime)+"ms) not judged")
                                   : Result::Warn("Missing calibration. Can not judge runtime ("+formatVal(runtime)+"ms)");
 
         // check this single measurement against the tolerance band...
-        if (currDelta < -overallTolerance)
+        ResCode band = judgeDelta(currDelta, overallTolerance);
+        if (band != ResCode::GREEN and currDelta < 0)
             return Result::Warn("Runtime "+formatVal(runtime)
                                +"ms decreased by "+formatVal(100*currDelta / runtime)+"% below baseline; Δ ="+formatVal(currDelta)+"ms");
-        if (overallTolerance < currDelta and currDelta <= 1.1 * overallTolerance)
+        if (band == ResCode::WARNING)
             return Result::Warn("Runtime ("+formatVal(runtime)+"ms) slightly above established baseline; Δ = "+formatVal(currDelta)+"ms");
-        if (overallTolerance < currDelta)
+        if (band == ResCode::VIOLATION)
             return Result::Fail("Test failed: Runtime +"+formatVal(100*currDelta / runtime)
                                +"% above established baseline; Δ = "+formatVal(currDelta)
                                +"ms Runtime="+formatVal(runtime)+"ms.");
@@ -151,6 +189,30 @@ class TimingJudgement
     }
 
 
+    /**
+     * Judge a test case without expense baseline against the provisional estimate.
+     * @remark since the estimate is only a guess, a deviation is reported as warning
+     */
+    Result judgeProvisional(TimingObservation::Provisional const& estimate, double modelTolerance)
+    {
+        double overallTolerance = combinedTolerance(estimate.tolerance, modelTolerance, estimate.expense);
+        overallTolerance *= globalTimings_->jitterFactor();
+        string context = " (no baseline yet; expense "+formatVal(estimate.expense)
+                       + " ±"+formatVal(100*overallTolerance / (runtime_ - estimate.delta))+"% "
+                       + estimate.basis+")";
+
+        ResCode band = judgeDelta(estimate.delta, overallTolerance);
+        if (band != ResCode::GREEN and estimate.delta < 0)
+            return Result::Warn("Runtime ("+formatVal(runtime_)+"ms) "
+                               +formatVal(100*estimate.delta / runtime_)+"% below provisional expectation"+context);
+        if (band != ResCode::GREEN)
+            return Result::Warn("Runtime ("+formatVal(runtime_)+"ms) +"
+                               +formatVal(100*estimate.delta / runtime_)+"% above provisional expectation"+context);
+        return Result::Note(timings_.getCaseID()+": provisional timing OK, Runtime "
+                           +formatVal(runtime_)+"ms"+context);
+    }
+
+
 public:
     TimingJudgement(TimingObservation& timings
                    ,suite::PTimings aggregator
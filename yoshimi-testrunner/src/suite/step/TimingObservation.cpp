@@ -40,6 +40,7 @@
 #include "util/statistic.hpp"
 #include "suite/step/TimingObservation.hpp"
 #include "suite/Timings.hpp"
+#include "suite/TimingTables.hpp"
 #include "Config.hpp"
 
 #include <cmath>
@@ -55,77 +56,13 @@ namespace {
 }
 
 using std::min;
+using std::vector;
 using util::isnil;
 using util::backwards;
+using suite::BuildInfo;
 using util::averageLastN;
 using util::computeTimeSeriesLinearRegression;
 
-using util::Column;
-
-/**
- * Data storage for runtime measurement time series.
- * @remark for sake of readability and to support external evaluations,
- *         we deliberately capture several contextual parameters alongside.
- */
-struct TableRuntime
-{
-    Column<string>   timestamp{"Timestamp"};               ///< Timestamp of the Testsuite run
-    Column<double>     runtime{"Runtime ms"};              ///< the actual timing measurement in milliseconds
-    Column<size_t>     samples{"Samples count"};
-    Column<uint>         notes{"Notes count"};
-    Column<double>    platform{"Platform ms"};             ///< runtime predicted by platform model (in ms)
-    Column<double>     expense{"Expense Factor"};          ///< baseline(expected value) for the expense
-    Column<double> expenseCurr{"Expense Factor(current)"}; ///< `runtime == platform·expenseCurr`
-    Column<double>       delta{"Delta ms"};                ///< Δ of measured runtime against `platform·expense`
-    Column<double>      maTime{"MA Time short"};           ///< moving average of runtime (baselineAvg/2 points)
-    Column<double>   tolerance{"Tolerance"};               ///< tolerance band based on 3·σ observed (over baselineAvg points)
-
-    auto allColumns()
-    {   return std::tie(timestamp
-                       ,runtime
-                       ,samples
-                       ,notes
-                       ,platform
-                       ,expense
-                       ,expenseCurr
-                       ,delta
-                       ,maTime
-                       ,tolerance
-                       );
-    }
-};
-
-
-/**
- * Data storage for the expected expense factor ("Baseline").
- * @remark Beyond the actual expense factor, a history of past settings
- *         is maintained, together with contextual information.
- */
-struct TableExpense
-{
-    Column<string>   timestamp{"Timestamp"};               ///< Timestamp when setting this baseline
-    Column<uint>        points{"Averaged points"};         ///> Number of past data points averaged into this baseline
-    Column<double>     runtime{"Runtime(avg) ms"};         ///< averaged runtime used to define this baseline
-    Column<size_t>     samples{"Samples count"};           ///< samples count of the underlying test
-    Column<uint>         notes{"Notes count"};             ///< notes count of the underlying test
-    Column<double>    platform{"Platform ms"};             ///< runtime predicted by platform model for this baseline
-    Column<double>     expense{"Expense Factor"};          ///< expected value for the expense. This is the *actual baseline*.
-
-    auto allColumns()
-    {   return std::tie(timestamp
-                       ,points
-                       ,runtime
-                       ,samples
-                       ,notes
-                       ,platform
-                       ,expense
-                       );
-    }
-};
-
-
-
-
 /**
  * Extract relevant timing observations from captured behaviour.
  * Process the raw timing data into a time series, which can be
@@ -134,11 +71,10 @@ struct TableExpense
 class TimingTestData
     : public TimingTest
 {
-    using RuntimeData = util::DataFile<TableRuntime>;
-    using ExpenseData = util::DataFile<TableExpense>;
-
     RuntimeData runtime_;
     ExpenseData expense_;
+    double contaminationLimit_;
+    std::optional<TimingObservation::Provisional> provisional_;
 
 
     /* === Interface: TimingTest === */
@@ -148,7 +84,7 @@ class TimingTestData
         __requireMeasurementDone();
         avgPoints = ensureEquivalentDataPoints(avgPoints);
         return Point{double(runtime_.samples)
-                    ,averageLastN(runtime_.runtime.data, avgPoints)
+                    ,averageUncontaminated(runtime_.runtime.data, avgPoints)
                     ,double(runtime_.expense)
                     };
     }
@@ -157,10 +93,16 @@ class TimingTestData
     {
         __requireMeasurementDone();
         avgPoints = ensureEquivalentDataPoints(avgPoints);
-        return std::make_tuple(averageLastN(runtime_.delta.data, avgPoints)
+        return std::make_tuple(averageUncontaminated(runtime_.delta.data, avgPoints)
                               ,double{runtime_.tolerance});
     }
 
+    bool isDisturbed()  const override
+    {
+        __requireMeasurementDone();
+        return isContaminated(runtime_.size()-1);
+    }
+
     void recalc_and_save_current(PlatformFun model) override
     {
         __requireMeasurementDone();
@@ -170,10 +112,13 @@ class TimingTestData
 
 
 public:
-    TimingTestData(string testID, fs::path fileRuntime, fs::path fileExpense)
-        : TimingTest{testID}
+    TimingTestData(string testID, fs::path topic, string engine, bool platformRef
+                  ,fs::path fileRuntime, fs::path fileExpense, double contaminationLimit)
+        : TimingTest{testID, topic, engine, platformRef}
         , runtime_{fileRuntime}
         , expense_{fileExpense}
+        , contaminationLimit_{contaminationLimit}
+        , provisional_{}
     { }
 
     bool hasBaseline()  const
@@ -200,16 +145,21 @@ public:
      *         _expense factor._ For each test case an averaged expense factor
      *         is stored as *baseline* -- and thus deviations can be detected.
      */
-    void calculatePoint(uint notes, size_t smps, double rawTime, double prediction, uint baselineAvg)
+    void calculatePoint(uint notes, size_t smps, double rawTime, double prediction, uint baselineAvg
+                       ,double contamination, BuildInfo const& build)
     {
         runtime_.dupRow();
         auto& r = runtime_;
+        r.contamination = contamination;
+        r.buildID = build.buildID;
+        r.profile = build.profile;
         r.notes = notes;
         r.samples = smps;
         r.runtime = rawTime / MILLISEC_per_NANOSEC;
 
         r.platform = prediction / MILLISEC_per_NANOSEC; // all below in ms
         r.expense  = hasBaseline()? expense_.expense : 0.0;
+        r.engine   = engine;
 
         // apply the prediction model to factor out system dependency
         double expectedTime  = r.platform * r.expense;
@@ -217,13 +167,62 @@ public:
         r.delta       = 0.0 < expectedTime? r.runtime - expectedTime : 0.0;
 
         // moving average used as reference to establish a tolerance band
-        r.maTime = averageLastN(r.runtime.data, 5);
+        r.maTime = averageUncontaminated(r.runtime.data, 5);
         r.tolerance = calcLocalTolerance(baselineAvg);
 
         // Timestamp of current Testsuite run
         r.timestamp = Config::timestamp;
     }
 
+    /**
+     * Establish a provisional baseline for a case without expense baseline.
+     * @param prediction expense and tolerance estimated from similar test cases
+     * @remark the prediction is blended with the average of the own previous measurements,
+     *         with increasing weight of the latter, until `baselineAvg` points are available;
+     *         the own tolerance is only considered when based on at least two points.
+     */
+    void calcProvisional(std::optional<Timings::Prediction> prediction, uint baselineAvg)
+    {
+        auto& r = runtime_;
+        provisional_.reset();
+        if (hasBaseline() or r.platform <= 0.0)
+            return;
+
+        size_t siz = r.size();
+        size_t oldest = siz-1 - min<size_t>(baselineAvg, siz-1);
+        size_t prev = 0;
+        double sum = 0.0;
+        for (size_t i=siz-1; oldest < i; --i)
+            if (not isExcluded(i-1) and 0.0 < r.expenseCurr.data[i-1])
+            {
+                sum += r.expenseCurr.data[i-1];
+                ++prev;
+            }
+        if (not prediction and prev < 2)
+            return;
+
+        double weight = not prediction or prev >= baselineAvg? 1.0 : double(prev) / baselineAvg;
+        double weightTol = prev < 2? 0.0 : weight;
+        double ownExpense = 0 < prev? sum / prev : 0.0;
+        double expense   = (1-weight) * (prediction? prediction->expense : 0.0)
+                         + weight * ownExpense;
+        double tolerance = (1-weightTol) * (prediction? prediction->tolerance : 0.0)
+                         + weightTol * r.tolerance;
+        string basis = prediction? "predicted from "+formatVal(prediction->peers)+" cases in "+prediction->basis
+                                  +(0 < prev? " and "+formatVal(prev)+" own runs" : "")
+                                 : formatVal(prev)+" own runs";
+
+        provisional_ = TimingObservation::Provisional{expense
+                                                     ,r.runtime - r.platform * expense
+                                                     ,tolerance
+                                                     ,basis};
+    }
+
+    std::optional<TimingObservation::Provisional> const& getProvisional()  const
+    {
+        return provisional_;
+    }
+
     /** adjust current runtime measurement to factor in a changed platform model */
     void recalcCurrentPoint(double prediction)
     {
@@ -233,7 +232,7 @@ public:
         r.expenseCurr = r.runtime / r.platform;
         double expectedTime  = r.platform * r.expense;
         r.delta = 0.0 < expectedTime? r.runtime - expectedTime : 0.0;
-        r.maTime = averageLastN(r.runtime.data, 5);
+        r.maTime = averageUncontaminated(r.runtime.data, 5);
     }
 
     void persistRuntimes(uint rows2keep)
@@ -250,8 +249,9 @@ public:
         expense_.notes    = runtime_.notes;
         expense_.platform = runtime_.platform;
 
-        // define new baseline: average of the last timing measurements
-        expense_.runtime = averageLastN(runtime_.runtime.data, baselineAvg);
+        // define new baseline: average of the last timing measurements,
+        // excluding disturbed measurements and those of a different build profile
+        expense_.runtime = averageUncontaminated(runtime_.runtime.data, baselineAvg);
         expense_.expense = expense_.runtime / expense_.platform;
 
         // discard excess precision, since error band typically is well above 10%
@@ -262,6 +262,11 @@ public:
         expense_.save(baselineKeep);
     }
 
+    double getContamination()  const
+    {
+        return runtime_.contamination;
+    }
+
     double getExpense()  const
     {
         return hasBaseline()? expense_.expense : 0.0;
@@ -279,25 +284,27 @@ public:
     {
         return util::array_from_tuple(
                 computeTimeSeriesLinearRegression(
-                        util::lastN(runtime_.delta.data, n)));
+                        util::lastN(comparableSeries(runtime_.delta.data), n)));
     }
 
     /**
      * find timespan into the past without significant changes to the platform/environment.
      * @remark implemented by observing the runtime predicted by the platform model.
      * @return number of points while this prediction changed less than the local fluctuations
+     * @note  measurements of builds with different profile are not counted
      */
     uint stablePlatformTimespan()  const
     {
         double anchor = runtime_.platform;     // current platform model prediction
         double tolerance = runtime_.tolerance; // local fluctuations
-        auto platformData = backwards(runtime_.platform.data);
+        auto& platformData = runtime_.platform.data;
         uint points = 0;
-        for (auto p = begin(platformData);
-             p != end(platformData) and *p!=0.0 and fabs(*p - anchor) <= tolerance;
-             ++p
+        for (size_t i = runtime_.size();
+             0 < i and platformData[i-1]!=0.0 and fabs(platformData[i-1] - anchor) <= tolerance;
+             --i
             )
-            ++points;
+            if (isComparableBuild(i-1))
+                ++points;
         return points;
     }
 
@@ -334,8 +341,60 @@ private:
         return points;
     }
 
-    /** determine the amplitude of local fluctuations */
-    double calcLocalTolerance(size_t avgPoints) const
+    bool isContaminated(size_t row)  const
+    {
+        return contaminationLimit_ < runtime_.contamination.data[row];
+    }
+
+    /** was the measurement taken with a build profile comparable to the current one? */
+    bool isComparableBuild(size_t row)  const
+    {
+        return BuildInfo::isComparable(runtime_.profile, runtime_.profile.data[row]);
+    }
+
+    bool isExcluded(size_t row)  const
+    {
+        return isContaminated(row) or not isComparableBuild(row);
+    }
+
+    /** the given time series, segmented to measurements with comparable build profile */
+    vector<double> comparableSeries(vector<double> const& data)  const
+    {
+        vector<double> series;
+        series.reserve(data.size());
+        for (size_t i=0; i < data.size(); ++i)
+            if (isComparableBuild(i))
+                series.push_back(data[i]);
+        return series;
+    }
+
+    /**
+     * Average over the last data points, excluding measurements which were
+     * taken while the system was disturbed by unrelated activities, or
+     * with a build of different profile (e.g. an accidental debug build).
+     * @remark falls back to plain averaging if all points are excluded
+     */
+    double averageUncontaminated(vector<double> const& data, size_t avgPoints)  const
+    {
+        size_t siz = runtime_.size();
+        size_t oldest = siz - std::min(avgPoints, siz);
+        double sum = 0.0;
+        size_t cnt = 0;
+        for (size_t i=siz; oldest < i; --i)
+            if (not isExcluded(i-1))
+            {
+                sum += data[i-1];
+                ++cnt;
+            }
+        return 0 < cnt? sum / cnt
+                      : averageLastN(data, avgPoints);
+    }
+
+    /** determine the amplitude of local fluctuations
+     * @param skipContaminated exclude measurements taken on a disturbed system or
+     *        with a build of different profile; if less than two points remain,
+     *        all points are used. */
+    double calcLocalTolerance(size_t avgPoints, bool skipContaminated =true) const
     {
         size_t siz = runtime_.size();
         assert (siz > 0);
@@ -344,14 +403,19 @@ private:
 
         avgPoints = std::min(avgPoints, siz);
         size_t oldest = siz - avgPoints;
+        size_t points = 0;
         double variance = 0.0;
         for (size_t i=siz; oldest < i; --i)
         {   // use moving average of the /previous/ points as guess for "the actual" value
+            if (skipContaminated and isExcluded(i-1)) continue;
             double avgVal = i>1? runtime_.maTime.data[i-2] : runtime_.maTime.data[i-1];
             double delta = runtime_.runtime.data[i-1] - avgVal;
             variance += delta*delta;
+            ++points;
         }
-        variance /= avgPoints > 1? avgPoints-1 : 1;
+        if (skipContaminated and points < 2 and points < avgPoints)
+            return calcLocalTolerance(avgPoints, false);
+        variance /= points > 1? points-1 : 1;
         // divide by N-1 since it's a guess for the real variance
         return 3 * sqrt(variance);
     }
@@ -366,12 +430,20 @@ private:
 TimingObservation::~TimingObservation() { }
 
 
-TimingObservation::TimingObservation(OutputObservation& output
+TimingObservation::TimingObservation(TimingSource& output
+                                    ,SystemWatch& systemWatch
                                     ,suite::PTimings aggregator
-                                    ,PathSetup& pathSetup)
+                                    ,PathSetup& pathSetup
+                                    ,fs::path subject
+                                    ,string engine
+                                    ,string metric)
     : pathSpec_{pathSetup}
     , testData{output}
+    , systemWatch_{systemWatch}
     , globalTimings_{aggregator}
+    , subject_{subject}
+    , engine_{engine}
+    , metric_{metric}
     , data_{}
 { }
 
@@ -382,16 +454,26 @@ void TimingObservation::calculateDataRecord()
     double runtime = testData.getRuntime();
     uint   notes   = testData.getNotesCnt();
     size_t smps    = testData.getSamples();
+    double contamination = systemWatch_.conclude();
 
     double prediction = globalTimings_->evalPlatformModel(notes,smps);
 
-    FileNameSpec& fileRuntime = pathSpec_[def::KEY_fileRuntime];
-    FileNameSpec& fileExpense = pathSpec_[def::KEY_fileExpense];
+    fs::path fileRuntime = pathSpec_.forDimension(def::KEY_fileRuntime, metric_);
+    fs::path fileExpense = pathSpec_.forDimension(def::KEY_fileExpense, metric_);
+    string testID = pathSpec_.getTestcaseID() + (isnil(metric_)? "" : "-"+metric_);
 
-    data_.reset(new TimingTestData(pathSpec_.getTestcaseID()
-                                  ,fileRuntime,fileExpense));
+    data_.reset(new TimingTestData(testID
+                                  ,pathSpec_.getTopic(), engine_
+                                  ,isnil(metric_)   // metrics of a benchmark are not part of the platform model
+                                  ,fileRuntime,fileExpense
+                                  ,globalTimings_->contaminationLimit));
     data_->calculatePoint(notes,smps,runtime,prediction
-                         ,globalTimings_->baselineAvg);
+                         ,globalTimings_->baselineAvg
+                         ,contamination
+                         ,subjectBuild());
+    if (not data_->hasBaseline())
+        data_->calcProvisional(globalTimings_->predictExpense(*data_, prediction / MILLISEC_per_NANOSEC)
+                              ,globalTimings_->baselineAvg);
 
     globalTimings_->attach(*data_);
 }
@@ -423,6 +505,24 @@ array<double,4> TimingObservation::getTestResults() const
     return data_->getExpenseDeltaTolerance();
 }
 
+/** @return system disturbance score observed during the current measurement */
+double TimingObservation::getContamination() const
+{
+    return data_->getContamination();
+}
+
+/** @return test case path within the Testsuite, including the metric (if any) */
+string TimingObservation::getCaseID() const
+{
+    return (data_->topic.parent_path() / data_->testID).string();
+}
+
+/** @return provisional baseline estimate, when this case has no expense baseline yet */
+std::optional<TimingObservation::Provisional> TimingObservation::getProvisional() const
+{
+    return data_->getProvisional();
+}
+
 /** linear regression over n delta values into the past
  * @return (socket,gradient,correlation) */
 array<double,3> TimingObservation::calcDeltaTrend(uint n) const
@@ -30,6 +30,26 @@
  ** can be used to define a _tolerance corridor_ -- values outside this bandwidth of
  ** "usual fluctuation" may set off an alarm, especially when observing a _trend_
  ** indicating a move away from this established regular behaviour.
+ **
+ ** # Contamination
+ ** The SystemWatch samples the system state while the test is running; measurements
+ ** taken on a disturbed system are still recorded, but marked with their contamination
+ ** score and excluded from averages, tolerance band and platform model fit.
+ **
+ ** # Build identity
+ ** Each measurement also records build-id and build profile of the subject (see BuildInfo.hpp);
+ ** averages, tolerance band and trends are segmented to measurements with comparable profile.
+ **
+ ** # Metrics
+ ** A benchmark (`Test.type=BENCH`) may report several metrics from a single invocation; each
+ ** is observed as a time series of its own, stored as `<TestID>-<metric>-runtime.csv`. These
+ ** are scaled by the platform model, yet do not contribute to the platform model fit.
+ **
+ ** # Provisional baseline
+ ** A new test case without expense baseline is judged against a _provisional_ expense factor
+ ** and tolerance, predicted from similar test cases (see ExpensePredictor.hpp). With each
+ ** further run, this prediction is blended with the statistics of the own measurements,
+ ** until enough data points are available to rely on these alone.
  ** 
  ** @todo WIP as of 9/21
  ** @see Invocation.hpp
@@ -48,11 +68,13 @@
 #include "suite/TestStep.hpp"
 #include "suite/step/PathSetup.hpp"
 #include "suite/step/OutputObservation.hpp"
+#include "suite/step/SystemWatch.hpp"
 #include "suite/Timings.hpp"
 #include "Config.hpp"
 
 #include <array>
 #include <memory>
+#include <optional>
 //#include <string>
 #include <iostream>////////////////TODO remove this
 using std::cerr;
@@ -77,8 +99,12 @@ class TimingObservation
     : public TestStep
 {
     PathSetup& pathSpec_;
-    OutputObservation& testData;
+    TimingSource& testData;
+    SystemWatch& systemWatch_;
     suite::PTimings globalTimings_;
+    fs::path subject_;
+    string engine_;
+    string metric_;
 
     PData data_;
 
@@ -95,9 +121,13 @@ class TimingObservation
 
 public:
    ~TimingObservation();
-    TimingObservation(OutputObservation& output
+    TimingObservation(TimingSource& output
+                     ,SystemWatch& systemWatch
                      ,suite::PTimings aggregator
-                     ,PathSetup& pathSetup);
+                     ,PathSetup& pathSetup
+                     ,fs::path subject
+                     ,string engine
+                     ,string metric ="");
 
 
     operator bool()  const
@@ -111,6 +141,21 @@ public:
     array<uint,2> getIntegrationTimespan() const;
     array<double,4> getTestResults()       const;
     array<double,3> calcDeltaTrend(uint n) const;
+    double getContamination()              const;
+    string getCaseID()                     const;
+
+    /** build of the subject executable used by this test case */
+    BuildInfo const& subjectBuild()  const { return globalTimings_->subjectBuild(subject_); }
+
+    /** estimated baseline for a test case without expense baseline yet */
+    struct Provisional
+    {
+        double expense;     ///< expense factor predicted and blended with own measurements
+        double delta;       ///< current runtime against this estimate (ms)
+        double tolerance;   ///< estimated tolerance band (ms)
+        string basis;       ///< what this estimate is based on
+    };
+    std::optional<Provisional> getProvisional() const;
 
 private:
     void calculateDataRecord();
@@ -0,0 +1,101 @@
+/*
+ *  TimingQuarantine - exclude unstable timing tests from suite statistics
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file TimingQuarantine.hpp
+ ** Keep test cases with unstable runtime out of the global timing statistics.
+ ** Some timed cases fluctuate inherently much more than others; by error propagation
+ ** their tolerance band would dominate the tolerance of the suite average, and their
+ ** scatter would distort the platform model fit. Such cases are excluded automatically
+ ** from the suite aggregate, the platform model and the cluster analysis, while their
+ ** own TimingJudgement remains unaffected. The list of excluded cases is shown in the
+ ** summary of the report.
+ **
+ ** @see Timings::updateQuarantine()
+ ** @see TrendObservation.hpp
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_TIMING_QUARANTINE_HPP_
+#define TESTRUNNER_SUITE_STEP_TIMING_QUARANTINE_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/utils.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Progress.hpp"
+#include "suite/Timings.hpp"
+
+#include <string>
+#include <vector>
+
+namespace suite{
+namespace step {
+
+using std::string;
+
+
+/**
+ * Step to update the quarantine of unstable timing test cases.
+ * @remark must be performed prior to any global timing statistics.
+ */
+class TimingQuarantine
+    : public TestStep
+{
+    Progress& progressLog_;
+    suite::PTimings timings_;
+
+
+    static string join(std::vector<string> const& cases)
+    {
+        string list;
+        for (string const& entry : cases)
+            list += (util::isnil(list)? "":", ") + entry;
+        return list;
+    }
+
+    Result perform()  override
+    {
+        if (0 == timings_->dataCnt())
+            return Result::OK();
+
+        auto quarantine = timings_->updateQuarantine();
+        if (not quarantine.entered.empty())
+            progressLog_.note("Quarantine: unstable, excluded from suite statistics: "+join(quarantine.entered));
+        if (not quarantine.released.empty())
+            progressLog_.note("Quarantine: stabilised, included again: "+join(quarantine.released));
+        if (quarantine.current.empty())
+            return Result::OK();
+        return Result::Note("Unstable timings, excluded from suite statistics: "+join(quarantine.current));
+    }
+
+
+public:
+    TimingQuarantine(Progress& log
+                    ,suite::PTimings globalTimings)
+        : progressLog_{log}
+        , timings_{globalTimings}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_TIMING_QUARANTINE_HPP_*/
@@ -107,6 +107,10 @@ class TrendJudgement
         double overallTolerance = util::errorSum(tolerance,modelTolerance);
         if (tolerance == 0.0 or modelTolerance == 0.0)
             return Result::Warn("Missing calibration. Unable to watch global trend.");
+        if (timings_->isProfileMismatch())
+            return Result::Warn("Subject build "+timings_->subjectBuild().describe()
+                               +" does not match the build profile used for calibration ("
+                               +timings_->calibrationProfile()+"). Global trend not assessed.");
 
         // check the averaged delta of all tests against the tolerance band...
         if (currDelta < -overallTolerance)
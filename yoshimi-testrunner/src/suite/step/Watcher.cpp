@@ -41,6 +41,7 @@
 #include "suite/Result.hpp"
 #include "suite/step/Watcher.hpp"
 #include "util/filehandle.hpp"
+#include "util/utils.hpp"
 #include "util/format.hpp"
 #include "util/error.hpp"
 
@@ -49,6 +50,7 @@
 #include <spawn.h>
 #include <errno.h>
 #include <wait.h>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -73,7 +75,7 @@ namespace suite{
 namespace step {
 
 
-SubProcHandle launchSubprocess(fs::path executable, VectorS argSeq)
+SubProcHandle launchSubprocess(fs::path executable, VectorS argSeq, VectorS envSettings)
 {
     enum PipeEnd{ READ=0, WRITE };
 
@@ -123,8 +125,20 @@ SubProcHandle launchSubprocess(fs::path executable, VectorS argSeq)
     arguments.push_back(nullptr);                       // execve() requires a NULL terminated array
     auto args = const_cast<char* const*>(arguments.data());
 
-    // pass Environment of the test-runner unaltered into child process
-    char* const * environment = environ;
+    // pass Environment of the test-runner into child process, possibly with additional settings
+    vector<const char*> envEntries;
+    for (char* const* entry = environ; *entry; ++entry)
+    {
+        string var{*entry};
+        string key = var.substr(0, var.find('=')+1);
+        if (std::none_of(envSettings.begin(), envSettings.end()
+                        ,[&](string const& setting){ return util::startsWith(setting, key); }))
+            envEntries.push_back(*entry);
+    }
+    for (auto& setting : envSettings)
+        envEntries.push_back(setting.c_str());
+    envEntries.push_back(nullptr);
+    auto environment = const_cast<char* const*>(envEntries.data());
 
     // Spawn the child process...
     res = posix_spawnp (&childHandle.pid, executable.c_str(), &actions_after_fork, &childAttribs, args, environment);
@@ -82,11 +82,13 @@ using VectorS = std::vector<std::string>;
  * @arg executable a complete path to the executable to launch
  * @arg arguments a vector with the actual arguments to pass;
  *      the 0th argument (=filename) will be injected automatically.
+ * @arg environment additional settings `KEY=value`, overriding the
+ *      corresponding variables inherited from the testrunner.
  * @remark the implementation is based on [posix_spawn()]
  *
  * [posix_spawn()]: https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn.html
  */
-SubProcHandle launchSubprocess(fs::path executable, VectorS arguments);
+SubProcHandle launchSubprocess(fs::path executable, VectorS arguments, VectorS environment ={});
 
 
 
@@ -110,6 +112,7 @@ public:
    ~Watcher();
 
     void kill();
+    int pid()  const { return child_.pid; }
     std::future<int> retrieveExitCode();
     void send2child(string);
     void TODO_forceQuit();
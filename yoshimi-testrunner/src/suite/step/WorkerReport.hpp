@@ -0,0 +1,81 @@
+/*
+ *  WorkerReport - test step to collect the findings of a remote test case
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file WorkerReport.hpp
+ ** Final step of a test case performed by a worker process on behalf of the coordinator.
+ ** The findings to send back are picked up from the other steps of this very test case;
+ ** notably the sound probe is located through the case's own PathSetup, since several
+ ** workers may share the same Testsuite tree and thus write into the same directories.
+ ** The system load is observed here on the worker, where the subject actually runs;
+ ** the resulting contamination score is passed on to the coordinator's SystemWatch.
+ **
+ ** @see Worker.cpp
+ ** @see suite::Dispatcher
+ **
+ */
+
+
+#ifndef TESTRUNNER_SUITE_STEP_WORKER_REPORT_HPP_
+#define TESTRUNNER_SUITE_STEP_WORKER_REPORT_HPP_
+
+
+#include "Config.hpp"
+#include "suite/TestStep.hpp"
+#include "suite/Dispatcher.hpp"
+#include "suite/step/PathSetup.hpp"
+#include "suite/step/SystemWatch.hpp"
+
+namespace suite{
+namespace step {
+
+
+/**
+ * Pass the findings of the test case to the worker,
+ * for sending them back to the coordinator.
+ */
+class WorkerReport
+    : public TestStep
+{
+    PathSetup& pathSetup_;
+    MaybeRef<SystemWatch> systemWatch_;
+    PWorkerFindings findings_;
+
+
+    Result perform()  override
+    {
+        findings_->probe = fs::absolute(string(pathSetup_[def::KEY_fileProbe]));
+        if (systemWatch_)
+            findings_->contamination = systemWatch_->conclude();
+        return Result::OK();
+    }
+
+public:
+    WorkerReport(PathSetup& pathSetup
+                ,MaybeRef<SystemWatch> systemWatch
+                ,PWorkerFindings findings)
+        : pathSetup_{pathSetup}
+        , systemWatch_{systemWatch}
+        , findings_{findings}
+    { }
+};
+
+
+}}//(End)namespace suite::step
+#endif /*TESTRUNNER_SUITE_STEP_WORKER_REPORT_HPP_*/
@@ -190,10 +190,12 @@ class DataFile
     , util::NonCopyable
 {
     fs::path filename_;
+    size_t storedCols_;
 
 public:
     DataFile(fs::path csvFile)
         : filename_{consolidated(csvFile)}
+        , storedCols_{columnCnt}
     {
         loadData();
     }
@@ -343,17 +345,27 @@ private: /* === Implementation === */
     }
 
 
+    /** @remark CSV files written by a previous version may lack some trailing
+     *          columns added later; these are filled with default values. */
     void verifyHeaderSpec(string headerLine)
     {
         CsvLine header(headerLine);
+        storedCols_ = 0;
+        bool exhausted = false;
         forEach(TAB::allColumns(),
                 [&](auto& col)
                 {
+                    if (exhausted or (0 < storedCols_ and not header))
+                    {
+                        exhausted = true;
+                        return;
+                    }
                     if (*header != col.header)
                         throw error::Invalid("Header mismatch in CSV file "+formatVal(filename_)
                                             +". Expecting column("+formatVal(col.header)
                                             +") but found "+formatVal(*header));
                     ++header;
+                    ++storedCols_;
                 });
     }
 
@@ -373,9 +385,12 @@ private: /* === Implementation === */
     {
         newRow();
         CsvLine csv(line);
+        size_t colIdx = 0;
         forEach(TAB::allColumns(),
                 [&](auto& col)
                 {
+                    if (storedCols_ <= colIdx++)
+                        return; // column not present in stored data
                     if (!csv)
                         if (csv.isParseFail())
                             csv.fail();
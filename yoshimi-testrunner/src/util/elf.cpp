@@ -0,0 +1,445 @@
+/*
+ *  elf - extract build identity information from executables
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file elf.cpp
+ ** Implementation of ELF section table parsing, based on the definitions from `<elf.h>`.
+ ** Both 32bit and 64bit ELF files are supported, yet only in the native byte order.
+ ** The file is read section by section; only the small sections and the DWARF string
+ ** table are actually loaded, the latter being scanned for compiler producer strings.
+ ** Shared libraries are resolved breadth first, each library searched only once.
+ ** For symbol lookup, the whole symbol table is loaded and sorted by address.
+ **
+ */
+
+
+#include "util/elf.hpp"
+#include "util/utils.hpp"
+
+#include <elf.h>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <regex>
+#include <set>
+
+using std::vector;
+using std::regex;
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const size_t MAX_SECTION_LOAD = 256*1024*1024;
+
+    /** unified view on the section header, independent of ELF class */
+    struct Section
+    {
+        string name;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t type{0};
+        uint32_t link{0};    ///< index of the associated section, e.g. the string table
+        size_t   index{0};   ///< position in the section header table
+    };
+
+    const regex OPT_FLAG{R"~((?:^|\s)-O(fast|[0-3sgz]?)(?=\s|$))~"};
+
+    const fs::path LD_SO_CONF{"/etc/ld.so.conf"};
+    const fs::path DEFAULT_LIB_DIRS[] = {"/lib64", "/usr/lib64", "/lib", "/usr/lib"};
+
+
+    template<class EHDR, class SHDR>
+    vector<Section> readSectionTable(std::ifstream& file)
+    {
+        EHDR header;
+        file.seekg(0);
+        if (not file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            or header.e_shentsize != sizeof(SHDR) or header.e_shnum == 0
+            or header.e_shstrndx >= header.e_shnum)
+            return {};
+
+        vector<SHDR> raw(header.e_shnum);
+        file.seekg(header.e_shoff);
+        if (not file.read(reinterpret_cast<char*>(raw.data()), std::streamsize(raw.size()*sizeof(SHDR))))
+            return {};
+
+        SHDR const& strTab = raw[header.e_shstrndx];
+        string names(strTab.sh_size, '\0');
+        file.seekg(strTab.sh_offset);
+        if (not file.read(names.data(), std::streamsize(names.size())))
+            return {};
+
+        vector<Section> sections;
+        for (size_t i=0; i < raw.size(); ++i)
+        {
+            SHDR const& sh = raw[i];
+            if (sh.sh_name < names.size() and sh.sh_type != SHT_NOBITS)
+                sections.push_back(Section{string{names.c_str() + sh.sh_name}, sh.sh_offset, sh.sh_size
+                                          ,sh.sh_type, sh.sh_link, i});
+        }
+        return sections;
+    }
+
+    /** @return offset, virtual address and size of each loadable segment */
+    template<class EHDR, class PHDR, class SEG>
+    vector<SEG> readLoadSegments(std::ifstream& file)
+    {
+        EHDR header;
+        file.seekg(0);
+        if (not file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            or header.e_phentsize != sizeof(PHDR) or header.e_phnum == 0)
+            return {};
+
+        vector<PHDR> raw(header.e_phnum);
+        file.seekg(header.e_phoff);
+        if (not file.read(reinterpret_cast<char*>(raw.data()), std::streamsize(raw.size()*sizeof(PHDR))))
+            return {};
+
+        vector<SEG> segments;
+        for (PHDR const& ph : raw)
+            if (ph.p_type == PT_LOAD)
+                segments.push_back(SEG{ph.p_offset, ph.p_vaddr, ph.p_filesz});
+        return segments;
+    }
+
+    /** @return (address, size, name) of the defined functions within a symbol table */
+    template<class SYM, class SYMBOL>
+    vector<SYMBOL> decodeFunctions(string const& symTab, string const& strTab)
+    {
+        vector<SYMBOL> functions;
+        for (size_t pos=0; pos+sizeof(SYM) <= symTab.size(); pos += sizeof(SYM))
+        {
+            SYM sym;
+            memcpy(&sym, symTab.data()+pos, sizeof(SYM));
+            uint type = sym.st_info & 0xf;
+            if ((type == STT_FUNC or type == STT_GNU_IFUNC)
+                and sym.st_shndx != SHN_UNDEF and sym.st_value != 0
+                and sym.st_name < strTab.size())
+                functions.push_back(SYMBOL{sym.st_value, sym.st_size, string{strTab.c_str() + sym.st_name}});
+        }
+        return functions;
+    }
+
+    string loadSection(std::ifstream& file, Section const& sec)
+    {
+        if (sec.size > MAX_SECTION_LOAD) return "";
+        string content(sec.size, '\0');
+        file.seekg(sec.offset);
+        if (not file.read(content.data(), std::streamsize(content.size())))
+            return "";
+        return content;
+    }
+
+    /** decode the GNU build-id note: namesz, descsz, type, name, desc */
+    string decodeBuildID(string const& note)
+    {
+        if (note.size() < 12) return "";
+        uint32_t nameSz, descSz;
+        memcpy(&nameSz, note.data(), 4);
+        memcpy(&descSz, note.data()+4, 4);
+        size_t descPos = 12 + ((nameSz + 3) & ~3u);
+        if (descPos + descSz > note.size()) return "";
+
+        static const char* HEX = "0123456789abcdef";
+        string hex;
+        for (size_t i=descPos; i < descPos+descSz; ++i)
+        {
+            hex += HEX[uint8_t(note[i]) >> 4];
+            hex += HEX[uint8_t(note[i]) & 0xF];
+        }
+        return hex;
+    }
+
+    /** @return last -O option within the given compiler command line */
+    string findOptLevel(string const& cmdline)
+    {
+        string level;
+        for (auto it = std::sregex_iterator(cmdline.begin(), cmdline.end(), OPT_FLAG);
+             it != std::sregex_iterator(); ++it)
+        {
+            string mark = (*it)[1];
+            level = "O" + (isnil(mark)? string{"1"} : mark);
+        }
+        return level;
+    }
+
+    /** dependencies from the dynamic section */
+    struct DynamicInfo
+    {
+        vector<string> needed;
+        vector<string> searchPath;   ///< from DT_RPATH and DT_RUNPATH
+    };
+
+    template<class DYN>
+    DynamicInfo decodeDynamic(string const& dynamic, string const& strTab)
+    {
+        DynamicInfo info;
+        auto str = [&](uint64_t pos){ return pos < strTab.size()? string{strTab.c_str()+pos} : string{}; };
+        for (size_t pos=0; pos+sizeof(DYN) <= dynamic.size(); pos += sizeof(DYN))
+        {
+            DYN entry;
+            memcpy(&entry, dynamic.data()+pos, sizeof(DYN));
+            if (entry.d_tag == DT_NULL)
+                break;
+            if (entry.d_tag == DT_NEEDED)
+                info.needed.push_back(str(entry.d_un.d_val));
+            else
+            if (entry.d_tag == DT_RPATH or entry.d_tag == DT_RUNPATH)
+            {
+                std::istringstream dirs{str(entry.d_un.d_val)};
+                for (string dir; std::getline(dirs, dir, ':'); )
+                    info.searchPath.push_back(dir);
+            }
+        }
+        return info;
+    }
+
+    DynamicInfo readDynamicInfo(fs::path file)
+    {
+        std::ifstream in{file, std::ios::binary};
+        unsigned char ident[EI_NIDENT];
+        if (not in.read(reinterpret_cast<char*>(ident), EI_NIDENT)
+            or 0 != memcmp(ident, ELFMAG, SELFMAG))
+            return {};
+        bool is64 = ident[EI_CLASS] == ELFCLASS64;
+        vector<Section> sections = is64? readSectionTable<Elf64_Ehdr,Elf64_Shdr>(in)
+                                       : readSectionTable<Elf32_Ehdr,Elf32_Shdr>(in);
+        string dynamic, strTab;
+        for (Section const& sec : sections)
+            if (sec.name == ".dynamic")
+                dynamic = loadSection(in, sec);
+            else
+            if (sec.name == ".dynstr")
+                strTab = loadSection(in, sec);
+        return is64? decodeDynamic<Elf64_Dyn>(dynamic, strTab)
+                   : decodeDynamic<Elf32_Dyn>(dynamic, strTab);
+    }
+
+    /** directories from `ld.so.conf`, following `include` lines with a simple `*` wildcard */
+    void readLdConf(fs::path conf, vector<fs::path>& dirs, uint depth =0)
+    {
+        std::ifstream in{conf};
+        for (string line; std::getline(in, line); )
+        {
+            line = trimmed(line.substr(0, line.find('#')));
+            if (isnil(line)) continue;
+            if (not startsWith(line, "include"))
+            {
+                dirs.push_back(line);
+                continue;
+            }
+            if (depth > 3) continue;
+            fs::path pattern = trimmed(line.substr(7));
+            if (pattern.is_relative())
+                pattern = conf.parent_path() / pattern;
+            string name = pattern.filename();
+            size_t star = name.find('*');
+            if (star == string::npos)
+            {
+                readLdConf(pattern, dirs, depth+1);
+                continue;
+            }
+            std::set<fs::path> matches;   // glob(3) yields sorted results
+            std::error_code noThrow;
+            for (auto& entry : fs::directory_iterator(pattern.parent_path(), noThrow))
+            {
+                string candidate = entry.path().filename();
+                if (startsWith(candidate, name.substr(0,star)) and endsWith(candidate, name.substr(star+1)))
+                    matches.insert(entry.path());
+            }
+            for (auto& match : matches)
+                readLdConf(match, dirs, depth+1);
+        }
+    }
+
+    vector<fs::path> librarySearchPath()
+    {
+        vector<fs::path> dirs;
+        if (const char* envPath = std::getenv("LD_LIBRARY_PATH"))
+        {
+            std::istringstream envDirs{envPath};
+            for (string dir; std::getline(envDirs, dir, ':'); )
+                if (not isnil(dir))
+                    dirs.push_back(dir);
+        }
+        readLdConf(LD_SO_CONF, dirs);
+        for (auto& dir : DEFAULT_LIB_DIRS)
+            dirs.push_back(dir);
+        return dirs;
+    }
+}//(End)helpers
+
+
+
+vector<fs::path> sharedLibraries(fs::path executable)
+{
+    static const vector<fs::path> systemPath = librarySearchPath();
+    vector<fs::path> libraries;
+    std::set<string> seen;
+    std::deque<fs::path> pending{executable};
+    while (not pending.empty())
+    {
+        fs::path file = pending.front();
+        pending.pop_front();
+        DynamicInfo dyn = readDynamicInfo(file);
+        vector<fs::path> searchPath;
+        for (string dir : dyn.searchPath)
+        {
+            for (size_t pos; string::npos != (pos = dir.find("$ORIGIN")); )
+                dir.replace(pos, 7, file.parent_path().string());
+            searchPath.push_back(dir);
+        }
+        searchPath.insert(searchPath.end(), systemPath.begin(), systemPath.end());
+
+        for (string const& lib : dyn.needed)
+        {
+            if (not seen.insert(lib).second) continue;
+            std::error_code noThrow;
+            for (fs::path const& dir : searchPath)
+                if (fs::is_regular_file(dir / lib, noThrow))
+                {
+                    libraries.push_back(fs::canonical(dir / lib, noThrow));
+                    pending.push_back(dir / lib);
+                    break;
+                }
+        }
+    }
+    return libraries;
+}
+
+
+
+ElfSymbols::ElfSymbols(fs::path file)
+{
+    std::ifstream in{file, std::ios::binary};
+    unsigned char ident[EI_NIDENT];
+    if (not in.read(reinterpret_cast<char*>(ident), EI_NIDENT)
+        or 0 != memcmp(ident, ELFMAG, SELFMAG))
+        return;
+    bool is64 = ident[EI_CLASS] == ELFCLASS64;
+    vector<Section> sections = is64? readSectionTable<Elf64_Ehdr,Elf64_Shdr>(in)
+                                   : readSectionTable<Elf32_Ehdr,Elf32_Shdr>(in);
+    segments_ = is64? readLoadSegments<Elf64_Ehdr,Elf64_Phdr,Segment>(in)
+                    : readLoadSegments<Elf32_Ehdr,Elf32_Phdr,Segment>(in);
+
+    auto findType = [&](uint32_t type) -> Section const*
+                        {
+                            for (Section const& sec : sections)
+                                if (sec.type == type) return &sec;
+                            return nullptr;
+                        };
+    Section const* symTab = findType(SHT_SYMTAB);
+    if (not symTab)
+        symTab = findType(SHT_DYNSYM);
+    if (not symTab) return;
+    for (Section const& strTab : sections)
+        if (strTab.index == symTab->link)
+        {
+            string syms = loadSection(in, *symTab);
+            string strs = loadSection(in, strTab);
+            symbols_ = is64? decodeFunctions<Elf64_Sym,Symbol>(syms, strs)
+                           : decodeFunctions<Elf32_Sym,Symbol>(syms, strs);
+        }
+    std::sort(symbols_.begin(), symbols_.end()
+             ,[](Symbol const& s1, Symbol const& s2){ return s1.addr < s2.addr; });
+}
+
+
+/** @remark a symbol without size is assumed to extend up to the next symbol */
+string ElfSymbols::lookup(uint64_t fileOffset)  const
+{
+    auto seg = std::find_if(segments_.begin(), segments_.end()
+                           ,[&](Segment const& s){ return s.offset <= fileOffset and fileOffset < s.offset+s.size; });
+    if (seg == segments_.end())
+        return "";
+    uint64_t addr = fileOffset - seg->offset + seg->vaddr;
+    auto pos = std::upper_bound(symbols_.begin(), symbols_.end(), addr
+                               ,[](uint64_t a, Symbol const& sym){ return a < sym.addr; });
+    if (pos == symbols_.begin())
+        return "";
+    --pos;
+    if (pos->size != 0 and pos->addr + pos->size <= addr)
+        return "";
+    return pos->name;
+}
+
+
+
+ElfInfo readElfInfo(fs::path executable)
+{
+    ElfInfo info;
+    std::ifstream file{executable, std::ios::binary};
+    unsigned char ident[EI_NIDENT];
+    if (not file.read(reinterpret_cast<char*>(ident), EI_NIDENT)
+        or 0 != memcmp(ident, ELFMAG, SELFMAG))
+        return info;
+
+    vector<Section> sections = ident[EI_CLASS] == ELFCLASS64? readSectionTable<Elf64_Ehdr,Elf64_Shdr>(file)
+                                                            : readSectionTable<Elf32_Ehdr,Elf32_Shdr>(file);
+    info.isELF = true;
+    string cmdlines, debugStrings;
+    for (Section const& sec : sections)
+        if (sec.name == ".note.gnu.build-id")
+            info.buildID = decodeBuildID(loadSection(file, sec));
+        else
+        if (sec.name == ".comment")
+        {
+            string comment = loadSection(file, sec);
+            info.compiler = string{comment.c_str()}; // first NUL terminated entry
+        }
+        else
+        if (sec.name == ".GCC.command.line")
+            cmdlines = loadSection(file, sec);
+        else
+        if (startsWith(sec.name, ".debug_"))
+        {
+            info.debugInfo = true;
+            if (sec.name == ".debug_str")
+                debugStrings = loadSection(file, sec);
+        }
+
+    std::replace(cmdlines.begin(), cmdlines.end(), '\0', ' ');
+    info.optLevel = findOptLevel(cmdlines);
+    if (isnil(info.optLevel))
+    {   // look for a DWARF producer, e.g. "GNU C++17 12.2.0 -mtune=generic -g -O2"
+        size_t pos = 0;
+        while (pos < debugStrings.size())
+        {
+            string entry{debugStrings.c_str() + pos};
+            pos += entry.size() + 1;
+            if (startsWith(entry, "GNU C") and contains(entry, " -"))
+            {
+                info.optLevel = findOptLevel(entry);
+                if (isnil(info.optLevel))
+                    info.optLevel = "O0";   // GCC default without any -O
+                break;
+            }
+        }
+    }
+    return info;
+}
+
+
+}//(End)namespace util
@@ -0,0 +1,113 @@
+/*
+ *  elf - extract build identity information from executables
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+/** @file elf.hpp
+ ** Read identifying information from an ELF executable, without external tools.
+ ** Timing measurements depend heavily on how the subject was built; a debug build
+ ** can be several times slower than an optimised release build. To attribute the
+ ** measurements, we inspect the section table of the executable file:
+ ** - `.note.gnu.build-id` holds a hash uniquely identifying this build
+ ** - `.comment` records the compiler(s) used, e.g. `GCC: (Debian 12.2.0-14) 12.2.0`
+ ** - `.GCC.command.line` (with `-frecord-gcc-switches`) and the DWARF producer strings
+ **   in `.debug_str` (when compiled with `-g`) reveal the optimisation options
+ ** - the presence of `.debug_*` sections indicates debug information
+ ** Any of these may be missing; the corresponding fields then remain empty.
+ ** Moreover, the shared libraries needed by the executable can be located by following
+ ** the `DT_NEEDED` entries of the `.dynamic` section, similar to the dynamic linker,
+ ** and code addresses can be attributed to functions with the symbol tables.
+ **
+ ** @see suite::BuildInfo
+ **
+ */
+
+
+#ifndef TESTRUNNER_UTIL_ELF_HPP_
+#define TESTRUNNER_UTIL_ELF_HPP_
+
+
+#include "util/file.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+
+using std::string;
+
+
+/** information extracted from the ELF sections */
+struct ElfInfo
+{
+    bool   isELF{false};
+    string buildID;      ///< hex encoded GNU build-id
+    string compiler;     ///< first entry from the `.comment` section
+    string optLevel;     ///< last `-O` option found, e.g. "O2"; "O0" if compiled without; empty if unknown
+    bool   debugInfo{false};
+};
+
+
+/** @return whatever can be found within the given file; never throws on malformed content */
+ElfInfo readElfInfo(fs::path executable);
+
+/**
+ * Locate the shared libraries loaded with the given executable, including indirect dependencies.
+ * @remark searches `DT_RPATH` / `DT_RUNPATH`, `LD_LIBRARY_PATH`, the directories configured in
+ *         `/etc/ld.so.conf` and the system default directories, yet does not read `ld.so.cache`;
+ *         libraries not found this way are omitted.
+ */
+std::vector<fs::path> sharedLibraries(fs::path executable);
+
+
+/**
+ * Function symbols of an ELF file, to attribute code addresses sampled in a running process.
+ * Uses `.symtab` if present, else the exported symbols from `.dynsym`; names are not demangled.
+ * @remark addresses are given as offset into the file, as seen in `/proc/<pid>/maps`,
+ *         and translated into virtual addresses through the `PT_LOAD` segments.
+ */
+class ElfSymbols
+{
+    struct Symbol
+    {
+        uint64_t addr;
+        uint64_t size;
+        string name;
+    };
+    struct Segment
+    {
+        uint64_t offset;
+        uint64_t vaddr;
+        uint64_t size;
+    };
+
+    std::vector<Symbol> symbols_;    ///< sorted by address
+    std::vector<Segment> segments_;
+
+public:
+    explicit ElfSymbols(fs::path file);
+
+    /** @return name of the function containing the given file offset, empty if unknown */
+    string lookup(uint64_t fileOffset)  const;
+
+    bool empty()  const { return symbols_.empty(); }
+};
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_ELF_HPP_*/
@@ -96,6 +96,15 @@ public:
 };
 
 
+class Rejected : public State
+{
+public:
+    Rejected(string msg)
+        : State{"Subject rejected the test -- "+msg}
+    { }
+};
+
+
 class ToDo : public logic_error
 {
 public:
@@ -34,6 +34,7 @@
 
 #include <string>
 #include <sstream>
+#include <cmath>
 
 using std::string;
 
@@ -78,6 +79,13 @@ inline string formatVal(float f)
    return oss.str();
 }
 
+/** @return relative value as signed percentage with one decimal */
+inline string formatPercent(double relVal)
+{
+    double percent = std::round(relVal * 1000) / 10;
+    return (0 <= percent? "+":"") + formatVal(percent) + "%";
+}
+
 
 /** parse string representation into typed value */
 template<typename TAR>
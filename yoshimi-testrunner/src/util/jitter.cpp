@@ -0,0 +1,161 @@
+/*
+ *  jitter - probe the current timing jitter of the execution platform
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file jitter.cpp
+ ** Implementation of the platform jitter probe.
+ **
+ ** \par Jitter score
+ ** The scheduling latency is related to the sleep period, and the compute spread is
+ ** already relative; both are combined by error propagation (√Σx²). Timer resolution is
+ ** reported for information, but usually far below the other effects. The compute kernel
+ ** is a dependent chain of floating point operations, roughly resembling sound synthesis,
+ ** which can not be optimised away, since the result is accumulated into a volatile sink.
+ **
+ */
+
+
+#include "util/jitter.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/statistic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+using std::vector;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::chrono::microseconds;
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const uint SLEEP_ROUNDS   = 300;
+    const double SLEEP_QUANTILE = 0.9;   // robust against single outliers, which a high percentile would just pick up
+    const auto SLEEP_PERIOD   = microseconds(1000);
+    const uint KERNEL_ROUNDS  = 50;
+    const uint KERNEL_SIZE    = 200000;  // ~1-2ms on current hardware
+    const uint TIMER_ROUNDS   = 1000;
+
+    volatile double sink;
+
+    double elapsed_us(steady_clock::time_point start, steady_clock::time_point end)
+    {
+        return duration<double, std::micro>(end - start).count();
+    }
+
+    double percentile(vector<double> values, double p)
+    {
+        std::sort(values.begin(), values.end());
+        size_t idx = std::min(values.size()-1, size_t(p * values.size()));
+        return values[idx];
+    }
+
+    double probeSchedLatency()
+    {
+        vector<double> overshoot;
+        overshoot.reserve(SLEEP_ROUNDS);
+        for (uint i=0; i<SLEEP_ROUNDS; ++i)
+        {
+            auto start = steady_clock::now();
+            std::this_thread::sleep_for(SLEEP_PERIOD);
+            double slept = elapsed_us(start, steady_clock::now());
+            overshoot.push_back(std::max(0.0, slept - double(SLEEP_PERIOD.count())));
+        }
+        return percentile(overshoot, SLEEP_QUANTILE);
+    }
+
+    double probeTimerResolution()
+    {
+        double minStep = std::numeric_limits<double>::max();
+        auto prev = steady_clock::now();
+        for (uint i=0; i<TIMER_ROUNDS; ++i)
+        {
+            auto now = steady_clock::now();
+            while (now == prev)
+                now = steady_clock::now();
+            minStep = std::min(minStep, elapsed_us(prev, now));
+            prev = now;
+        }
+        return minStep;
+    }
+
+    double computeKernel()
+    {
+        double phase = 0.0, acc = 0.0;
+        for (uint i=0; i<KERNEL_SIZE; ++i)
+        {
+            phase += 0.001 + 1e-9*acc;
+            acc   += std::sin(phase) * 0.5;
+        }
+        return acc;
+    }
+
+    double probeComputeSpread()
+    {
+        sink = computeKernel(); // warm-up
+        VecD runtimes;
+        runtimes.reserve(KERNEL_ROUNDS);
+        for (uint i=0; i<KERNEL_ROUNDS; ++i)
+        {
+            auto start = steady_clock::now();
+            sink = computeKernel();
+            runtimes.push_back(elapsed_us(start, steady_clock::now()));
+        }
+        double avg = averageLastN(runtimes, runtimes.size());
+        return 0.0 < avg? sdev(runtimes, avg) / avg : 0.0;
+    }
+}//(End)helpers
+
+
+
+Jitter probePlatformJitter()
+{
+    Jitter jitter;
+    jitter.timerRes      = probeTimerResolution();
+    jitter.schedLatency  = probeSchedLatency();
+    jitter.computeSpread = probeComputeSpread();
+    return jitter;
+}
+
+
+double Jitter::score()  const
+{
+    return errorSum(schedLatency / double(SLEEP_PERIOD.count())
+                   ,computeSpread);
+}
+
+
+string Jitter::describe()  const
+{
+    return "sched="+formatVal(schedLatency)+"µs"
+         +" timer="+formatVal(timerRes)+"µs"
+         +" compute±"+formatVal(100*computeSpread)+"%"
+         +" ⟹ jitter="+formatVal(score());
+}
+
+
+}//(End)namespace util
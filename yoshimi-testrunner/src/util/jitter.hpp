@@ -0,0 +1,71 @@
+/*
+ *  jitter - probe the current timing jitter of the execution platform
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file jitter.hpp
+ ** Short calibration probe to estimate how noisy the execution platform is right now.
+ ** The SystemWatch detects _known_ disturbances, yet timing measurements also fluctuate
+ ** due to effects not visible in any kernel statistics (virtualisation, SMT siblings,
+ ** cache sharing, power management). Thus, at the start of the Testsuite, a probe is
+ ** run for a fraction of a second, exercising the platform directly:
+ ** - scheduling latency: overshoot when sleeping for a fixed period (à la `cyclictest`)
+ ** - timer resolution: smallest observable step of the monotonic clock
+ ** - compute jitter: relative spread when repeating a fixed compute kernel
+ ** These are combined into a dimensionless _jitter score_, which is recorded with
+ ** the platform calibration and the suite statistics; comparing the current score
+ ** with the score seen during calibration allows to scale timing tolerances.
+ **
+ ** @see suite::step::JitterProbe
+ ** @see suite::Timings::jitterFactor()
+ **
+ */
+
+
+
+#ifndef TESTRUNNER_UTIL_JITTER_HPP_
+#define TESTRUNNER_UTIL_JITTER_HPP_
+
+
+#include "util/utils.hpp"
+
+#include <string>
+
+namespace util {
+
+using std::string;
+
+
+/** findings of a jitter probe run */
+struct Jitter
+{
+    double schedLatency{0.0};  ///< scheduling latency (90th percentile overshoot) in µs
+    double timerRes{0.0};      ///< smallest observed step of the monotonic clock in µs
+    double computeSpread{0.0}; ///< relative standard deviation of the compute kernel runtime
+
+    double score()     const;
+    string describe()  const;
+};
+
+
+/** run the probe; takes roughly 1/4 second */
+Jitter probePlatformJitter();
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_JITTER_HPP_*/
@@ -0,0 +1,283 @@
+/*
+ *  profiler - statistical sampling of call chains in a running process
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file profiler.cpp
+ ** Implementation of the sampling profiler, based on `perf_event_open()` with per-thread ring buffers.
+ ** The ring buffer is drained by moving the `data_tail` behind the records consumed; when the buffer
+ ** overflows, the kernel emits a `PERF_RECORD_LOST` instead. Call chains are aggregated as such, and
+ ** only resolved to function names when concluding, using the ELF symbol tables of the mapped files.
+ ** Return addresses within the call chain are looked up one byte before, since the call instruction
+ ** at the end of a function may be followed immediately by the next function.
+ **
+ */
+
+
+#include "util/profiler.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+#include "util/elf.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cxxabi.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const fs::path PROC{"/proc"};
+    const size_t RING_PAGES = 64;   // must be a power of 2
+
+    int openSampler(int tid, uint64_t periodNs)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_TASK_CLOCK;
+        attr.sample_period = periodNs;
+        attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_CALLCHAIN;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.exclude_callchain_kernel = 1;
+        return int(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+    }
+
+    string demangled(string const& name)
+    {
+        int status{-1};
+        char* plain = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+        if (not plain) return name;
+        string result{plain};
+        std::free(plain);
+        return result;
+    }
+}//(End)helpers
+
+
+
+struct SamplingProfiler::Ring
+    : util::NonCopyable
+{
+    int fd;
+    size_t pageSize;
+    size_t size;
+    void* base;
+
+    Ring(int fileDescriptor)
+        : fd{fileDescriptor}
+        , pageSize{size_t(sysconf(_SC_PAGESIZE))}
+        , size{(1 + RING_PAGES) * pageSize}
+        , base{mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0)}
+    { }
+
+   ~Ring()
+    {
+        if (base != MAP_FAILED) munmap(base, size);
+        close(fd);
+    }
+
+    /** copy out of the ring buffer, possibly wrapping around */
+    void copyOut(uint64_t pos, void* dest, size_t len)
+    {
+        char* data = static_cast<char*>(base) + pageSize;
+        size_t dataSize = size - pageSize;
+        size_t start = pos % dataSize;
+        size_t first = std::min(len, dataSize - start);
+        memcpy(dest, data + start, first);
+        memcpy(static_cast<char*>(dest) + first, data, len - first);
+    }
+};
+
+
+
+SamplingProfiler::~SamplingProfiler() { }
+
+SamplingProfiler::SamplingProfiler(int pid, uint64_t periodNs)
+    : pid_{pid}
+    , periodNs_{periodNs}
+{
+    sample();
+}
+
+
+void SamplingProfiler::sample()
+{
+    std::error_code noThrow;
+    for (auto& entry : fs::directory_iterator(PROC / formatVal(pid_) / "task", noThrow))
+    {
+        int tid = std::atoi(entry.path().filename().c_str());
+        if (not permitted_ or rings_.count(tid)) continue;
+        int fd = openSampler(tid, periodNs_);
+        if (fd < 0)
+        {
+            permitted_ = not (errno == EACCES or errno == EPERM);
+            rings_[tid] = nullptr;   // don't retry: thread gone or not permitted
+            continue;
+        }
+        rings_[tid].reset(new Ring{fd});
+        if (rings_[tid]->base == MAP_FAILED)
+            rings_[tid].reset();
+    }
+    readMappings();
+    for (auto& [tid,ring] : rings_)
+        if (ring)
+            drain(*ring);
+}
+
+
+/** @remark the mappings are merged, since libraries may be unloaded or the process be gone */
+void SamplingProfiler::readMappings()
+{
+    std::ifstream maps{PROC / formatVal(pid_) / "maps"};
+    for (string line; std::getline(maps, line); )
+    {
+        std::istringstream fields{line};
+        string range, perms, offset, device, inode, file;
+        if (not (fields >> range >> perms >> offset >> device >> inode >> file)
+            or perms.size() < 3 or perms[2] != 'x' or file[0] != '/')
+            continue;
+        size_t dash = range.find('-');
+        uint64_t start = std::stoull(range.substr(0,dash), nullptr, 16);
+        uint64_t end   = std::stoull(range.substr(dash+1), nullptr, 16);
+        mappings_[start] = Mapping{end, std::stoull(offset, nullptr, 16), file};
+    }
+}
+
+
+void SamplingProfiler::drain(Ring& ring)
+{
+    auto* meta = static_cast<perf_event_mmap_page*>(ring.base);
+    uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = meta->data_tail;
+    std::vector<char> record;
+    while (tail + sizeof(perf_event_header) <= head)
+    {
+        perf_event_header header;
+        ring.copyOut(tail, &header, sizeof(header));
+        if (header.size < sizeof(header) or head < tail + header.size)
+            break;
+        record.resize(header.size);
+        ring.copyOut(tail, record.data(), header.size);
+        tail += header.size;
+
+        if (header.type == PERF_RECORD_LOST and header.size >= sizeof(header) + 16)
+        {// u64 id, u64 lost
+            uint64_t lost;
+            memcpy(&lost, record.data() + sizeof(header) + 8, 8);
+            lost_ += lost;
+        }
+        if (header.type != PERF_RECORD_SAMPLE or header.size < sizeof(header) + 24)
+            continue;
+        // u64 ip, u32 pid, u32 tid, u64 nr, u64 ips[nr]
+        size_t pos = sizeof(header);
+        uint64_t ip, nr;
+        memcpy(&ip, record.data() + pos, 8);
+        memcpy(&nr, record.data() + pos + 16, 8);
+        pos += 24;
+        Chain chain;
+        for (uint64_t i=0; i < nr and pos + 8 <= record.size(); ++i, pos += 8)
+        {
+            uint64_t addr;
+            memcpy(&addr, record.data() + pos, 8);
+            if (addr < PERF_CONTEXT_MAX)   // skip context markers
+                chain.push_back(addr);
+        }
+        if (chain.empty())
+            chain.push_back(ip);
+        ++chains_[chain];
+        ++samples_;
+    }
+    __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+
+
+Profile SamplingProfiler::conclude()
+{
+    sample();
+    rings_.clear();
+
+    std::map<fs::path, std::unique_ptr<ElfSymbols>> symbolTables;
+    std::map<uint64_t, string> resolved;
+    auto resolve = [&](uint64_t addr) -> string const&
+                        {
+                            auto [pos,isNew] = resolved.try_emplace(addr);
+                            if (not isNew) return pos->second;
+                            auto mapping = mappings_.upper_bound(addr);
+                            if (mapping == mappings_.begin() or addr >= (--mapping)->second.end)
+                                return pos->second = "[unknown]";
+                            Mapping const& map = mapping->second;
+                            auto& symbols = symbolTables[map.file];
+                            if (not symbols)
+                                symbols.reset(new ElfSymbols{map.file});
+                            string name = symbols->lookup(addr - mapping->first + map.offset);
+                            return pos->second = isnil(name)? "["+map.file.filename().string()+"]"
+                                                            : demangled(name);
+                        };
+
+    std::map<string, FunctionCost> functions;
+    for (auto& [chain,cnt] : chains_)
+    {
+        std::set<string> seen;
+        for (size_t i=0; i < chain.size(); ++i)
+        {
+            string const& fun = resolve(0 < i? chain[i]-1 : chain[i]);
+            FunctionCost& cost = functions[fun];
+            if (0 == i)
+                cost.self += cnt;
+            if (seen.insert(fun).second)
+                cost.total += cnt;
+        }
+    }
+
+    Profile profile;
+    profile.samples = samples_;
+    profile.lost = lost_;
+    for (auto& [fun,cost] : functions)
+    {
+        profile.functions.push_back(cost);
+        profile.functions.back().function = fun;
+    }
+    std::sort(profile.functions.begin(), profile.functions.end()
+             ,[](FunctionCost const& c1, FunctionCost const& c2)
+               {
+                   return c1.self > c2.self
+                       or (c1.self == c2.self and c1.total > c2.total);
+               });
+    chains_.clear();
+    samples_ = lost_ = 0;
+    return profile;
+}
+
+
+}//(End)namespace util
@@ -0,0 +1,125 @@
+/*
+ *  profiler - statistical sampling of call chains in a running process
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file profiler.hpp
+ ** Statistical profiling of a subprocess, to find out where the computation time is spent.
+ ** Each thread of the subject is sampled through `perf_event_open()` with the software event
+ ** `PERF_COUNT_SW_TASK_CLOCK`, i.e. after a fixed amount of CPU time consumed by this thread,
+ ** the kernel records the instruction pointer and the user space call chain into a ring
+ ** buffer mapped into our address space. The threads are discovered by polling `/proc`,
+ ** similar to the util::ThreadAudit, and the memory mappings of the subject are retained,
+ ** so that sampled addresses can be attributed to functions after the subject has exited.
+ ** - _self_ samples are attributed to the function containing the instruction pointer
+ ** - _total_ samples count each function found anywhere in the call chain once
+ ** @warning the kernel follows the frame pointers to unwind the call chain; in code compiled
+ **          without `-fno-omit-frame-pointer`, the total counts are thus unreliable, while
+ **          self counts are always accurate. Sampling of user space code is permitted with
+ **          `/proc/sys/kernel/perf_event_paranoid` ≤ 2 for our own subprocesses.
+ **
+ ** @see suite::step::ProfileSampling
+ **
+ */
+
+
+
+#ifndef TESTRUNNER_UTIL_PROFILER_HPP_
+#define TESTRUNNER_UTIL_PROFILER_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace util {
+
+using std::string;
+
+
+/** samples attributed to a single function */
+struct FunctionCost
+{
+    string function;
+    size_t self{0};     ///< samples with the instruction pointer in this function
+    size_t total{0};    ///< samples with this function anywhere in the call chain
+};
+
+/** result of profiling a process */
+struct Profile
+{
+    size_t samples{0};
+    size_t lost{0};                         ///< samples dropped due to ring buffer overflow
+    std::vector<FunctionCost> functions;    ///< sorted by descending self samples
+};
+
+
+/**
+ * Sampling profiler attached to all threads of a running process.
+ * @note #sample must be invoked periodically while the process is running,
+ *       to drain the ring buffers and to discover new threads and mappings.
+ */
+class SamplingProfiler
+    : util::NonCopyable
+{
+    struct Ring;
+    struct Mapping
+    {
+        uint64_t end;
+        uint64_t offset;
+        fs::path file;
+    };
+    using Chain = std::vector<uint64_t>;
+
+    int pid_;
+    uint64_t periodNs_;
+    bool permitted_{true};
+    std::map<int, std::unique_ptr<Ring>> rings_;
+    std::map<uint64_t, Mapping> mappings_;    ///< start address → executable mapping
+    std::map<Chain, size_t> chains_;          ///< distinct call chains (innermost first) → samples
+    size_t samples_{0};
+    size_t lost_{0};
+
+public:
+    SamplingProfiler(int pid, uint64_t periodNs);
+   ~SamplingProfiler();
+
+    /** discover new threads and mappings, and consume the recorded samples */
+    void sample();
+
+    /** stop sampling (also when the process is gone)
+     * @return samples attributed to functions, for all threads seen */
+    Profile conclude();
+
+    /** @return `false` when `perf_event_open()` was denied */
+    bool permitted()  const { return permitted_; }
+
+private:
+    void readMappings();
+    void drain(Ring&);
+};
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_PROFILER_HPP_*/
@@ -0,0 +1,240 @@
+/*
+ *  rtaudit - per-thread counters of real-time hazards in a running process
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file rtaudit.cpp
+ ** Implementation of the thread audit, based on Linux pseudo files and `perf_event_open()`.
+ ** Threads present when the audit starts are counted from that point on, while threads
+ ** discovered later are counted from their creation, since the `/proc` counters start
+ ** at zero for a new thread. Page faults are also counted by perf, if permitted; each
+ ** source is a lower bound (late discovery vs. last sample before exit), and thus the
+ ** larger count is reported. System calls can only be counted through the tracepoint,
+ ** which requires to include kernel events; otherwise they are reported as unknown.
+ **
+ */
+
+
+#include "util/rtaudit.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/file.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+
+using std::max;
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const fs::path PROC{"/proc"};
+    const fs::path TRACEPOINT_SYSCALLS[] = {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id"
+                                           ,"/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"};
+
+    /** @return current counters from `/proc/<pid>/task/<tid>`, or `nullopt` when the thread is gone */
+    std::optional<ThreadCounters> readThread(fs::path taskDir, int tid)
+    {
+        std::ifstream statFile{taskDir / "stat"};
+        string stat;
+        if (not std::getline(statFile, stat))
+            return std::nullopt;
+        size_t endComm = stat.rfind(')');
+        if (endComm == string::npos)
+            return std::nullopt;
+        std::istringstream fields{stat.substr(endComm+1)};
+        std::vector<string> token{std::istream_iterator<string>{fields}, std::istream_iterator<string>{}};
+        if (token.size() < 13)
+            return std::nullopt;
+
+        ThreadCounters cnt;
+        cnt.tid = tid;
+        cnt.minorFaults = std::stol(token[7]);   // field 10 in proc(5)
+        cnt.majorFaults = std::stol(token[9]);   // field 12
+        cnt.cpuTicks    = std::stol(token[11])   // field 14 utime
+                        + std::stol(token[12]);  // field 15 stime
+
+        std::ifstream commFile{taskDir / "comm"};
+        std::getline(commFile, cnt.name);
+
+        std::ifstream status{taskDir / "status"};
+        for (string key; status >> key; )
+            if (key == "voluntary_ctxt_switches:")
+                status >> cnt.volSwitches;
+            else
+            if (key == "nonvoluntary_ctxt_switches:")
+                status >> cnt.involSwitches;
+        return cnt;
+    }
+
+    /** @remark kernel tracepoints never fire under `exclude_kernel`; a tracepoint
+     *          counter is thus not retried with reduced scope, but left unopened,
+     *          rather than silently counting zero events. */
+    int openCounter(uint32_t type, uint64_t config, int tid)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_hv = 1;
+        int fd = int(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+        if (fd < 0 and (errno == EACCES or errno == EPERM) and type != PERF_TYPE_TRACEPOINT)
+        {// retry with reduced scope, which is permitted at perf_event_paranoid=2
+            attr.exclude_kernel = 1;
+            fd = int(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+        }
+        return fd;
+    }
+
+    std::optional<long> readCounter(int fd)
+    {
+        uint64_t cnt{0};
+        if (fd < 0 or sizeof(cnt) != read(fd, &cnt, sizeof(cnt)))
+            return std::nullopt;
+        return long(cnt);
+    }
+
+    /** @return ID of the `raw_syscalls:sys_enter` tracepoint, if accessible */
+    std::optional<uint64_t> syscallTracepoint()
+    {
+        for (auto& idFile : TRACEPOINT_SYSCALLS)
+        {
+            std::ifstream in{idFile};
+            uint64_t id;
+            if (in >> id)
+                return id;
+        }
+        return std::nullopt;
+    }
+}//(End)helpers
+
+
+
+struct ThreadAudit::Probe
+    : util::NonCopyable
+{
+    ThreadCounters start;
+    ThreadCounters last;
+    int fdFaults{-1};
+    int fdSyscalls{-1};
+
+   ~Probe()
+    {
+        if (0 <= fdFaults)   close(fdFaults);
+        if (0 <= fdSyscalls) close(fdSyscalls);
+    }
+};
+
+
+long ThreadCounters::violations()  const
+{
+    return minorFaults + majorFaults + involSwitches + syscalls.value_or(0);
+}
+
+string ThreadCounters::describe()  const
+{
+    return name+"["+formatVal(tid)+"]"
+         + " faults="+formatVal(minorFaults)+"+"+formatVal(majorFaults)
+         + " switches(vol/invol)="+formatVal(volSwitches)+"/"+formatVal(involSwitches)
+         + " syscalls="+(syscalls? formatVal(*syscalls) : string{"?"});
+}
+
+
+
+ThreadAudit::~ThreadAudit() { }
+
+/** @remark threads existing at start are counted from now on */
+ThreadAudit::ThreadAudit(int pid)
+    : pid_{pid}
+{
+    sample();
+    for (auto& [tid,probe] : threads_)
+        probe.start = probe.last;
+}
+
+
+void ThreadAudit::sample()
+{
+    static const auto tracepoint = syscallTracepoint();
+    std::error_code noThrow;
+    for (auto& entry : fs::directory_iterator(PROC / formatVal(pid_) / "task", noThrow))
+    {
+        int tid = std::atoi(entry.path().filename().c_str());
+        auto counters = readThread(entry.path(), tid);
+        if (not counters) continue;
+
+        auto [pos,isNew] = threads_.try_emplace(tid);
+        Probe& probe = pos->second;
+        if (isNew)
+        {
+            probe.start.tid  = tid;
+            probe.start.name = counters->name;
+            if (perfPermitted_)
+            {
+                probe.fdFaults = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, tid);
+                perfPermitted_ = (0 <= probe.fdFaults);
+                if (perfPermitted_ and tracepoint)
+                    probe.fdSyscalls = openCounter(PERF_TYPE_TRACEPOINT, *tracepoint, tid);
+            }
+        }
+        probe.last = *counters;
+    }
+}
+
+
+std::vector<ThreadCounters> ThreadAudit::conclude()
+{
+    sample();
+    std::vector<ThreadCounters> result;
+    for (auto& [tid,probe] : threads_)
+    {
+        ThreadCounters cnt;
+        cnt.tid           = tid;
+        cnt.name          = probe.last.name;
+        cnt.cpuTicks      = probe.last.cpuTicks      - probe.start.cpuTicks;
+        cnt.minorFaults   = probe.last.minorFaults   - probe.start.minorFaults;
+        cnt.majorFaults   = probe.last.majorFaults   - probe.start.majorFaults;
+        cnt.volSwitches   = probe.last.volSwitches   - probe.start.volSwitches;
+        cnt.involSwitches = probe.last.involSwitches - probe.start.involSwitches;
+        if (auto faults = readCounter(probe.fdFaults))
+            cnt.minorFaults = max(cnt.minorFaults, *faults - cnt.majorFaults);
+        cnt.syscalls = readCounter(probe.fdSyscalls);
+        result.push_back(cnt);
+    }
+    threads_.clear();
+    return result;
+}
+
+
+string ThreadAudit::method()  const
+{
+    return perfPermitted_? "perf":"proc";
+}
+
+
+}//(End)namespace util
@@ -0,0 +1,107 @@
+/*
+ *  rtaudit - per-thread counters of real-time hazards in a running process
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file rtaudit.hpp
+ ** Count events in the threads of a subprocess which are hazardous for real-time audio.
+ ** Code running in the audio thread must not touch fresh memory (page faults), must not
+ ** block in the kernel, and should never be preempted; each such event risks an xrun,
+ ** even while the average computation time is fine. The Linux kernel provides counters:
+ ** - `perf_event_open()` software events for page faults, and the `raw_syscalls:sys_enter`
+ **   tracepoint for system calls; both can be bound to a single thread, but may be denied
+ **   depending on `/proc/sys/kernel/perf_event_paranoid` and the capabilities at hand.
+ ** - `/proc/<pid>/task/<tid>/stat` and `status` publish page faults, CPU ticks and the
+ **   voluntary / involuntary context switches per thread, but no syscall counts.
+ ** The ThreadAudit combines both sources: the threads of the subject are discovered by
+ ** sampling `/proc` periodically, and perf counters are attached as far as permitted.
+ ** @remark a thread started between two samples is discovered late; the `/proc` counters
+ **         cover its whole lifetime, while perf counters only count after attaching.
+ **
+ ** @see suite::step::RealtimeAudit
+ **
+ */
+
+
+
+#ifndef TESTRUNNER_UTIL_RTAUDIT_HPP_
+#define TESTRUNNER_UTIL_RTAUDIT_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/utils.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace util {
+
+using std::string;
+
+
+/** hazard counters accumulated for a single thread while audited */
+struct ThreadCounters
+{
+    int tid{0};
+    string name;
+    long cpuTicks{0};        ///< user+system time, clock ticks
+    long minorFaults{0};
+    long majorFaults{0};
+    long volSwitches{0};     ///< voluntary context switches (blocking in the kernel)
+    long involSwitches{0};   ///< involuntary context switches (preemption)
+    std::optional<long> syscalls;
+
+    /** @return sum of all hazardous events (syscalls only if counted) */
+    long violations()  const;
+    string describe()  const;
+};
+
+
+/**
+ * Audit of all threads of a running process.
+ * @note #sample must be invoked periodically while the process is running,
+ *       since counters of exited threads vanish from `/proc`.
+ */
+class ThreadAudit
+    : util::NonCopyable
+{
+    struct Probe;
+
+    int pid_;
+    bool perfPermitted_{true};
+    std::map<int, Probe> threads_;
+
+public:
+    explicit ThreadAudit(int pid);
+   ~ThreadAudit();
+
+    /** discover new threads and update the counters of running threads */
+    void sample();
+
+    /** @return counters accumulated since start of the audit, for each thread seen */
+    std::vector<ThreadCounters> conclude();
+
+    /** @return "perf" when perf counters could be attached, else "proc" */
+    string method()  const;
+};
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_RTAUDIT_HPP_*/
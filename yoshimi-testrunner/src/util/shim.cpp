@@ -0,0 +1,176 @@
+/*
+ *  shim - access the counters reported by the instrumentation preload library
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file shim.cpp
+ ** Implementation of the shared memory segment for the preload library.
+ ** The segment is backed by a file on `/dev/shm` (or the temporary directory), created
+ ** with a unique name and mapped shared; a fresh file is filled with zeros by `ftruncate()`.
+ ** Counters are read with relaxed atomic loads, since the subject may still be running.
+ **
+ */
+
+
+#include "util/shim.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/utils.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+
+
+namespace util {
+
+namespace {
+    const fs::path SHM_DIR{"/dev/shm"};
+    const fs::path SELF_EXE{"/proc/self/exe"};
+
+    uint64_t load(uint64_t const& counter)
+    {
+        return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+    }
+
+    /** @remark several segments may be used concurrently by a worker process */
+    fs::path uniqueSegmentFile()
+    {
+        static std::atomic<uint> cnt{0};
+        std::error_code noThrow;
+        fs::path dir = fs::is_directory(SHM_DIR, noThrow)? SHM_DIR : fs::temp_directory_path();
+        return dir / ("yoshimi-testshim-"+str(getpid())+"-"+str(++cnt));
+    }
+}
+
+
+
+ShimCounters ShimCounters::operator-(ShimCounters const& earlier)  const
+{
+    ShimCounters diff{*this};
+    diff.allocs      -= earlier.allocs;
+    diff.frees       -= earlier.frees;
+    diff.bytes       -= earlier.bytes;
+    diff.lockCalls   -= earlier.lockCalls;
+    diff.contended   -= earlier.contended;
+    diff.lockWait_ns -= earlier.lockWait_ns;
+    diff.cpu_ns      -= earlier.cpu_ns;
+    return diff;
+}
+
+ShimCounters& ShimCounters::operator+=(ShimCounters const& other)
+{
+    allocs      += other.allocs;
+    frees       += other.frees;
+    bytes       += other.bytes;
+    lockCalls   += other.lockCalls;
+    contended   += other.contended;
+    lockWait_ns += other.lockWait_ns;
+    cpu_ns      += other.cpu_ns;
+    return *this;
+}
+
+
+
+ShimSegment::ShimSegment()
+    : file_{uniqueSegmentFile()}
+{
+    int fd = open(file_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+        throw error::State("unable to create shared memory segment "+formatVal(file_));
+    void* mem = MAP_FAILED;
+    if (0 == ftruncate(fd, sizeof(shim::Segment)))
+        mem = mmap(nullptr, sizeof(shim::Segment), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        fs::remove(file_);
+        throw error::State("unable to map shared memory segment "+formatVal(file_));
+    }
+    segment_ = static_cast<shim::Segment*>(mem);
+    segment_->version = shim::SHIM_VERSION;
+    __atomic_store_n(&segment_->magic, shim::SHIM_MAGIC, __ATOMIC_RELEASE);
+}
+
+
+ShimSegment::~ShimSegment()
+{
+    munmap(segment_, sizeof(shim::Segment));
+    std::error_code noThrow;
+    fs::remove(file_, noThrow);
+}
+
+
+fs::path ShimSegment::locateLibrary()
+{
+    std::error_code noThrow;
+    fs::path lib = fs::read_symlink(SELF_EXE, noThrow).parent_path() / shim::SHIM_LIBRARY;
+    if (not fs::is_regular_file(lib, noThrow))
+        throw error::Misconfig("Preload library "+formatVal(lib)+" not found; "
+                               "it is built together with the testrunner.");
+    return lib;
+}
+
+
+/** @remark an existing `LD_PRELOAD` of the testrunner is retained */
+std::vector<string> ShimSegment::environment()  const
+{
+    string preload = locateLibrary();
+    if (const char* existing = std::getenv("LD_PRELOAD"))
+        if (not isnil(string{existing}))
+            preload += ":"+string{existing};
+    return {"LD_PRELOAD="+preload
+           ,string{shim::SHIM_SEGMENT_ENV}+"="+file_.string()};
+}
+
+
+bool ShimSegment::isAttached()  const
+{
+    return 0 != __atomic_load_n(&segment_->pid, __ATOMIC_ACQUIRE);
+}
+
+
+std::vector<ShimCounters> ShimSegment::snapshot()  const
+{
+    uint32_t used = std::min(__atomic_load_n(&segment_->threads, __ATOMIC_ACQUIRE), shim::MAX_THREADS);
+    std::vector<ShimCounters> threads;
+    for (uint32_t i=0; i < used; ++i)
+    {
+        shim::ThreadSlot const& slot = segment_->slot[i];
+        ShimCounters cnt;
+        cnt.tid         = __atomic_load_n(&slot.tid, __ATOMIC_RELAXED);
+        cnt.name        = string{slot.name, strnlen(slot.name, sizeof(slot.name))};
+        cnt.allocs      = load(slot.allocs);
+        cnt.frees       = load(slot.frees);
+        cnt.bytes       = load(slot.bytes);
+        cnt.lockCalls   = load(slot.lockCalls);
+        cnt.contended   = load(slot.contended);
+        cnt.lockWait_ns = load(slot.lockWait_ns);
+        cnt.cpu_ns      = load(slot.cpu_ns);
+        threads.push_back(cnt);
+    }
+    return threads;
+}
+
+
+}//(End)namespace util
@@ -0,0 +1,100 @@
+/*
+ *  shim - access the counters reported by the instrumentation preload library
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file shim.hpp
+ ** Setup and evaluation of the instrumentation through the preload library `libtestshim.so`.
+ ** The library is built along with the testrunner and expected in the same directory as the
+ ** testrunner executable. For each instrumented launch, a new ShimSegment is created; the
+ ** environment settings to hand over to the subject are provided by #environment.
+ **
+ ** @see shimlayout.hpp
+ ** @see suite::step::PreloadShim
+ **
+ */
+
+
+#ifndef TESTRUNNER_UTIL_SHIM_HPP_
+#define TESTRUNNER_UTIL_SHIM_HPP_
+
+
+#include "util/nocopy.hpp"
+#include "util/file.hpp"
+#include "util/shimlayout.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+
+using std::string;
+
+
+/** counters reported for a single thread of the subject */
+struct ShimCounters
+{
+    int tid{0};
+    string name;
+    uint64_t allocs{0};
+    uint64_t frees{0};
+    uint64_t bytes{0};
+    uint64_t lockCalls{0};
+    uint64_t contended{0};
+    uint64_t lockWait_ns{0};
+    uint64_t cpu_ns{0};      ///< known only after the thread ended or the subject exited
+
+    /** @return the increase since an earlier snapshot of the same thread */
+    ShimCounters operator-(ShimCounters const& earlier)  const;
+    ShimCounters& operator+=(ShimCounters const& other);
+};
+
+
+/**
+ * Shared memory segment to receive the counters from the preload library.
+ * The backing file is removed when the segment is discarded.
+ */
+class ShimSegment
+    : util::NonCopyable
+{
+    fs::path file_;
+    shim::Segment* segment_{nullptr};
+
+public:
+    ShimSegment();
+   ~ShimSegment();
+
+    /** @return `LD_PRELOAD` and the segment location, as `KEY=value` */
+    std::vector<string> environment()  const;
+
+    /** @return whether the subject has attached to this segment */
+    bool isAttached()  const;
+
+    /** @return current counters of all threads seen so far */
+    std::vector<ShimCounters> snapshot()  const;
+
+    /** @return location of the preload library, next to the testrunner executable
+     *  @throw error::Misconfig when missing */
+    static fs::path locateLibrary();
+};
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_SHIM_HPP_*/
@@ -0,0 +1,81 @@
+/*
+ *  shimlayout - shared memory layout of the instrumentation preload library
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+
+/** @file shimlayout.hpp
+ ** Layout of the shared memory segment, through which the preload library reports its counters.
+ ** The testrunner creates a file of this size (on `/dev/shm` where available) and passes its path
+ ** to the subject within the environment variable #SHIM_SEGMENT_ENV, together with `LD_PRELOAD`.
+ ** The library `libtestshim.so` maps this file when loaded, and each thread of the subject claims
+ ** a slot on its first allocation or lock, where it increments the counters with relaxed atomic
+ ** operations. The testrunner can thus read consistent counters at any time, even while the
+ ** subject is running, and even after a crash. Only the CPU time of each thread is published
+ ** late, when the thread ends or the subject exits regularly; it serves to pick out the
+ ** rendering thread.
+ ** @note this header is shared with the preload library, and thus must not depend on anything
+ **       beyond the fixed size integral types.
+ **
+ ** @see preload/testshim.cpp
+ ** @see util::ShimSegment
+ **
+ */
+
+
+#ifndef TESTRUNNER_UTIL_SHIMLAYOUT_HPP_
+#define TESTRUNNER_UTIL_SHIMLAYOUT_HPP_
+
+
+#include <cstdint>
+
+namespace shim {
+
+    const char* const SHIM_SEGMENT_ENV = "YOSHIMI_TESTSHIM";
+    const char* const SHIM_LIBRARY     = "libtestshim.so";
+
+    const uint32_t SHIM_MAGIC   = 0x5973484D;   // "YsHM"
+    const uint32_t SHIM_VERSION = 2;
+    const uint32_t MAX_THREADS  = 128;          // further threads share the last slot
+
+
+    /** counters of a single thread, written only through atomic increments */
+    struct ThreadSlot
+    {
+        int32_t  tid;
+        char     name[16];        ///< as set by `pthread_setname_np()`, refreshed now and then
+        uint64_t allocs;          ///< calls to malloc, calloc, realloc, memalign and operator new
+        uint64_t frees;           ///< calls to free and operator delete (not with NULL)
+        uint64_t bytes;           ///< sum of requested allocation sizes
+        uint64_t lockCalls;       ///< calls to pthread_mutex_lock
+        uint64_t contended;       ///< ...where the mutex was not immediately available
+        uint64_t lockWait_ns;     ///< time spent waiting for contended locks
+        uint64_t cpu_ns;          ///< CPU time consumed by the thread, set at thread end or exit
+    };
+
+    struct Segment
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t  pid;             ///< process which attached first; children do not report
+        uint32_t threads;         ///< number of slots claimed (may exceed MAX_THREADS)
+        ThreadSlot slot[MAX_THREADS];
+    };
+
+}//(End)namespace shim
+#endif /*TESTRUNNER_UTIL_SHIMLAYOUT_HPP_*/
@@ -0,0 +1,287 @@
+/*
+ *  socket - line oriented communication over stream sockets
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file socket.cpp
+ ** Implementation of socket communication based on the POSIX socket API.
+ ** Timeouts are implemented with `poll()`; writing uses `MSG_NOSIGNAL`
+ ** to get an error code instead of `SIGPIPE` when the peer vanished.
+ **
+ */
+
+
+#include "util/socket.hpp"
+#include "util/error.hpp"
+#include "util/utils.hpp"
+#include "util/format.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <cstring>
+
+using util::formatVal;
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const string UNIX_PREFIX{"unix:"};
+    const size_t READ_CHUNK = 4096;
+
+    string errorMsg()
+    {
+        return string{strerror(errno)};
+    }
+
+    bool isUnixAddress(string const& address)
+    {
+        return startsWith(address, UNIX_PREFIX);
+    }
+
+    sockaddr_un unixSockAddr(string const& address)
+    {
+        string path = address.substr(UNIX_PREFIX.length());
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (isnil(path) or path.length() >= sizeof(addr.sun_path))
+            throw error::Misconfig("Invalid Unix socket path "+formatVal(path));
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+        return addr;
+    }
+
+    /** resolve `host:port` into a list of candidate addresses */
+    addrinfo* resolveTCP(string const& address, bool passive)
+    {
+        size_t sep = address.rfind(':');
+        if (sep == string::npos)
+            throw error::Misconfig("Socket address "+formatVal(address)
+                                  +" neither 'unix:<path>' nor '<host>:<port>'");
+        string host = address.substr(0,sep);
+        string port = address.substr(sep+1);
+
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive? AI_PASSIVE : 0;
+        addrinfo* result{nullptr};
+        int err = getaddrinfo(isnil(host)? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (err)
+            throw error::Misconfig("Unable to resolve "+formatVal(address)+": "+gai_strerror(err));
+        return result;
+    }
+
+    /** @return `true` when ready, `false` on timeout */
+    bool awaitReadable(int fd, int timeout_ms)
+    {
+        pollfd pfd{fd, POLLIN, 0};
+        int res;
+        do res = poll(&pfd, 1, timeout_ms);
+        while (res < 0 and errno == EINTR);
+        if (res < 0)
+            throw error::State("poll() on socket failed: "+errorMsg());
+        return 0 < res;
+    }
+}//(End)helpers
+
+
+
+Connection::Connection(int fd)
+    : fd_{fd}
+    , buffer_{}
+    , sendLock_{}
+{ }
+
+Connection::~Connection()
+{
+    if (0 <= fd_)
+        close(fd_);
+}
+
+
+PConnection Connection::connectTo(string address)
+{
+    if (isUnixAddress(address))
+    {
+        sockaddr_un addr = unixSockAddr(address);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            throw error::State("Unable to create socket: "+errorMsg());
+        if (0 != connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+        {
+            string msg = errorMsg();
+            close(fd);
+            throw error::State("Unable to connect to "+formatVal(address)+": "+msg);
+        }
+        return PConnection{new Connection{fd}};
+    }
+    addrinfo* candidates = resolveTCP(address, false);
+    for (addrinfo* ai = candidates; ai; ai = ai->ai_next)
+    {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (0 == connect(fd, ai->ai_addr, ai->ai_addrlen))
+        {
+            freeaddrinfo(candidates);
+            return PConnection{new Connection{fd}};
+        }
+        close(fd);
+    }
+    freeaddrinfo(candidates);
+    throw error::State("Unable to connect to "+formatVal(address));
+}
+
+
+void Connection::sendLine(string const& line)
+{
+    sendBlock(line, "");
+}
+
+/** send a header line, followed by a block of raw data */
+void Connection::sendBlock(string const& header, string const& data)
+{
+    string payload = header + "\n" + data;
+    std::lock_guard<std::mutex> guard{sendLock_};
+    size_t sent = 0;
+    while (sent < payload.size())
+    {
+        ssize_t res = send(fd_, payload.data()+sent, payload.size()-sent, MSG_NOSIGNAL);
+        if (res < 0 and errno == EINTR) continue;
+        if (res <= 0)
+            throw error::State("Connection lost while sending: "+errorMsg());
+        sent += size_t(res);
+    }
+}
+
+
+OptString Connection::readLine(int timeout_ms)
+{
+    size_t nl;
+    while ((nl = buffer_.find('\n')) == string::npos)
+    {
+        if (not awaitReadable(fd_, timeout_ms))
+            return std::nullopt;
+        char chunk[READ_CHUNK];
+        ssize_t res = recv(fd_, chunk, READ_CHUNK, 0);
+        if (res < 0 and errno == EINTR) continue;
+        if (res < 0)
+            throw error::State("Connection failure: "+errorMsg());
+        if (res == 0)
+            throw error::State("Connection closed by peer");
+        buffer_.append(chunk, size_t(res));
+    }
+    string line = buffer_.substr(0, nl);
+    buffer_.erase(0, nl+1);
+    return line;
+}
+
+
+string Connection::readBytes(size_t cnt, int timeout_ms)
+{
+    while (buffer_.size() < cnt)
+    {
+        if (not awaitReadable(fd_, timeout_ms))
+            throw error::State("Timeout while receiving data block");
+        char chunk[READ_CHUNK];
+        ssize_t res = recv(fd_, chunk, READ_CHUNK, 0);
+        if (res < 0 and errno == EINTR) continue;
+        if (res <= 0)
+            throw error::State("Connection lost while receiving data block");
+        buffer_.append(chunk, size_t(res));
+    }
+    string data = buffer_.substr(0, cnt);
+    buffer_.erase(0, cnt);
+    return data;
+}
+
+
+void Connection::shutdown()
+{
+    ::shutdown(fd_, SHUT_RDWR);
+}
+
+
+
+
+Listener::Listener(string address)
+    : fd_{-1}
+    , unixPath_{}
+{
+    if (isUnixAddress(address))
+    {
+        sockaddr_un addr = unixSockAddr(address);
+        unixPath_ = addr.sun_path;
+        unlink(addr.sun_path); // remove stale socket from previous run
+        fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ < 0 or 0 != bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+            throw error::State("Unable to bind socket "+formatVal(address)+": "+errorMsg());
+    }
+    else
+    {
+        addrinfo* candidates = resolveTCP(address, true);
+        for (addrinfo* ai = candidates; ai and fd_ < 0; ai = ai->ai_next)
+        {
+            int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            int yes = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            if (0 == bind(fd, ai->ai_addr, ai->ai_addrlen))
+                fd_ = fd;
+            else
+                close(fd);
+        }
+        freeaddrinfo(candidates);
+        if (fd_ < 0)
+            throw error::State("Unable to bind socket "+formatVal(address));
+    }
+    if (0 != listen(fd_, SOMAXCONN))
+        throw error::State("Unable to listen on "+formatVal(address)+": "+errorMsg());
+}
+
+Listener::~Listener()
+{
+    if (0 <= fd_)
+        close(fd_);
+    if (not isnil(unixPath_))
+        unlink(unixPath_.c_str());
+}
+
+
+PConnection Listener::accept(int timeout_ms)
+{
+    if (not awaitReadable(fd_, timeout_ms))
+        return nullptr;
+    int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd < 0)
+    {
+        if (errno == EINTR or errno == ECONNABORTED)
+            return nullptr;
+        throw error::State("accept() failed: "+errorMsg());
+    }
+    return PConnection{new Connection{fd}};
+}
+
+
+}//(End)namespace util
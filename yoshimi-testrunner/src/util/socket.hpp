@@ -0,0 +1,107 @@
+/*
+ *  socket - line oriented communication over stream sockets
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file socket.hpp
+ ** Minimal wrapper for POSIX stream sockets, to exchange text lines and data blocks.
+ ** The Testsuite can be distributed onto several worker processes, which connect
+ ** to a coordinator; the protocol used for this purpose is line based plain text,
+ ** allowing also to embed a block of binary data with known size.
+ **
+ ** \par Address syntax
+ ** - `unix:<path>` denotes a Unix domain socket in the file system
+ ** - `<host>:<port>` denotes a TCP socket; an empty host listens on all interfaces
+ **
+ ** @see suite::Dispatcher
+ ** @see Worker.hpp
+ **
+ */
+
+
+
+#ifndef TESTRUNNER_UTIL_SOCKET_HPP_
+#define TESTRUNNER_UTIL_SOCKET_HPP_
+
+
+#include "util/nocopy.hpp"
+
+#include <optional>
+#include <memory>
+#include <string>
+#include <mutex>
+
+namespace util {
+
+using std::string;
+using OptString = std::optional<string>;
+
+class Connection;
+using PConnection = std::unique_ptr<Connection>;
+
+
+/**
+ * An open bidirectional stream connection.
+ * Sending is thread-safe, while reading is expected
+ * to happen from a single thread.
+ * @throws error::State when the peer closed the connection or on I/O failure
+ */
+class Connection
+    : util::NonCopyable
+{
+    int fd_;
+    string buffer_;
+    std::mutex sendLock_;
+
+public:
+    explicit Connection(int fd);
+   ~Connection();
+
+    static PConnection connectTo(string address);
+
+    void sendLine(string const& line);
+    void sendBlock(string const& header, string const& data);
+
+    /** @return next line (without newline), or `nullopt` on timeout */
+    OptString readLine(int timeout_ms);
+    string readBytes(size_t cnt, int timeout_ms);
+
+    void shutdown();
+};
+
+
+/**
+ * Passive socket to accept incoming connections.
+ */
+class Listener
+    : util::NonCopyable
+{
+    int fd_;
+    string unixPath_;
+
+public:
+    explicit Listener(string address);
+   ~Listener();
+
+    /** @return new connection, or `nullptr` on timeout */
+    PConnection accept(int timeout_ms);
+};
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_SOCKET_HPP_*/
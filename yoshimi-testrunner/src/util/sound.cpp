@@ -27,7 +27,8 @@
  ** TestInvoker in Yoshimi is dumped into a RAW soundfile, with stereo channels
  ** interleaved. To read this probe data, we also need to know the sample rate
  ** configured when launching Yoshimi. Any sound files generated for persistent
- ** storage however are written in WAV format (RIFF, little endian with floats).
+ ** storage however are written in WAV format (RIFF, little endian with floats),
+ ** switching to RF64 when the data would exceed the 4GiB limit of RIFF.
  **
  ** \par Measurements
  ** The comparison to the _baseline waveform_ is done by subtraction; a successful
@@ -42,8 +43,19 @@
  ** meaning that for each data point we add a new value and we drop out a value at
  ** the end of the window, thereby combining data from both stereo channels. Numeric
  ** stability can be an issue for such accumulating calculations -- yet the precision
- ** of doubles is sufficient; summing one hour of sound at 96kHz yields numbers ~10^9,
- ** and 1 + 10^9 can easily be represented as exact double value.
+ ** of doubles is sufficient; summing ten hours of sound at 96kHz yields numbers ~10^10,
+ ** and 1 + 10^10 can easily be represented as exact double value.
+ **
+ ** \par Streaming
+ ** Sound files are processed in blocks of #BLOCK_FRAMES, and the squared values within
+ ** the RMS window are retained in a ring buffer, so that memory usage does not depend
+ ** on the length of the sound. Frame counts are handled as 64bit `sf_count_t` throughout.
+ **
+ ** \par Fingerprint
+ ** The spectral envelope is the power spectrum averaged over consecutive (non overlapping)
+ ** windows of #FFT_SIZE frames of the mono sum, and then condensed into bands on a logarithmic
+ ** frequency scale. Together with the RMS profile over a fixed number of segments, it serves
+ ** to detect test cases with the same sound characteristics, irrespective of the volume.
  **
  */
 
@@ -55,6 +67,9 @@
 #include <sndfile.hh>
 #include <algorithm>
 #include <cassert>
+#include <complex>
+#include <limits>
+#include <cstdio>
 #include <utility>
 #include <vector>
 #include <cmath>
@@ -71,22 +86,37 @@ using std::max;
 using std::min;
 
 using SampleVec = std::vector<float>;
+using Frames = sf_count_t;
 
 
 
 struct SoundStat       ///< @internal raw aggregation results
 {
-    uint   rate;
-    size_t frames;
-    float  peak;
-    double rmsAll;     ///< @note: actually squares (σ²)
-    double rmsMax;
+    uint     rate;
+    uint64_t frames;
+    float    peak;
+    double   rmsAll;   ///< @note: actually squares (σ²)
+    double   rmsMax;
 };
 
 namespace { // Implementation details
 
     const double RMS_WINDOW_sec = double{30}/1000;
+    const double ONSET_LEVEL    = 0.03;  // -30dB relative to the peak following the note-on
+    const double ONSET_ABOVE_TAIL = 2.0; // +6dB above the residual tail of a preceding note
+    const size_t TAIL_FRAMES    = 64;
+    const size_t FFT_SIZE        = 2048;
+    const size_t FINGERPRINT_BANDS = 24;
+    const size_t FINGERPRINT_SEGMENTS = 32;
+    const double FINGERPRINT_FREQ_MIN = 40;     // Hz
+    const double FINGERPRINT_FREQ_MAX = 16000;  // Hz
+    const double FINGERPRINT_FLOOR = -90;       // dB below the loudest band / segment
+    const double FINGERPRINT_DURATION_TOLERANCE = 0.05;
     const uint CHANNELS = 2; // Yoshimi TestInvoker always generates Stereo sound
+    const Frames BLOCK_FRAMES = Frames{1} << 16;  // 512kiB of stereo float samples
+
+    // RIFF size fields are 32bit; leave ample room for header and PEAK chunks
+    const uint64_t WAV_DATA_LIMIT = (uint64_t{1} << 32) - (uint64_t{1} << 20);
 
     inline int validate(uint sampleRate)
     {
@@ -96,6 +126,16 @@ namespace { // Implementation details
             throw error::State("Possibly invalid sample rate "+str(sampleRate));
     }
 
+    inline int sndfileFormat(SoundContainer container)
+    {
+        switch (container)
+        {
+            case SoundContainer::RF64: return SF_FORMAT_RF64 | SF_FORMAT_FLOAT;
+            case SoundContainer::W64:  return SF_FORMAT_W64  | SF_FORMAT_FLOAT;
+            default:                   return SF_FORMAT_WAV  | SF_FORMAT_FLOAT;
+        }
+    }
+
 
     /** construct a libSndfile Handle for reading a RAW file */
     SndfileHandle openSndfileRead(fs::path rawSound, uint sampleRate)
@@ -118,35 +158,37 @@ namespace { // Implementation details
     }
 
 
-    /** construct a libSndfile Handle for reading a WAV file */
-    SndfileHandle openSndfileRead(fs::path wavFile)
+    /** construct a libSndfile Handle for reading a WAV, RF64 or W64 file
+     * @remark the actual container is detected by libSndfile from the header */
+    SndfileHandle openSndfileRead(fs::path soundFile)
     {
-        if (not hasExtWAV(wavFile))
-            throw error::LogicBroken("Expecting a WAV soundfile.");
-        if (not fs::exists(wavFile))
-            throw error::LogicBroken("Could not find expected WAV soundfile \""+wavFile.string()+"\"");
+        if (not hasExtSound(soundFile))
+            throw error::LogicBroken("Expecting a WAV, RF64 or W64 soundfile.");
+        if (not fs::exists(soundFile))
+            throw error::LogicBroken("Could not find expected soundfile \""+soundFile.string()+"\"");
 
-        auto sndFormat = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
-        SndfileHandle sndFile{wavFile, SFM_READ, sndFormat};
+        SndfileHandle sndFile{soundFile, SFM_READ};
         if (not sndFile)
-            throw error::State("Buffer allocation error while opening \""+wavFile.filename().string()+"\"");
+            throw error::State("Buffer allocation error while opening \""+soundFile.filename().string()+"\"");
         if (sndFile.error())
-            throw error::State("Failed to open \""+wavFile.filename().string()+"\" for reading: '"
+            throw error::State("Failed to open \""+soundFile.filename().string()+"\" for reading: '"
                               +sndFile.strError()+"'.");
         if (0 == sndFile.frames())
-            throw error::State("Empty soundfile \""+wavFile.filename().string()+"\"");
+            throw error::State("Empty soundfile \""+soundFile.filename().string()+"\"");
+        if (sndFile.channels() != int(CHANNELS))
+            throw error::State("Expecting stereo sound in \""+soundFile.filename().string()+"\", got "
+                              +formatVal(sndFile.channels())+" channels.");
         return sndFile;
     }
 
 
-    /** construct a libSndfile Handle for writing a WAV file */
-    SndfileHandle openSndfileWrite(fs::path target, uint sampleRate)
+    /** construct a libSndfile Handle for writing a WAV file, or a larger container if necessary */
+    SndfileHandle openSndfileWrite(fs::path target, uint sampleRate, SoundContainer container)
     {
-        if (not hasExtWAV(target))
-            throw error::LogicBroken("Expecting WAV file extension for writing \""+string{target}+"\".");
+        if (not hasExtSound(target))
+            throw error::LogicBroken("Expecting sound file extension .wav, .rf64 or .w64 for writing \""+string{target}+"\".");
 
-        auto sndFormat = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
-        SndfileHandle sndFile{target, SFM_WRITE, sndFormat, CHANNELS, validate(sampleRate)};
+        SndfileHandle sndFile{target, SFM_WRITE, sndfileFormat(container), CHANNELS, validate(sampleRate)};
         if (not sndFile)
             throw error::State("Buffer allocation error while creating \""+target.filename().string()+"\"");
         if (sndFile.error())
@@ -156,89 +198,245 @@ namespace { // Implementation details
     }
 
 
-    SampleVec readSoundData(SndfileHandle& src)
+    /** fill the buffer with the next block of interleaved samples
+     * @return number of frames actually read, zero at end of file */
+    Frames readBlock(SndfileHandle& src, SampleVec& buffer)
     {
         assert(src.channels() == CHANNELS);
-        size_t sampleCnt = src.frames() * CHANNELS;
-        SampleVec buffer(sampleCnt);
-        size_t actuallyRead = src.read(buffer.data(), sampleCnt);
-        if (actuallyRead != sampleCnt)
-            throw error::State("Could not read the expected "+formatVal(sampleCnt)
-                              +" samples from the soundfile; got only "+formatVal(actuallyRead));
+        buffer.resize(size_t(BLOCK_FRAMES) * CHANNELS);
+        Frames frames = max(Frames{0}, src.readf(buffer.data(), BLOCK_FRAMES));
+        buffer.resize(size_t(frames) * CHANNELS);
+        return frames;
+    }
+
+    void verifyComplete(SndfileHandle const& src, Frames actuallyRead)
+    {
+        if (actuallyRead != src.frames())
+            throw error::State("Could not read the expected "+formatVal(src.frames())
+                              +" frames from the soundfile; got only "+formatVal(actuallyRead));
+    }
+
+    /** @return the interleaved samples of frames [start, end[ */
+    SampleVec readFrames(SndfileHandle& src, Frames start, Frames end)
+    {
+        SampleVec buffer(size_t(max(Frames{0}, end-start)) * CHANNELS);
+        if (start < end
+            and (src.seek(start, SEEK_SET) != start
+                 or src.readf(buffer.data(), end-start) != end-start))
+            throw error::State("Could not read frames "+formatVal(start)+".."+formatVal(end)
+                              +" from the soundfile");
         return buffer;
     }
 
 
-    void writeSoundData(SampleVec const& samples, SndfileHandle dest)
+    void writeBlock(SampleVec const& samples, SndfileHandle& dest)
     {
         assert(dest.channels() == CHANNELS);
-        size_t actuallyWritten = dest.write(samples.data(), samples.size());
-        if (actuallyWritten != samples.size())
+        Frames actuallyWritten = dest.write(samples.data(), Frames(samples.size()));
+        if (actuallyWritten != Frames(samples.size()))
             throw error::State("Could not write all "+formatVal(samples.size())
                               +" samples, only "+formatVal(actuallyWritten));
     }
 
 
-    SampleVec buildDiff(SampleVec const& probe, SndfileHandle& baseline)
+    /**
+     * Walk the probe and the baseline in parallel, passing each block of the residual
+     * (probe - baseline) to the consumer. The residual has the length of the baseline,
+     * padded with zeros where the probe ends early.
+     */
+    template<class FUN>
+    void streamDiff(SndfileHandle probe, SndfileHandle baseline, FUN consume)
     {
-        SampleVec buffer(move(readSoundData(baseline)));
-        size_t diffSiz = min(probe.size(), buffer.size());
-        for (size_t i=0; i < diffSiz; ++i)
-            buffer[i] = probe[i] - buffer[i];
-        for (size_t i=diffSiz; i < buffer.size(); ++i)
-            buffer[i] = 0.0f;
-        return buffer;
+        SampleVec buffer, probeBlock;
+        Frames total{0};
+        while (Frames frames = readBlock(baseline, buffer))
+        {
+            readBlock(probe, probeBlock);
+            size_t diffSiz = min(probeBlock.size(), buffer.size());
+            for (size_t i=0; i < diffSiz; ++i)
+                buffer[i] = probeBlock[i] - buffer[i];
+            for (size_t i=diffSiz; i < buffer.size(); ++i)
+                buffer[i] = 0.0f;
+            consume(buffer);
+            total += frames;
+        }
+        verifyComplete(baseline, total);
     }
 
 
-    SoundStat calculateStats(SampleVec const& samples, uint smpPerSec)
+    /** aggregate statistics over a sequence of sample blocks */
+    class StatAccumulator
+    {
+        size_t window_;
+        std::vector<double> squares_;  ///< ring buffer of squared samples within the RMS window
+        size_t pos_{0};
+        uint64_t count_{0};
+        double movingAvg_{0.0};
+        SoundStat res_;
+
+    public:
+        StatAccumulator(uint smpPerSec)
+            : window_{max<size_t>(1, RMS_WINDOW_sec * smpPerSec * CHANNELS)}
+            , squares_(window_, 0.0)
+            , res_{smpPerSec, 0, 0.0, 0.0, 0.0}
+        { }
+
+        void feed(SampleVec const& samples)
+        {
+            for (float curr : samples)
+            {
+                double sqr = double(curr)*curr;
+                res_.rmsAll   += sqr;
+                movingAvg_    += sqr - squares_[pos_];
+                squares_[pos_] = sqr;
+                pos_ = (pos_+1 == window_)? 0 : pos_+1;
+                res_.rmsMax = max(res_.rmsMax, movingAvg_);
+                res_.peak   = max(res_.peak, fabs(curr));
+            }
+            count_ += samples.size();
+        }
+
+        SoundStat conclude()
+        {
+            res_.frames  = count_ / CHANNELS;
+            res_.rmsAll /= count_;
+            res_.rmsMax /= min<uint64_t>(window_, count_);
+            return res_;
+        }
+    };
+
+
+    SoundStat calculateStats(SndfileHandle src)
     {
-        size_t window = RMS_WINDOW_sec * smpPerSec * CHANNELS;
+        StatAccumulator stats{uint(src.samplerate())};
+        SampleVec buffer;
+        Frames total{0};
+        while (Frames frames = readBlock(src, buffer))
+        {
+            stats.feed(buffer);
+            total += frames;
+        }
+        verifyComplete(src, total);
+        return stats.conclude();
+    }
+
+    SoundStat calculateDiffStats(SndfileHandle probe, SndfileHandle baseline)
+    {
+        StatAccumulator stats{uint(baseline.samplerate())};
+        streamDiff(probe, baseline, [&](SampleVec const& residual){ stats.feed(residual); });
+        return stats.conclude();
+    }
 
-        auto sqr  = [](double val){ return val*val; };
-        auto curr = [&](size_t i) { return samples[i]; };
-        auto drop = [&](size_t i) { return i < window? 0.0 : samples[i-window]; };
 
-        double movingAvg{0.0};
-        SoundStat res{0, 0, 0.0, 0.0, 0.0};
-        for (size_t i=0; i < samples.size(); ++i)
+    /** in-place iterative radix-2 FFT; the size must be a power of two */
+    void fft(std::vector<std::complex<double>>& data)
+    {
+        size_t n = data.size();
+        for (size_t i=1, j=0; i < n; ++i)
+        {// bit reversal permutation
+            size_t bit = n >> 1;
+            for ( ; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+        for (size_t len=2; len <= n; len <<= 1)
         {
-            res.rmsAll += sqr(curr(i));
-            movingAvg  += sqr(curr(i)) - sqr(drop(i));
-            res.rmsMax  = max(res.rmsMax, movingAvg);
-            res.peak    = max(res.peak, fabs(curr(i)));
+            std::complex<double> step = std::polar(1.0, -2*M_PI / len);
+            for (size_t i=0; i < n; i += len)
+            {
+                std::complex<double> w{1.0};
+                for (size_t k=0; k < len/2; ++k, w *= step)
+                {
+                    auto u = data[i+k];
+                    auto v = data[i+k+len/2] * w;
+                    data[i+k]       = u + v;
+                    data[i+k+len/2] = u - v;
+                }
+            }
         }
-        res.rate    = smpPerSec;
-        res.frames  = samples.size() / CHANNELS;
-        res.rmsAll /= samples.size();
-        res.rmsMax /= min(window, samples.size());
-        return res;
+    }
+
+    /** convert power values into dB relative to the maximum, limited by the floor */
+    std::vector<double> relativeLevels(std::vector<double> const& power)
+    {
+        double ref = *std::max_element(power.begin(), power.end());
+        std::vector<double> levels;
+        levels.reserve(power.size());
+        for (double p : power)
+            levels.push_back(0.0 < p and 0.0 < ref? max(FINGERPRINT_FLOOR, 10*log10(p/ref))
+                                                  : FINGERPRINT_FLOOR);
+        return levels;
+    }
+
+    double rmsDifference(std::vector<double> const& v1, std::vector<double> const& v2)
+    {
+        assert(v1.size() == v2.size());
+        double sum = 0.0;
+        for (size_t i=0; i < v1.size(); ++i)
+            sum += (v1[i]-v2[i]) * (v1[i]-v2[i]);
+        return v1.empty()? 0.0 : sqrt(sum / v1.size());
     }
 }//(End)Implementation namespace
 
 
 
+/**
+ * Pick the container for writing a sound file of the given length:
+ * Sony Wave64 when requested by the extension `.w64`, RF64 when requested
+ * by `.rf64` or when the data would exceed the size limit of a plain WAV.
+ */
+SoundContainer chooseContainer(fs::path const& target, uint64_t frames)
+{
+    if (".w64" == target.extension())
+        return SoundContainer::W64;
+    if (".rf64" == target.extension()
+        or frames * CHANNELS * sizeof(float) > WAV_DATA_LIMIT)
+        return SoundContainer::RF64;
+    return SoundContainer::WAV;
+}
+
+string containerName(SoundContainer container)
+{
+    switch (container)
+    {
+        case SoundContainer::RF64: return "RF64";
+        case SoundContainer::W64:  return "W64";
+        default:                   return "WAV";
+    }
+}
+
+
+
 
 /**
- * @internal PImpl to hold sound data buffer and statistics
+ * @internal PImpl to hold the location and statistics of sound data.
+ * The samples themselves are read again from #file when required.
  */
 struct SoundData
     : util::NonCopyable
 {
-    SampleVec buffer;
+    fs::path  file;
     SoundStat stat;
 
-    /** sound data from file */
-    SoundData(SndfileHandle src)
-        : buffer{move(readSoundData(src))}
-        , stat{calculateStats(buffer, src.samplerate())}
+    /** sound data from a RAW file */
+    SoundData(fs::path rawSound, uint sampleRate)
+        : file{fs::absolute(rawSound)}
+        , stat{calculateStats(openSndfileRead(file, sampleRate))}
     { }
 
-    /** build sound data as diff between #probe and #baseline */
-    SoundData(SoundData const& probe, SndfileHandle baseline)
-        : buffer{move(buildDiff(probe.buffer, baseline))}
-        , stat{calculateStats(buffer, baseline.samplerate())}
+    /** residual sound data as diff between #probe and #baseline */
+    SoundData(SoundData const& probe, fs::path baseline)
+        : file{fs::absolute(baseline)}
+        , stat{calculateDiffStats(probe.open(), openSndfileRead(file))}
     { }
+
+    SndfileHandle open()  const
+    {
+        return hasExtRAW(file)? openSndfileRead(file, stat.rate)
+                              : openSndfileRead(file);
+    }
 };
 using PSoundData = std::unique_ptr<SoundData>;
 
@@ -258,18 +456,17 @@ void SoundProbe::discardStorage()
 
 void SoundProbe::loadProbe(fs::path rawSound, int sampleRate)
 {
-    probe_.reset(new SoundData{openSndfileRead(rawSound, sampleRate)});
+    probe_.reset(new SoundData{rawSound, uint(sampleRate)});
     if (residual_) residual_.reset();
 }
 
 
-/** load the baseline file and then calculate the residual sound. */
+/** gauge the probe against the baseline file, calculating the residual sound. */
 void SoundProbe::buildDiff(fs::path baseline)
 {
     if (not probe_)
         throw error::LogicBroken("Need to load a sound probe first.");
-    SndfileHandle baselineFile = openSndfileRead(baseline);
-    residual_.reset(new SoundData{*probe_, baselineFile});
+    residual_.reset(new SoundData{*probe_, baseline});
 }
 
 
@@ -301,7 +498,7 @@ OptString SoundProbe::checkDiffSane()  const
         return OptString{"Baseline exceeds probe by "
                         +formatVal(residual_->stat.frames - probe_->stat.frames)
                         +" samples ("
-                        +formatVal(1000.0*(residual_->stat.frames - probe_->stat.frames)*1000 / probe_->stat.rate)
+                        +formatVal(1000.0*(residual_->stat.frames - probe_->stat.frames) / probe_->stat.rate)
                         +"msec)"};
     return std::nullopt;
 }
@@ -336,22 +533,173 @@ double SoundProbe::getDuration()  const  ///< @return seconds
     return double(probe_->stat.frames) / probe_->stat.rate;
 }
 
+uint64_t SoundProbe::getFrames()  const
+{
+    if (not probe_)
+        throw error::LogicBroken("No sound probe loaded yet.");
+    return probe_->stat.frames;
+}
+
 
-/** write the probe sound data into a WAV file */
-void SoundProbe::saveProbe(fs::path name)
+/**
+ * Detect the onset of each note in the probe, based on the amplitude envelope.
+ * For each scheduled note-on, the threshold is set relative to the peak within the
+ * search window, but also above the level still sounding from a preceding note.
+ * @param noteOnFrames frame positions where a note-on was scheduled
+ * @param searchFrames length of the window after note-on to search for the onset
+ * @return for each note, the offset in frames from note-on to the first frame
+ *         exceeding the threshold, or `nullopt` if the note remained silent
+ */
+SoundProbe::Onsets SoundProbe::detectOnsets(std::vector<size_t> const& noteOnFrames, size_t searchFrames)  const
+{
+    if (not probe_)
+        throw error::LogicBroken("No sound probe loaded yet.");
+    SndfileHandle src = probe_->open();
+    Frames frames = Frames(probe_->stat.frames);
+    Frames start{0};
+    SampleVec samples;
+    auto level = [&](Frames frame)
+                    {
+                        size_t i = size_t(frame - start) * CHANNELS;
+                        if (frame < start or samples.size() <= i)
+                            return 0.0f;
+                        float l = fabs(samples[i]);
+                        float r = fabs(samples[i + 1]);
+                        return max(l,r);
+                    };
+    Onsets onsets;
+    for (size_t noteOn : noteOnFrames)
+    {   // load only the tail before and the search window after this note-on
+        Frames end = min(frames, Frames(noteOn + searchFrames));
+        start = min(frames, Frames(noteOn - min(noteOn, TAIL_FRAMES)));
+        samples = readFrames(src, start, end);
+
+        float tail = 0.0f, peak = 0.0f;
+        for (Frames f = start; f < Frames(noteOn); ++f)
+            tail = max(tail, level(f));
+        for (Frames f = noteOn; f < end; ++f)
+            peak = max(peak, level(f));
+        double threshold = max(ONSET_LEVEL * peak, ONSET_ABOVE_TAIL * tail);
+        std::optional<size_t> onset;
+        if (0.0f < peak)
+            for (Frames f = noteOn; f < end; ++f)
+                if (threshold < level(f))
+                {
+                    onset = size_t(f - Frames(noteOn));
+                    break;
+                }
+        onsets.push_back(onset);
+    }
+    return onsets;
+}
+
+
+/**
+ * Characterise the sound in the given file by its spectral envelope and RMS profile.
+ * @remark the file is streamed block-wise; the mono sum is used for the spectrum.
+ */
+SoundFingerprint takeFingerprint(fs::path soundFile)
+{
+    SndfileHandle src = openSndfileRead(soundFile);
+    double rate = src.samplerate();
+    uint64_t frames = uint64_t(src.frames());
+    uint64_t segmentLen = max<uint64_t>(1, (frames + FINGERPRINT_SEGMENTS-1) / FINGERPRINT_SEGMENTS);
+
+    std::vector<double> window(FFT_SIZE);
+    for (size_t i=0; i < FFT_SIZE; ++i)
+        window[i] = 0.5 - 0.5 * cos(2*M_PI * i / (FFT_SIZE-1));   // Hann window
+
+    std::vector<double> spectrum(FFT_SIZE/2, 0.0);
+    std::vector<double> segments(FINGERPRINT_SEGMENTS, 0.0);
+    std::vector<std::complex<double>> frame(FFT_SIZE);
+    size_t pos = 0;
+    uint64_t frameNr = 0;
+    auto analyse = [&]{
+                        for ( ; pos < FFT_SIZE; ++pos)
+                            frame[pos] = 0.0;
+                        fft(frame);
+                        for (size_t k=0; k < FFT_SIZE/2; ++k)
+                            spectrum[k] += std::norm(frame[k]);
+                        pos = 0;
+                      };
+    SampleVec buffer;
+    Frames total{0};
+    while (Frames cnt = readBlock(src, buffer))
+    {
+        for (size_t i=0; i < buffer.size(); i += CHANNELS, ++frameNr)
+        {
+            double mono = 0.5 * (double(buffer[i]) + buffer[i+1]);
+            segments[frameNr / segmentLen] += double(buffer[i])*buffer[i] + double(buffer[i+1])*buffer[i+1];
+            frame[pos] = mono * window[pos];
+            if (++pos == FFT_SIZE)
+                analyse();
+        }
+        total += cnt;
+    }
+    verifyComplete(src, total);
+    if (0 < pos)
+        analyse();
+
+    std::vector<double> bands(FINGERPRINT_BANDS, 0.0);
+    double freqMax = min(FINGERPRINT_FREQ_MAX, rate/2);
+    double ratio = pow(freqMax / FINGERPRINT_FREQ_MIN, 1.0 / FINGERPRINT_BANDS);
+    for (size_t b=0; b < FINGERPRINT_BANDS; ++b)
+    {// average the bins within the band, yet use at least the bin closest to its centre
+        double lo = FINGERPRINT_FREQ_MIN * pow(ratio, b);
+        size_t binLo = size_t(ceil(lo * FFT_SIZE / rate));
+        size_t binHi = size_t(lo * ratio * FFT_SIZE / rate);
+        if (binHi < binLo)
+            binLo = binHi = size_t(round(lo * sqrt(ratio) * FFT_SIZE / rate));
+        binHi = min(binHi, FFT_SIZE/2 - 1);
+        binLo = min(binLo, binHi);
+        for (size_t k=binLo; k <= binHi; ++k)
+            bands[b] += spectrum[k];
+        bands[b] /= binHi - binLo + 1;
+    }
+    return SoundFingerprint{relativeLevels(bands)
+                           ,relativeLevels(segments)
+                           ,frames / rate};
+}
+
+
+/** @return RMS difference in dB of spectral envelope or RMS profile, whichever is larger;
+ *          infinite when the durations differ notably */
+double SoundFingerprint::distance(SoundFingerprint const& other)  const
+{
+    if (FINGERPRINT_DURATION_TOLERANCE * max(duration, other.duration) < fabs(duration - other.duration))
+        return std::numeric_limits<double>::infinity();
+    return max(rmsDifference(envelope, other.envelope)
+              ,rmsDifference(profile,  other.profile));
+}
+
+
+
+/** write the probe sound data into a WAV file (or RF64 / W64)
+ * @return the container actually used, depending on size and extension */
+SoundContainer SoundProbe::saveProbe(fs::path name)
 {
     if (not probe_)
         throw error::LogicBroken("Nothing to write, no sound data loaded yet.");
-    writeSoundData(probe_->buffer, openSndfileWrite(name, probe_->stat.rate));
+    SoundContainer container = chooseContainer(name, probe_->stat.frames);
+    SndfileHandle src = probe_->open();
+    SndfileHandle dest = openSndfileWrite(name, probe_->stat.rate, container);
+    SampleVec buffer;
+    while (readBlock(src, buffer))
+        writeBlock(buffer, dest);
+    return container;
 }
 
 
-/** write the calculated residual sound data into a WAV file */
-void SoundProbe::saveResidual(fs::path name)
+/** write the calculated residual sound data into a WAV file (or RF64 / W64)
+ * @remark the residual is computed again block-wise from probe and baseline */
+SoundContainer SoundProbe::saveResidual(fs::path name)
 {
     if (not hasDiff())
         throw error::LogicBroken("Need to compute a diff first.");
-    writeSoundData(residual_->buffer, openSndfileWrite(name, residual_->stat.rate));
+    SoundContainer container = chooseContainer(name, residual_->stat.frames);
+    SndfileHandle dest = openSndfileWrite(name, residual_->stat.rate, container);
+    streamDiff(probe_->open(), residual_->open(), [&](SampleVec const& residual){ writeBlock(residual, dest); });
+    return container;
 }
 
 
@@ -29,10 +29,18 @@
  ** listen to this residual, which thus needs to be written out as WAV file;
  ** obviously we'll also need to write the baseline as WAV file at some point.
  **
+ ** \par Long renders
+ ** A plain WAV file is limited to 4GiB by its 32bit RIFF size fields, which for
+ ** stereo float samples amounts to about 3.1 hours at 48kHz. Larger files are
+ ** written as RF64 automatically (still with the `.wav` extension, as permitted
+ ** by EBU Tech 3306), and Sony Wave64 is used when the target has the extension
+ ** `.w64`. Reading detects the container from the file header.
+ **
  ** \par Implementation note:
- ** Since typically these sound files are short, the Yoshimi-testrunner reads
- ** all sample data into a memory buffer in one chunk, for speed and simplicity
- ** of implementation.
+ ** Sample data is never held in memory as a whole; rather the sound files are
+ ** processed in blocks, retaining only the aggregated statistics, and are read
+ ** again when saving a copy or the residual. Thus the RAW probe written by Yoshimi
+ ** and the baseline file must remain in place until the test case is complete.
  ** 
  ** @todo WIP as of 8/21
  ** @see suite::step::SoundObservation
@@ -49,8 +57,10 @@
 #include "util/nocopy.hpp"
 
 #include <optional>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace util {
 
@@ -60,6 +70,12 @@ using OptString = std::optional<string>;
 struct SoundData;
 using PSoundData = std::unique_ptr<SoundData>;
 
+/** container format used for persistent sound files */
+enum class SoundContainer { WAV, RF64, W64 };
+
+SoundContainer chooseContainer(fs::path const& target, uint64_t frames);
+string containerName(SoundContainer);
+
 
 /**
  * Encapsulated sound probe data from a test run.
@@ -84,17 +100,38 @@ public:
     void loadProbe(fs::path rawSound, int sampleRate);
     void buildDiff(fs::path baseline);
 
-    void saveProbe(fs::path name);
-    void saveResidual(fs::path name);
+    SoundContainer saveProbe(fs::path name);
+    SoundContainer saveResidual(fs::path name);
     OptString checkDiffSane() const;
     double getDiffRMSPeak()   const;
     double getProbePeak()     const;
     double getDuration()      const;
+    uint64_t getFrames()      const;
+
+    using Onsets = std::vector<std::optional<size_t>>;
+    Onsets detectOnsets(std::vector<size_t> const& noteOnFrames, size_t searchFrames)  const;
 //  string describeProbe()    const;  /////////////TODO
 //  string describeResidual() const;  /////////////TODO
 };
 
 
+/**
+ * Compact characterisation of a sound, to spot test cases with near-identical output.
+ * Levels are given in dB relative to the loudest band or segment, and thus
+ * the fingerprint does not depend on the overall volume.
+ */
+struct SoundFingerprint
+{
+    std::vector<double> envelope;  ///< spectral envelope: level in logarithmically spaced bands
+    std::vector<double> profile;   ///< RMS level of consecutive segments over the duration
+    double duration{0.0};          ///< seconds
+
+    double distance(SoundFingerprint const&)  const;
+};
+
+SoundFingerprint takeFingerprint(fs::path soundFile);
+
+
 inline bool hasExtRAW(fs::path const& file)
 {
     return ".raw" == file.extension()
@@ -106,6 +143,14 @@ inline bool hasExtWAV(fs::path const& file)
     return ".wav" == file.extension();
 }
 
+/** @return `true` for any of the containers accepted for baseline and residual */
+inline bool hasExtSound(fs::path const& file)
+{
+    return hasExtWAV(file)
+        or ".rf64" == file.extension()
+        or ".w64"  == file.extension();
+}
+
 
 }//(End)namespace util
 #endif /*TESTRUNNER_UTIL_SOUND_HPP_*/
@@ -114,6 +114,27 @@ inline double errorSum(NUMS ...vals)
     return sqrt((sqr(vals)+ ... + 0.0));
 }
 
+/**
+ * Two-sided quantile of the normal distribution.
+ * @return factor `z` such that a deviation beyond `z·σ` has probability `alpha`
+ * @remark solved by bisection on `erfc`, which is monotonous; precision ~1e-9
+ */
+inline double normalQuantile(double alpha)
+{
+    if (not (0.0 < alpha and alpha < 1.0))
+        throw error::Invalid("Probability "+formatVal(alpha)+" outside (0,1)");
+    double lo = 0.0, hi = 40.0;
+    while (hi - lo > 1e-9)
+    {
+        double z = (lo + hi) / 2;
+        if (std::erfc(z / M_SQRT2) > alpha)
+            lo = z;
+        else
+            hi = z;
+    }
+    return (lo + hi) / 2;
+}
+
 
 
 template<typename D>
@@ -126,6 +147,9 @@ inline double average(DataSpan<D> const& data)
     return sum / data.size();
 }
 
+inline double average(VecD const& data)
+{   return average(DataSpan<double>{data}); }
+
 template<typename D>
 inline double sdev(DataSpan<D> const& data, D mean)
 {
@@ -0,0 +1,215 @@
+/*
+ *  sysload - sample indicators of system load and platform disturbance
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file sysload.cpp
+ ** Implementation of system state sampling, based on Linux pseudo files.
+ **
+ ** \par Contamination score
+ ** The score is a heuristic sum of penalties; each contribution is scaled such
+ ** as to reach ~1 for a situation where timing measurements are clearly worthless.
+ ** - CPU stall: 1.0 at 50% PSI; memory and I/O stall: 1.0 at 25% PSI
+ ** - CPU load: 1.0 when all CPUs are busy, beyond those used by the test
+ ** - thermal throttling: 1.0 for any throttling event since the start of observation
+ ** - thermal: penalty starts at 80°C and reaches 1.0 at 100°C
+ ** @remark the testrunner and the subject itself account for up to two runnable tasks.
+ **
+ */
+
+
+#include "util/sysload.hpp"
+#include "util/error.hpp"
+#include "util/format.hpp"
+#include "util/file.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <tuple>
+
+using std::max;
+using std::string;
+
+
+namespace util {
+
+namespace {// Implementation helpers
+
+    const fs::path PROC_STAT{"/proc/stat"};
+    const fs::path PROC_PRESSURE{"/proc/pressure"};
+    const fs::path SYS_CPU{"/sys/devices/system/cpu"};
+    const fs::path SYS_THERMAL{"/sys/class/thermal"};
+
+    const double TEMP_CRITICAL = 80.0; // °C
+
+
+    /** read first whitespace delimited token from a pseudo file */
+    template<typename NUM>
+    NUM readValue(fs::path file, NUM fallback)
+    {
+        std::ifstream in{file};
+        NUM val;
+        if (in >> val)
+            return val;
+        return fallback;
+    }
+
+    /** extract the accumulated `total` stall time (µs) of the »some« line in a PSI file */
+    double readPressure(string resource)
+    {
+        std::ifstream in{PROC_PRESSURE / resource};
+        for (string token; in >> token; )
+            if (startsWith(token, "total="))
+                return std::stod(token.substr(6));
+        return 0.0;
+    }
+
+    /** @return accumulated (busy, total) CPU time in ticks, from the summary line in `/proc/stat` */
+    std::pair<double,double> readCpuTime()
+    {
+        std::ifstream in{PROC_STAT};
+        string label;
+        double busy = 0.0, total = 0.0;
+        if (in >> label and label == "cpu")
+            for (uint field=0; field < 8; ++field)     // user nice system idle iowait irq softirq steal
+            {
+                double ticks;
+                if (not (in >> ticks)) break;
+                total += ticks;
+                if (field != 3 and field != 4)
+                    busy += ticks;
+            }
+        return {busy, total};
+    }
+
+    double now_us()
+    {
+        using namespace std::chrono;
+        return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** the fastest core is the one executing the test */
+    double readFrequencyRatio()
+    {
+        double ratio = 0.0;
+        std::error_code noThrow;
+        for (auto& entry : fs::directory_iterator(SYS_CPU, noThrow))
+        {
+            fs::path freqDir = entry.path() / "cpufreq";
+            if (not fs::exists(freqDir / "scaling_cur_freq", noThrow))
+                continue;
+            double curr = readValue(freqDir / "scaling_cur_freq", 0.0);
+            double maxi = readValue(freqDir / "cpuinfo_max_freq", 0.0);
+            if (0.0 < maxi)
+                ratio = max(ratio, curr / maxi);
+        }
+        return 0.0 < ratio? ratio : 1.0;
+    }
+
+    /** @remark exposed by the x86 `therm_throt` driver; the package counter is
+     *          replicated for each core, which is irrelevant for detecting changes */
+    size_t readThrottleCount()
+    {
+        size_t cnt = 0;
+        std::error_code noThrow;
+        for (auto& entry : fs::directory_iterator(SYS_CPU, noThrow))
+        {
+            fs::path throttleDir = entry.path() / "thermal_throttle";
+            cnt += readValue(throttleDir / "core_throttle_count", size_t(0));
+            cnt += readValue(throttleDir / "package_throttle_count", size_t(0));
+        }
+        return cnt;
+    }
+
+    double readMaxTemperature()
+    {
+        double tempMax = 0.0;
+        std::error_code noThrow;
+        for (auto& entry : fs::directory_iterator(SYS_THERMAL, noThrow))
+            if (startsWith(entry.path().filename(), "thermal_zone"))
+                tempMax = max(tempMax, readValue(entry.path() / "temp", 0.0) / 1000);
+        return tempMax;
+    }
+}//(End)helpers
+
+
+
+SysLoad sampleSystemLoad()
+{
+    SysLoad load;
+    load.sampled_us  = now_us();
+    load.cpuCnt      = max(1u, std::thread::hardware_concurrency());
+    std::tie(load.cpuBusy_ticks, load.cpuTotal_ticks) = readCpuTime();
+    load.stallCpu_us = readPressure("cpu");
+    load.stallMem_us = readPressure("memory");
+    load.stallIo_us  = readPressure("io");
+    load.freqRatio   = readFrequencyRatio();
+    load.tempMax     = readMaxTemperature();
+    load.throttled   = readThrottleCount();
+    return load;
+}
+
+
+/** @remark the first sample of an observation yields an empty window and is thus neutral */
+SysLoad SysLoad::since(SysLoad const& start)  const
+{
+    SysLoad load{*this};
+    double window = sampled_us - start.sampled_us;
+    auto stallPercent = [window](double total, double atStart)
+                            {
+                                return 0.0 < window? 100 * max(0.0, total - atStart) / window : 0.0;
+                            };
+    load.psiCpu = stallPercent(stallCpu_us, start.stallCpu_us);
+    load.psiMem = stallPercent(stallMem_us, start.stallMem_us);
+    load.psiIo  = stallPercent(stallIo_us,  start.stallIo_us);
+
+    double ticks = cpuTotal_ticks - start.cpuTotal_ticks;
+    load.busyCpus = 0.0 < ticks? cpuCnt * max(0.0, cpuBusy_ticks - start.cpuBusy_ticks) / ticks : 0.0;
+
+    load.throttled -= std::min(throttled, start.throttled);
+    return load;
+}
+
+
+double SysLoad::contamination()  const
+{
+    double score = psiCpu / 50
+                 + psiMem / 25
+                 + psiIo  / 25;
+    score += max(0.0, busyCpus - 2) / cpuCnt;
+    score += 0 < throttled? 1.0 : 0.0;
+    score += max(0.0, (tempMax - TEMP_CRITICAL) / 20);
+    return score;
+}
+
+
+string SysLoad::describe()  const
+{
+    return "busy="+formatVal(busyCpus)+"/"+formatVal(cpuCnt)
+         +" psi(cpu,mem,io)=("+formatVal(psiCpu)+","+formatVal(psiMem)+","+formatVal(psiIo)+")%"
+         +" clock="+formatVal(100*freqRatio)+"%"
+         +" temp="+formatVal(tempMax)+"°C"
+         +" throttled="+formatVal(throttled);
+}
+
+
+}//(End)namespace util
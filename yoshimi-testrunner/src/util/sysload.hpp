@@ -0,0 +1,99 @@
+/*
+ *  sysload - sample indicators of system load and platform disturbance
+ *
+ *  Copyright 2021, Hermann Vosseler <Ichthyostega@web.de>
+ *
+ *  This file is part of the Yoshimi-Testsuite, which is free software:
+ *  you can redistribute and/or modify it under the terms of the GNU
+ *  General Public License as published by the Free Software Foundation,
+ *  either version 3 of the License, or (at your option) any later version.
+ *
+ *  Yoshimi-Testsuite is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+ ***************************************************************/
+
+
+/** @file sysload.hpp
+ ** Retrieve indicators of the current system state from the Linux kernel.
+ ** Timing measurements are only meaningful when the platform is not disturbed by
+ ** other activities: background load, memory or I/O pressure, CPU frequency scaling
+ ** and thermal throttling all tend to inflate run times, without any relation to
+ ** the subject under test. The kernel publishes relevant indicators in the `/proc`
+ ** and `/sys` pseudo file systems:
+ ** - `/proc/stat` : CPU time spent busy vs. idle, accumulated over all CPUs
+ ** - `/proc/pressure/{cpu,memory,io}` : PSI »some« stall time, accumulated in µs
+ ** - `/sys/devices/system/cpu/cpu<N>/cpufreq` : current vs. maximum clock frequency
+ ** - `/sys/devices/system/cpu/cpu<N>/thermal_throttle` : count of throttling events
+ ** - `/sys/class/thermal/thermal_zone<N>/temp` : temperature in milli-°C
+ ** Each indicator is optional; when not available on the actual system, it is
+ ** treated as neutral. The kernel's averages (load average, PSI `avg10`) lag behind by
+ ** several seconds; thus the accumulated counters are read instead and related to a
+ ** sample taken at start of the observation (SysLoad::since), so that only load during
+ ** the observed time window is considered. From these values, a heuristic _contamination
+ ** score_ can be derived: zero indicates a quiet system, while values around 1
+ ** signal severe disturbance. The clock frequency is reported, but not scored,
+ ** since power saving governors lower the clock of an idle core as a matter of
+ ** routine; only actual throttling events while the test runs are a disturbance.
+ **
+ ** @see suite::step::SystemWatch
+ **
+ */
+
+
+
+#ifndef TESTRUNNER_UTIL_SYSLOAD_HPP_
+#define TESTRUNNER_UTIL_SYSLOAD_HPP_
+
+
+#include "util/utils.hpp"
+
+#include <string>
+
+namespace util {
+
+using std::string;
+
+
+/**
+ * snapshot of system state indicators; missing indicators are neutral.
+ * @note the load and stall figures are only meaningful after relating
+ *       the sample to the start of the observation by #since
+ */
+struct SysLoad
+{
+    double busyCpus{0.0};    ///< average number of busy CPUs during observation
+    uint   cpuCnt{1};        ///< online CPUs
+    double psiCpu{0.0};      ///< percentage of time some task stalled on CPU during observation
+    double psiMem{0.0};      ///< percentage of time some task stalled on memory during observation
+    double psiIo{0.0};       ///< percentage of time some task stalled on I/O during observation
+    double freqRatio{1.0};   ///< highest current clock frequency relative to maximum
+    double tempMax{0.0};     ///< hottest thermal zone in °C
+    size_t throttled{0};     ///< thermal throttling events, summed over all CPUs (cumulative)
+
+    /* == cumulative counters == */
+    double sampled_us{0.0};  ///< monotonic time of sampling
+    double cpuBusy_ticks{0.0};
+    double cpuTotal_ticks{0.0};
+    double stallCpu_us{0.0};
+    double stallMem_us{0.0};
+    double stallIo_us{0.0};
+
+    double contamination()  const;
+    string describe()       const;
+
+    /** relate cumulative counters to the sample taken at start of the observation */
+    SysLoad since(SysLoad const& start)  const;
+};
+
+
+/** retrieve current values of all available indicators */
+SysLoad sampleSystemLoad();
+
+
+}//(End)namespace util
+#endif /*TESTRUNNER_UTIL_SYSLOAD_HPP_*/
@@ -69,6 +69,14 @@ class TeeStream
             return c;
         }
 
+        virtual int sync()  override
+        {
+            int res = 0;
+            for (auto buff : receivers_)
+                res |= buff->pubsync();
+            return res;
+        }
+
     public:
         void attach(streambuf* buf)
         {